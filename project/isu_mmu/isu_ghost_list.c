@@ -0,0 +1,118 @@
+/**
+ * @file	isu_ghost_list.c
+ * @brief	source file of isu_ghost_list.h
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "isu_ghost_list.h"
+#include "isu_page_index.h"
+#include "isu_slot_list.h"
+#include "common/isu_error.h"
+
+struct ISU_GHOST_LIST_STRUCT{
+	/// the page held by each entry
+	int *pages;
+
+	/// the used entries, newest at the head
+	isu_slot_list_t order;
+
+	/// maps a page to its entry
+	isu_page_index_t index;
+
+	/// the entries not in use
+	int *free_entries;
+
+	/// the number of entries in `free_entries`
+	unsigned int n_free;
+
+	/// the most pages the list will hold
+	unsigned int capacity;
+};
+
+isu_ghost_list_t isu_ghost_list_create(unsigned int capacity){
+	unsigned int i;
+	isu_ghost_list_t g = calloc(1, sizeof(struct ISU_GHOST_LIST_STRUCT));
+	if(g == NULL){
+		isu_print(PRINT_ERROR, "calloc returned NULL");
+		return NULL;
+	}
+	if(capacity == 0){
+		capacity = 1;
+	}
+	g->capacity = capacity;
+	g->pages = malloc(capacity * sizeof(int));
+	g->free_entries = malloc(capacity * sizeof(int));
+	g->order = isu_slot_list_create(capacity);
+	g->index = isu_page_index_create(capacity);
+	if(g->pages == NULL || g->free_entries == NULL || g->order == NULL || g->index == NULL){
+		isu_print(PRINT_ERROR, "malloc returned NULL");
+		isu_ghost_list_destroy(g);
+		return NULL;
+	}
+	for(i = 0; i < capacity; i++){
+		g->free_entries[i] = capacity - 1 - i;
+	}
+	g->n_free = capacity;
+	return g;
+}
+
+void isu_ghost_list_destroy(isu_ghost_list_t g){
+	if(g->order){
+		isu_slot_list_destroy(g->order);
+	}
+	if(g->index){
+		isu_page_index_destroy(g->index);
+	}
+	free(g->pages);
+	free(g->free_entries);
+	free(g);
+}
+
+int isu_ghost_list_contains(isu_ghost_list_t g, int page){
+	return isu_page_index_find(g->index, page) >= 0;
+}
+
+/// frees entry `e` of the list
+static void isu_ghost_list_release(isu_ghost_list_t g, int e){
+	isu_slot_list_remove(g->order, e);
+	isu_page_index_remove(g->index, g->pages[e]);
+	g->free_entries[g->n_free++] = e;
+}
+
+int isu_ghost_list_remove(isu_ghost_list_t g, int page){
+	long long e = isu_page_index_find(g->index, page);
+	if(e < 0){
+		return 0;
+	}
+	isu_ghost_list_release(g, (int)e);
+	return 1;
+}
+
+int isu_ghost_list_push_head(isu_ghost_list_t g, int page){
+	int e;
+	int dropped = -1;
+	if(g->n_free == 0){
+		dropped = isu_ghost_list_pop_tail(g);
+	}
+	e = g->free_entries[--g->n_free];
+	g->pages[e] = page;
+	isu_page_index_insert(g->index, page, e);
+	isu_slot_list_push_head(g->order, e);
+	return dropped;
+}
+
+int isu_ghost_list_pop_tail(isu_ghost_list_t g){
+	int page;
+	int e = isu_slot_list_tail(g->order);
+	if(e < 0){
+		return -1;
+	}
+	page = g->pages[e];
+	isu_ghost_list_release(g, e);
+	return page;
+}
+
+unsigned int isu_ghost_list_count(isu_ghost_list_t g){
+	return isu_slot_list_count(g->order);
+}
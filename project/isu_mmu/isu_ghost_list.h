@@ -0,0 +1,81 @@
+/**
+ * @file	isu_ghost_list.h
+ * @brief	a bounded list of the page numbers of pages no longer resident
+ * @details	Replacement policies such as ARC and 2Q remember pages that were
+ * 		recently evicted without keeping the pages themselves.  A ghost
+ * 		list keeps up to `capacity` page numbers in the order they were
+ * 		pushed, newest at the head, and can tell in constant time if a
+ * 		page is in the list.
+ */
+
+#ifndef ISU_GHOST_LIST_H
+#define ISU_GHOST_LIST_H
+
+/**
+ * @class	isu_ghost_list_t
+ * @brief	a bounded list of page numbers
+ */
+typedef struct ISU_GHOST_LIST_STRUCT *isu_ghost_list_t;
+
+/**
+ * @brief	constructs a new empty ghost list
+ * @param	capacity
+ * 			the most pages the list will hold
+ * @return	the new list or NULL if a failure occurs
+ */
+isu_ghost_list_t isu_ghost_list_create(unsigned int capacity);
+
+/**
+ * @brief	destroys a ghost list
+ * @param	g
+ * 			the list to destroy
+ */
+void isu_ghost_list_destroy(isu_ghost_list_t g);
+
+/**
+ * @brief	checks if a page is in the list
+ * @param	g
+ * 			the list
+ * @param	page
+ * 			the page to look for
+ * @return	1 if `page` is in the list, 0 otherwise
+ */
+int isu_ghost_list_contains(isu_ghost_list_t g, int page);
+
+/**
+ * @brief	takes a page out of the list
+ * @param	g
+ * 			the list
+ * @param	page
+ * 			the page to take out
+ * @return	1 if `page` was in the list, 0 otherwise
+ */
+int isu_ghost_list_remove(isu_ghost_list_t g, int page);
+
+/**
+ * @brief	puts a page at the head of the list
+ * @param	g
+ * 			the list
+ * @param	page
+ * 			the page to put in the list, it must not already be in the list
+ * @return	the page dropped from the tail to make room or -1 if none was
+ */
+int isu_ghost_list_push_head(isu_ghost_list_t g, int page);
+
+/**
+ * @brief	takes the oldest page out of the list
+ * @param	g
+ * 			the list
+ * @return	the page that was at the tail or -1 if the list is empty
+ */
+int isu_ghost_list_pop_tail(isu_ghost_list_t g);
+
+/**
+ * @brief	gets the number of pages in the list
+ * @param	g
+ * 			the list
+ * @return	the number of pages in the list
+ */
+unsigned int isu_ghost_list_count(isu_ghost_list_t g);
+
+#endif
@@ -7,14 +7,24 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <limits.h>
 #include <errno.h>
 #include "isu_mmu.h"
+#include "isu_page_index.h"
+#include "isu_slot_list.h"
+#include "isu_mmu_policy.h"
+#include "isu_write_buffer.h"
+#include "isu_tlb.h"
+#include "isu_mmu_prefetch.h"
+#include "isu_page_table.h"
+#include "isu_mshr.h"
 #include "llist/isu_llist.h"
 #include "common/isu_error.h"
 #include "common/isu_color.h"
 
-/// defines for the delays for memory access, in nanoseconds
+/// defines for the delays for memory access, in nanoseconds, and the sizes of
+/// the default hierarchy built by isu_mmu_create()
 #define L1_DELAY 1
 #define L1_SIZE 4
 #define L2_DELAY 7
@@ -22,533 +32,2030 @@
 #define RAM_DELAY 75
 #define RAM_SIZE 32
 #define DISK_DELAY 5000000
+#define PAGE_SIZE 4096
+/// the most prefetches on their way at once
+#define PREFETCH_QUEUE 64
+/// the last address of the hierarchy without page tables
+#define ADDR_MAX 0xFFFF
+/// the size of an entry of a radix page table
+#define PTE_SIZE 8
+
+/// the default hierarchy
+static const isu_mmu_level_desc_t isu_mmu_default_levels[] = {
+	{L1_SIZE, L1_DELAY, PAGE_SIZE, 0},
+	{L2_SIZE, L2_DELAY, PAGE_SIZE, 0},
+	{RAM_SIZE, RAM_DELAY, PAGE_SIZE, 0}
+};
 
 /*****************************
  *Prototypes
  *****************************/
-int isu_mmu_page_check(isu_mmu_t mem, int p);
+int isu_mmu_page_check(isu_mmu_t mem, uint64_t addr);
+int isu_mmu_page_move(isu_mmu_t mem, int p, char dirty, int from_level, unsigned long long *t);
 int isu_mmu_page_fetch(isu_mmu_t mem, int p, unsigned long long *t);
-int isu_mmu_page_swap(isu_mmu_t mem, int old, int new, int new_level, unsigned long long *t);
-int isu_mmu_page_rep_fifo(isu_mmu_t mem, isu_mem_req_t req, unsigned long long *t);
-int isu_mmu_page_rep_lru(isu_mmu_t mem, isu_mem_req_t req, unsigned long long *t);
-int isu_mmu_page_rep_clock(isu_mmu_t mem, isu_mem_req_t req, unsigned long long *t);
-int isu_mmu_page_rep_second_chance(isu_mmu_t mem, isu_mem_req_t req, unsigned long long *t);
+int isu_mmu_page_swap(isu_mmu_t mem, int old, uint64_t addr, int new_level, unsigned long long *t);
+int isu_mmu_page_access(isu_mmu_t mem, uint64_t addr, int write, int *level, unsigned long long *t);
+int isu_mmu_page_load(isu_mmu_t mem, uint64_t addr, int write, int *level, int *slot, unsigned long long *t);
+int isu_mmu_page_rep(isu_mmu_t mem, uint64_t addr, int *level, unsigned long long *t);
+int isu_mmu_page_rep_fifo(isu_mmu_t mem, uint64_t addr, int *level, unsigned long long *t);
+int isu_mmu_page_rep_lru(isu_mmu_t mem, uint64_t addr, int *level, unsigned long long *t);
+int isu_mmu_page_rep_clock(isu_mmu_t mem, uint64_t addr, int *level, unsigned long long *t);
+int isu_mmu_page_rep_policy(isu_mmu_t mem, uint64_t addr, int *level, unsigned long long *t);
+static void isu_mmu_slot_touch(isu_mmu_t mem, int level, int i, unsigned long long t);
+static void isu_mmu_prefetch_arrive(isu_mmu_t mem, int p, unsigned long long *t);
+static void isu_mmu_prefetch_access(isu_mmu_t mem, int p, int level, int slot, unsigned long long t);
+static int isu_mmu_local_victim(isu_mmu_t mem, int p);
+
+/// one level of the memory hierarchy, the page frames of the level are
+/// stored as parallel arrays indexed by slot
+struct ISU_MMU_LEVEL_STRUCT{
+	/// the number of slots in this level
+	unsigned int capacity;
+
+	/// the delay of reading or writing a page at this level
+	unsigned long long latency;
+
+	/// the size of a page at this level
+	unsigned int page_size;
+
+	/// the number of slots in each set, `capacity` if the level is fully
+	/// associative. The slots of set s are s * ways to s * ways + ways - 1
+	unsigned int ways;
+
+	/// the number of sets, a power of two
+	unsigned int sets;
+
+	/// the page number held by each slot, -1 if the slot is empty
+	int *page;
+
+	/// the epoch each slot was last referenced in, a slot is referenced
+	/// while this is the epoch of the MMU and 0 never is
+	unsigned int *ref;
+
+	/// dirty bit of each slot
+	char *dirty;
+
+	/// the time of last access of each slot
+	unsigned long long *access_time;
+
+	/// the time of placement of each slot
+	unsigned long long *placement_time;
+
+	/// maps the pages in this level to their slot
+	isu_page_index_t index;
+
+	/// the used slots of each set ordered by access, most recently used at
+	/// the head. The slots are numbered from 0 within their set
+	isu_slot_list_t *recency;
+
+	/// the clock hand of each set, numbered from 0 within the set
+	int *hand;
+
+	/// the number of slots holding a page
+	unsigned int used;
+
+	/// the counters of the level, `misses` is worked out when they are read
+	isu_mmu_level_stats_t stats;
+};
+
+/// one address space and its page table
+struct ISU_MMU_PROCESS{
+	/// maps the virtual blocks of the process to blocks of the backing space
+	isu_page_table_t table;
+
+	/// the counters of the process, `resident` is kept up to date as pages
+	/// enter and leave L1
+	isu_mmu_process_stats_t stats;
+
+	/// the block of the backing space holding each node of `table`
+	long long *node_block;
+
+	/// maps the regions of a huge page the process used to the first block
+	/// of the huge frame reserved for them, NULL without huge pages
+	isu_page_table_t regions;
+
+	/// the number of nodes placed and the room for them
+	unsigned long long n_nodes;
+	unsigned long long max_nodes;
+};
+
+struct ISU_MMU_STRUCT{
+	/// the levels of the hierarchy, levels[0] is L1
+	struct ISU_MMU_LEVEL_STRUCT *levels;
+
+	/// the number of entries in `levels`
+	int n_levels;
+
+	/// the delay of fetching a page from disk
+	unsigned long long disk_delay;
+
+	/// the mode of operation for page replacement
+	int rep_mode;
+
+	/// the policy managing L1 for modes not built into the MMU, NULL otherwise
+	const isu_mmu_policy_t *policy;
+
+	/// the objects of `policy`, one for each set of L1
+	void **policy_obj;
+
+	/// the buffer between the last level and disk, NULL to write straight to disk
+	isu_write_buffer_t write_buffer;
+
+	/// counters of writes and write-backs
+	isu_mmu_write_stats_t write_stats;
+
+	/// the TLB in front of the hierarchy, NULL if there is none
+	isu_tlb_t tlb;
+
+	/// the delays of a TLB hit and of a TLB miss
+	unsigned long long tlb_hit_latency;
+	unsigned long long tlb_miss_latency;
+
+	/// counters of TLB lookups
+	isu_mmu_tlb_stats_t tlb_stats;
+
+	/// the levels of the radix page tables, 0 if a TLB miss isn't walked
+	unsigned int walk_depth;
+
+	/// the bits of the virtual block number each level of a table resolves
+	unsigned int walk_bits;
+
+	/// the page walk cache of each level above the leaves, keyed by the
+	/// block of the node the cached entry points to, NULL if there are none
+	isu_tlb_t pwc[ISU_PAGE_TABLE_MAX_DEPTH - 1];
+
+	/// counters of the page walks
+	isu_mmu_walk_stats_t walk_stats;
+
+	/// the size of a huge page, 0 without huge pages
+	unsigned int huge_size;
+
+	/// the blocks of a huge page, a huge frame is `huge_blocks` blocks
+	/// starting at a multiple of `huge_blocks`
+	unsigned int huge_blocks;
+
+	/// the blocks of a huge frame in use for it to be promoted
+	unsigned int promote;
+
+	/// the levels of the page tables below the entries mapping huge pages
+	unsigned int huge_levels;
+
+	/// the TLB of the translations of huge pages, NULL if they are kept in
+	/// `tlb`
+	isu_tlb_t huge_tlb;
+
+	/// the blocks in use of each huge frame, indexed by its first block /
+	/// `huge_blocks`
+	unsigned int *frame_used;
+
+	/// the room in `frame_used`
+	unsigned long long max_frames;
+
+	/// counters of the huge pages
+	isu_mmu_huge_stats_t huge_stats;
+
+	/// the size of the page that translated the last request
+	unsigned int last_page_size;
+
+	/// the misses of a batch in flight, NULL to handle one request at a
+	/// time
+	isu_mshr_t mshr;
+
+	/// counters of the MSHRs
+	isu_mmu_mshr_stats_t mshr_stats;
+
+	/// counters and latencies of every access, the percentiles are worked
+	/// out when they are read
+	isu_mmu_stats_t stats;
+
+	/// the current epoch of the reference bits, isu_mmu_ref_clear() starts
+	/// a new one
+	unsigned int epoch;
+
+	/// the slot of L1 accessed last, -1 if there wasn't an access yet
+	int last_slot;
+
+	/// the prefetcher filling L1, NULL if there is none
+	const isu_mmu_prefetcher_t *prefetcher;
+
+	/// the object of `prefetcher`
+	void *prefetch_obj;
+
+	/// room for the pages `prefetcher` asks for
+	int *prefetch_pages;
+
+	/// the page of each prefetch on its way, and the time it arrives
+	int pending_page[PREFETCH_QUEUE];
+	unsigned long long pending_ready[PREFETCH_QUEUE];
+
+	/// the number of prefetches on their way
+	unsigned int n_pending;
+
+	/// 1 for each slot of L1 holding a prefetched page that wasn't used yet
+	char *prefetched;
+
+	/// counters of the prefetches
+	isu_mmu_prefetch_stats_t prefetch_stats;
+
+	/// the processes, NULL without page tables
+	struct ISU_MMU_PROCESS *procs;
+
+	/// the number of processes and the room for them
+	unsigned int n_procs;
+	unsigned int max_procs;
+
+	/// maps each address space to its entry in `procs`
+	isu_page_index_t asids;
+
+	/// ISU_MMU_GLOBAL or ISU_MMU_LOCAL replacement
+	int scope;
+
+	/// the entry in `procs` of the process being handled, -1 if none
+	int current;
+
+	/// the largest and smallest page sizes of the levels, pages are mapped
+	/// in blocks of the largest
+	unsigned int block_size;
+	unsigned int min_page_size;
+
+	/// the entry in `procs` of the owner of each block of the backing space
+	unsigned int *block_owner;
+
+	/// the number of blocks mapped and the room for them
+	unsigned long long n_blocks;
+	unsigned long long max_blocks;
+};
+
+isu_mmu_t isu_mmu_create(int mode){
+	return isu_mmu_create_ex(mode, isu_mmu_default_levels, 3, DISK_DELAY);
+}
+
+isu_mmu_t isu_mmu_create_ex(int mode, const isu_mmu_level_desc_t *levels, int n_levels, unsigned long long disk_latency){
+	int i;
+	unsigned int j;
+	unsigned int ways;
+	isu_mmu_t mmu;
+	struct ISU_MMU_LEVEL_STRUCT *lvl;
+
+	if(levels == NULL || n_levels < 1){
+		isu_print(PRINT_ERROR, "the hierarchy needs at least one level");
+		return NULL;
+	}
+	for(i = 0; i < n_levels; i++){
+		if(levels[i].capacity == 0 || levels[i].page_size == 0){
+			isu_print(PRINT_ERROR, "level %d has a capacity or page size of 0", i);
+			return NULL;
+		}
+		/// the set of a page is taken from the low bits of its number
+		ways = levels[i].ways ? levels[i].ways : levels[i].capacity;
+		if(levels[i].capacity % ways || (levels[i].capacity / ways) & (levels[i].capacity / ways - 1)){
+			isu_print(PRINT_ERROR, "level %d can't be split into a power of two sets of %u ways", i, ways);
+			return NULL;
+		}
+	}
+
+	mmu = calloc(1, sizeof(struct ISU_MMU_STRUCT));
+	if(mmu == NULL){
+		isu_print(PRINT_ERROR, "calloc returned NULL");
+		return NULL;
+	}
+	mmu->levels = calloc(n_levels, sizeof(struct ISU_MMU_LEVEL_STRUCT));
+	if(mmu->levels == NULL){
+		isu_print(PRINT_ERROR, "calloc returned NULL");
+		free(mmu);
+		return NULL;
+	}
+	mmu->n_levels = n_levels;
+
+	for(i = 0; i < n_levels; i++){
+		lvl = &mmu->levels[i];
+		lvl->capacity = levels[i].capacity;
+		lvl->latency = levels[i].latency;
+		lvl->page_size = levels[i].page_size;
+		lvl->ways = levels[i].ways ? levels[i].ways : levels[i].capacity;
+		lvl->sets = lvl->capacity / lvl->ways;
+		lvl->page = malloc(lvl->capacity * sizeof(int));
+		lvl->ref = calloc(lvl->capacity, sizeof(unsigned int));
+		lvl->dirty = calloc(lvl->capacity, sizeof(char));
+		lvl->access_time = malloc(lvl->capacity * sizeof(unsigned long long));
+		lvl->placement_time = calloc(lvl->capacity, sizeof(unsigned long long));
+		lvl->index = isu_page_index_create(lvl->capacity);
+		lvl->recency = calloc(lvl->sets, sizeof(isu_slot_list_t));
+		lvl->hand = calloc(lvl->sets, sizeof(int));
+		if(lvl->page == NULL || lvl->ref == NULL || lvl->dirty == NULL ||
+		   lvl->access_time == NULL || lvl->placement_time == NULL ||
+		   lvl->index == NULL || lvl->recency == NULL || lvl->hand == NULL){
+			isu_print(PRINT_ERROR, "calloc returned NULL");
+			isu_mmu_destroy(mmu);
+			return NULL;
+		}
+		for(j = 0; j < lvl->sets; j++){
+			lvl->recency[j] = isu_slot_list_create(lvl->ways);
+			if(lvl->recency[j] == NULL){
+				isu_print(PRINT_ERROR, "calloc returned NULL");
+				isu_mmu_destroy(mmu);
+				return NULL;
+			}
+		}
+		for(j = 0; j < lvl->capacity; j++){
+			lvl->page[j] = -1;
+			lvl->access_time[j] = -1;
+		}
+	}
+	mmu->disk_delay = disk_latency;
+	mmu->rep_mode = mode;
+	mmu->last_slot = -1;
+	mmu->epoch = 1;
+	mmu->current = -1;
+	mmu->last_page_size = levels[0].page_size;
+	mmu->min_page_size = levels[0].page_size;
+	for(i = 0; i < n_levels; i++){
+		if(levels[i].page_size > mmu->block_size){
+			mmu->block_size = levels[i].page_size;
+		}
+		if(levels[i].page_size < mmu->min_page_size){
+			mmu->min_page_size = levels[i].page_size;
+		}
+	}
+	mmu->policy = isu_mmu_policy_get(mode);
+	if(mmu->policy){
+		/// each set of L1 is managed on its own
+		mmu->policy_obj = calloc(mmu->levels[0].sets, sizeof(void *));
+		if(mmu->policy_obj == NULL){
+			isu_print(PRINT_ERROR, "calloc returned NULL");
+			isu_mmu_destroy(mmu);
+			return NULL;
+		}
+		for(j = 0; j < mmu->levels[0].sets; j++){
+			mmu->policy_obj[j] = mmu->policy->construct(mmu->levels[0].ways);
+			if(mmu->policy_obj[j] == NULL){
+				isu_print(PRINT_ERROR, "could not construct the %s policy", mmu->policy->name);
+				isu_mmu_destroy(mmu);
+				return NULL;
+			}
+		}
+	}
+	isu_print(PRINT_DEBUG, "created new MMU");
+	return mmu;
+}
+
+void isu_mmu_destroy(isu_mmu_t mem){
+	int i;
+	unsigned int j;
+	for(i = 0; i < mem->n_levels; i++){
+		free(mem->levels[i].page);
+		free(mem->levels[i].ref);
+		free(mem->levels[i].dirty);
+		free(mem->levels[i].access_time);
+		free(mem->levels[i].placement_time);
+		if(mem->levels[i].index){
+			isu_page_index_destroy(mem->levels[i].index);
+		}
+		if(mem->levels[i].recency){
+			for(j = 0; j < mem->levels[i].sets; j++){
+				if(mem->levels[i].recency[j]){
+					isu_slot_list_destroy(mem->levels[i].recency[j]);
+				}
+			}
+			free(mem->levels[i].recency);
+		}
+		free(mem->levels[i].hand);
+	}
+	if(mem->policy_obj){
+		for(j = 0; j < mem->levels[0].sets; j++){
+			if(mem->policy_obj[j]){
+				mem->policy->destruct(mem->policy_obj[j]);
+			}
+		}
+		free(mem->policy_obj);
+	}
+	if(mem->write_buffer){
+		isu_write_buffer_destroy(mem->write_buffer);
+	}
+	if(mem->tlb){
+		isu_tlb_destroy(mem->tlb);
+	}
+	if(mem->prefetch_obj){
+		mem->prefetcher->destruct(mem->prefetch_obj);
+	}
+	free(mem->prefetch_pages);
+	free(mem->prefetched);
+	for(j = 0; j < mem->n_procs; j++){
+		isu_page_table_destroy(mem->procs[j].table);
+		free(mem->procs[j].node_block);
+		if(mem->procs[j].regions){
+			isu_page_table_destroy(mem->procs[j].regions);
+		}
+	}
+	for(j = 0; j < ISU_PAGE_TABLE_MAX_DEPTH - 1; j++){
+		if(mem->pwc[j]){
+			isu_tlb_destroy(mem->pwc[j]);
+		}
+	}
+	free(mem->procs);
+	if(mem->asids){
+		isu_page_index_destroy(mem->asids);
+	}
+	free(mem->block_owner);
+	if(mem->huge_tlb){
+		isu_tlb_destroy(mem->huge_tlb);
+	}
+	free(mem->frame_used);
+	if(mem->mshr){
+		isu_mshr_destroy(mem->mshr);
+	}
+	free(mem->levels);
+	mem->levels = 0;
+	free(mem);
+	mem = 0;
+}
+
+int isu_mmu_handle_req(isu_mmu_t mem, isu_mem_req_t req, unsigned long long *t){
+	// return value
+	int ret;
+	int level;
+	unsigned int i;
+
+	/// book keeping where we set the time of the request being started
+	isu_mem_req_set_req_time(req, *t);
+	/// book keeping purposes, copying all the pages in L1 cache
+	for(i = 0; i < mem->levels[0].capacity; i++){
+		isu_mem_req_add_page(req, mem->levels[0].page[i]);
+	}
+
+	ret = isu_mmu_access(mem, isu_mem_req_get_asid(req), isu_mem_req_get_address(req), isu_mem_req_get_write(req), &level, t);
+	if(level == 0){
+		isu_mem_req_set_access_hit(req, 1);
+	}
+	isu_mem_req_set_level(req, level);
+	isu_mem_req_set_page_size(req, mem->last_page_size);
+
+	/// book keeping where we set the time of the request being handled
+	isu_mem_req_set_handle_time(req, *t);
+
+	return ret;
+}
+
+/// handles a request of a batch issued at `*t`, setting `*t` to the time
+/// the next request can be issued and `done` to the time this one is done.
+/// The two are the same unless the request is a miss the MSHRs overlap
+static int isu_mmu_batch_access(isu_mmu_t mem, unsigned int asid, uint64_t addr, int write, int *level, unsigned long long *t,
+				unsigned long long *done){
+	int merged;
+	uint64_t page = addr / mem->levels[0].page_size;
+	unsigned long long issue = *t;
+	unsigned long long ready;
+	unsigned long long start;
+
+	/// the same as the test framework does between requests
+	if(mem->rep_mode != 2){
+		isu_mmu_ref_clear(mem);
+	}
+	if(mem->mshr == NULL){
+		if(isu_mmu_access(mem, asid, addr, write, level, t) < 0){
+			return -1;
+		}
+		*done = *t;
+		return 0;
+	}
+	isu_mshr_retire(mem->mshr, issue);
+	merged = isu_mshr_find(mem->mshr, asid, page, &ready);
+	/// the levels take the page in now, what the access costs is when it
+	/// arrives
+	if(isu_mmu_access(mem, asid, addr, write, level, t) < 0){
+		return -1;
+	}
+	if(merged){
+		/// the page is on its way, if the levels let it go since then
+		/// bringing it back is part of the miss in flight
+		mem->mshr_stats.merged++;
+		if(*level != 0){
+			*t = issue;
+		}
+		*done = ready > *t ? ready : *t;
+	}else if(*level != 0){
+		start = isu_mshr_add(mem->mshr, asid, page, issue, *t - issue);
+		if(start > issue){
+			mem->mshr_stats.stalls++;
+			mem->mshr_stats.stall_time += start - issue;
+		}
+		mem->mshr_stats.misses++;
+		mem->mshr_stats.serial_time += *t - issue;
+		if(isu_mshr_count(mem->mshr) > mem->mshr_stats.peak){
+			mem->mshr_stats.peak = isu_mshr_count(mem->mshr);
+		}
+		*done = start + (*t - issue);
+		*t = start;
+	}else{
+		*done = *t;
+	}
+	return 0;
+}
+
+/// puts the outcome of request `i` of a batch in `results`
+static void isu_mmu_batch_result(isu_mmu_t mem, isu_mmu_batch_result_t *results, size_t i, int level, unsigned long long issue,
+				 unsigned long long done){
+	if(results->level){
+		results->level[i] = (int8_t)level;
+	}
+	if(results->latency){
+		results->latency[i] = done - issue;
+	}
+	if(results->page_size){
+		results->page_size[i] = mem->last_page_size;
+	}
+	if(results->issue){
+		results->issue[i] = issue;
+	}
+}
+
+/// ends a batch at `*t` once its last miss is done
+static void isu_mmu_batch_end(isu_mmu_t mem, unsigned long long *t){
+	if(mem->mshr && isu_mshr_last(mem->mshr) > *t){
+		*t = isu_mshr_last(mem->mshr);
+	}
+}
+
+int isu_mmu_handle_batch(isu_mmu_t mem, const uint16_t *addrs, const uint8_t *writes, size_t n, isu_mmu_batch_result_t *results, unsigned long long *t){
+	size_t i;
+	int level;
+	unsigned long long start;
+	unsigned long long done;
+
+	for(i = 0; i < n; i++){
+		start = *t;
+		if(isu_mmu_batch_access(mem, 0, addrs[i], writes ? writes[i] : 0, &level, t, &done) < 0){
+			return -1;
+		}
+		if(results){
+			isu_mmu_batch_result(mem, results, i, level, start, done);
+		}
+	}
+	isu_mmu_batch_end(mem, t);
+	return 0;
+}
+
+int isu_mmu_handle_batch64(isu_mmu_t mem, const unsigned int *asids, const uint64_t *addrs, const uint8_t *writes, size_t n,
+			   isu_mmu_batch_result_t *results, unsigned long long *t){
+	size_t i;
+	int level;
+	unsigned long long start;
+	unsigned long long done;
+
+	for(i = 0; i < n; i++){
+		start = *t;
+		if(isu_mmu_batch_access(mem, asids ? asids[i] : 0, addrs[i], writes ? writes[i] : 0, &level, t, &done) < 0){
+			return -1;
+		}
+		if(results){
+			isu_mmu_batch_result(mem, results, i, level, start, done);
+		}
+	}
+	isu_mmu_batch_end(mem, t);
+	return 0;
+}
+
+/// finds the entry in `procs` of address space `asid`, adding one with an
+/// empty page table the first time `asid` is seen, returns -1 on failure
+static int isu_mmu_process_find(isu_mmu_t mem, unsigned int asid){
+	long long k = isu_page_index_find(mem->asids, asid);
+	struct ISU_MMU_PROCESS *procs;
+	if(k >= 0){
+		return (int)k;
+	}
+	if(mem->n_procs == mem->max_procs){
+		procs = realloc(mem->procs, 2 * mem->max_procs * sizeof(struct ISU_MMU_PROCESS));
+		if(procs == NULL){
+			isu_print(PRINT_ERROR, "realloc returned NULL");
+			return -1;
+		}
+		mem->procs = procs;
+		mem->max_procs *= 2;
+	}
+	memset(&mem->procs[mem->n_procs], 0, sizeof(struct ISU_MMU_PROCESS));
+	mem->procs[mem->n_procs].table = isu_page_table_create(mem->walk_depth, mem->walk_bits);
+	if(mem->huge_size){
+		mem->procs[mem->n_procs].regions = isu_page_table_create(0, 0);
+		if(mem->procs[mem->n_procs].regions == NULL){
+			return -1;
+		}
+	}
+	if(mem->procs[mem->n_procs].table == NULL ||
+	   isu_page_index_insert(mem->asids, asid, mem->n_procs) < 0){
+		return -1;
+	}
+	return (int)mem->n_procs++;
+}
+
+/// adds `n` blocks owned by process `k` to the end of the backing space,
+/// starting at a multiple of `n`, returns the first block or -1 on failure
+static long long isu_mmu_block_new(isu_mmu_t mem, int k, unsigned int n){
+	unsigned int *owner;
+	unsigned long long gap = (n - mem->n_blocks % n) % n;
+	unsigned long long end = mem->n_blocks + gap + n;
+	/// every page of the backing space has to fit in an int
+	if(end * (mem->block_size / mem->min_page_size) > INT_MAX){
+		isu_print(PRINT_ERROR, "the backing space is full");
+		return -1;
+	}
+	while(end > mem->max_blocks){
+		owner = realloc(mem->block_owner, 2 * mem->max_blocks * sizeof(unsigned int));
+		if(owner == NULL){
+			isu_print(PRINT_ERROR, "realloc returned NULL");
+			return -1;
+		}
+		mem->block_owner = owner;
+		mem->max_blocks *= 2;
+	}
+	/// the blocks skipped to align are never used, they only need an owner
+	while(mem->n_blocks < end){
+		mem->block_owner[mem->n_blocks++] = (unsigned int)k;
+	}
+	mem->huge_stats.gaps += gap;
+	return (long long)(end - n);
+}
+
+/// finds the block of virtual block `vblock` of process `k` in the huge
+/// frame of its region, reserving the frame the first time the region is
+/// used, and promotes the region once `promote` of its blocks are in use.
+/// Returns -1 on failure
+static long long isu_mmu_frame_map(isu_mmu_t mem, int k, unsigned long long vblock){
+	unsigned long long region = vblock / mem->huge_blocks;
+	long long frame = isu_page_table_translate(mem->procs[k].regions, region);
+	unsigned long long f;
+	unsigned long long max;
+	unsigned int *used;
+	unsigned int pages;
+	int page;
+	if(frame < 0){
+		frame = isu_mmu_block_new(mem, k, mem->huge_blocks);
+		if(frame < 0 || isu_page_table_map(mem->procs[k].regions, region, frame) < 0){
+			return -1;
+		}
+		f = (unsigned long long)frame / mem->huge_blocks;
+		if(f >= mem->max_frames){
+			max = mem->max_frames ? mem->max_frames : 1;
+			while(max <= f){
+				max *= 2;
+			}
+			used = realloc(mem->frame_used, max * sizeof(unsigned int));
+			if(used == NULL){
+				isu_print(PRINT_ERROR, "realloc returned NULL");
+				return -1;
+			}
+			memset(used + mem->max_frames, 0, (max - mem->max_frames) * sizeof(unsigned int));
+			mem->frame_used = used;
+			mem->max_frames = max;
+		}
+		mem->huge_stats.reserved += mem->huge_blocks;
+	}
+	used = &mem->frame_used[frame / mem->huge_blocks];
+	(*used)++;
+	mem->huge_stats.used++;
+	if(*used == mem->promote){
+		mem->huge_stats.promotions++;
+		/// the translations of the pages of the region give way to the
+		/// one of the huge page
+		if(mem->tlb){
+			pages = mem->huge_size / mem->levels[0].page_size;
+			page = (int)((unsigned long long)frame * mem->block_size / mem->levels[0].page_size);
+			do{
+				isu_tlb_invalidate(mem->tlb, page++);
+			}while(--pages);
+		}
+	}
+	return frame + vblock % mem->huge_blocks;
+}
+
+/// finds the block of the backing space holding virtual block `vblock` of
+/// process `k`, mapping a new block the first time, returns -1 on failure
+static long long isu_mmu_block_map(isu_mmu_t mem, int k, unsigned long long vblock){
+	long long block = isu_page_table_translate(mem->procs[k].table, vblock);
+	if(block >= 0){
+		return block;
+	}
+	if(mem->huge_size){
+		block = isu_mmu_frame_map(mem, k, vblock);
+	}else{
+		block = isu_mmu_block_new(mem, k, 1);
+	}
+	if(block < 0 || isu_page_table_map(mem->procs[k].table, vblock, block) < 0){
+		return -1;
+	}
+	mem->procs[k].stats.mapped++;
+	return block;
+}
+
+/// checks if block `block` of the backing space is in a promoted region
+static int isu_mmu_block_huge(isu_mmu_t mem, long long block){
+	return mem->huge_size && mem->frame_used[block / mem->huge_blocks] >= mem->promote;
+}
+
+/// reads the page table of process `k` for virtual block `vblock` at time
+/// `*t`, entry by entry through the hierarchy, starting below the deepest
+/// level whose page walk cache has the entry and stopping `skip` levels
+/// above the leaves. Returns -1 on failure
+static int isu_mmu_walk(isu_mmu_t mem, int k, unsigned long long vblock, unsigned int skip, unsigned long long *t){
+	struct ISU_MMU_PROCESS *proc = &mem->procs[k];
+	long long nodes[ISU_PAGE_TABLE_MAX_DEPTH];
+	long long *blocks;
+	unsigned long long start = *t;
+	int depth;
+	int d;
+	int first = 0;
+	int level;
+	int slot;
+	depth = isu_page_table_walk(proc->table, vblock, mem->walk_depth - skip, nodes);
+	if(depth < 0){
+		return -1;
+	}
+	/// the nodes the walk made are placed in the backing space, they are
+	/// numbered in the order they were made so they go at the end
+	for(d = 0; d < depth; d++){
+		if((unsigned long long)nodes[d] < proc->n_nodes){
+			continue;
+		}
+		if(proc->n_nodes == proc->max_nodes){
+			blocks = realloc(proc->node_block, (proc->max_nodes ? 2 * proc->max_nodes : (unsigned long long)depth) * sizeof(long long));
+			if(blocks == NULL){
+				isu_print(PRINT_ERROR, "realloc returned NULL");
+				return -1;
+			}
+			proc->node_block = blocks;
+			proc->max_nodes = proc->max_nodes ? 2 * proc->max_nodes : (unsigned long long)depth;
+		}
+		proc->node_block[proc->n_nodes] = isu_mmu_block_new(mem, k, 1);
+		if(proc->node_block[proc->n_nodes] < 0){
+			return -1;
+		}
+		proc->n_nodes++;
+		mem->walk_stats.nodes++;
+	}
+	/// the entry of level d points to the node of level d + 1, the caches
+	/// are looked up from the deepest, and the ones that miss are filled
+	/// by the reads of the walk
+	for(d = depth - 2; d >= 0; d--){
+		if(mem->pwc[d] && isu_tlb_lookup(mem->pwc[d], proc->node_block[nodes[d + 1]])){
+			first = d + 1;
+			mem->walk_stats.pwc_hits++;
+			mem->walk_stats.skipped += first;
+			break;
+		}
+	}
+	for(d = first; d < depth; d++){
+		if(isu_mmu_page_load(mem, (uint64_t)proc->node_block[nodes[d]] * mem->block_size +
+				     isu_page_table_entry(proc->table, vblock, d) * PTE_SIZE, 0, &level, &slot, t) < 0){
+			return -1;
+		}
+		mem->walk_stats.reads++;
+		if(level != 0){
+			mem->walk_stats.read_misses++;
+		}
+	}
+	mem->walk_stats.walks++;
+	mem->walk_stats.time += *t - start;
+	return 0;
+}
+
+/// looks up the translation of L1 page `page` in the TLB at time `*t`, on a
+/// miss the page table of process `k` is walked for virtual block `vblock`
+/// if there is a walk. `huge` is 1 if a huge page translates `page`.
+/// Returns -1 on failure
+static int isu_mmu_translate(isu_mmu_t mem, int k, unsigned long long vblock, int page, int huge, unsigned long long *t){
+	isu_tlb_t tlb = huge && mem->huge_tlb ? mem->huge_tlb : mem->tlb;
+	/// a huge page has one translation, kept under its first page
+	if(huge){
+		page -= page % (mem->huge_size / mem->levels[0].page_size);
+		mem->huge_stats.accesses++;
+	}
+	if(tlb){
+		if(isu_tlb_lookup(tlb, page)){
+			mem->tlb_stats.hits++;
+			mem->huge_stats.tlb_hits += huge;
+			*t += mem->tlb_hit_latency;
+			return 0;
+		}
+		mem->tlb_stats.misses++;
+		mem->huge_stats.tlb_misses += huge;
+		if(mem->walk_depth == 0){
+			*t += mem->tlb_miss_latency;
+		}
+	}
+	if(mem->walk_depth == 0 || k < 0){
+		return 0;
+	}
+	return isu_mmu_walk(mem, k, vblock, huge ? mem->huge_levels : 0, t);
+}
+
+/// counts an access that found its page in `level`, -1 for disk, and took
+/// `latency`
+static void isu_mmu_stats_access(isu_mmu_t mem, int level, unsigned long long latency){
+	unsigned int b = isu_mmu_hist_bucket(latency);
+	mem->stats.accesses++;
+	mem->stats.total_latency += latency;
+	if(mem->stats.max_latency < latency){
+		mem->stats.max_latency = latency;
+	}
+	mem->stats.histogram[b]++;
+	if(level < 0){
+		mem->stats.disk++;
+		return;
+	}
+	mem->levels[level].stats.hits++;
+	mem->levels[level].stats.histogram[b]++;
+}
+
+int isu_mmu_access(isu_mmu_t mem, unsigned int asid, uint64_t addr, int write, int *level, unsigned long long *t){
+	int k;
+	int ret;
+	int huge;
+	long long block;
+	uint64_t backing;
+	unsigned long long start = *t;
+	if(mem->procs == NULL){
+		if(addr > ADDR_MAX){
+			isu_print(PRINT_ERROR, "address %llu is outside of the memory", (unsigned long long)addr);
+			return -1;
+		}
+		/// the address is translated before the hierarchy is looked at
+		isu_mmu_translate(mem, -1, 0, addr / mem->levels[0].page_size, 0, t);
+		ret = isu_mmu_page_access(mem, addr, write, level, t);
+		if(ret == 0){
+			isu_mmu_stats_access(mem, *level, *t - start);
+		}
+		return ret;
+	}
+	k = isu_mmu_process_find(mem, asid);
+	if(k < 0){
+		return -1;
+	}
+	block = isu_mmu_block_map(mem, k, addr / mem->block_size);
+	if(block < 0){
+		return -1;
+	}
+	/// the hierarchy only sees the address in the backing space
+	backing = (uint64_t)block * mem->block_size + addr % mem->block_size;
+	huge = isu_mmu_block_huge(mem, block);
+	mem->last_page_size = huge ? mem->huge_size : mem->levels[0].page_size;
+	mem->current = k;
+	ret = isu_mmu_translate(mem, k, addr / mem->block_size, backing / mem->levels[0].page_size, huge, t);
+	if(ret == 0){
+		ret = isu_mmu_page_access(mem, backing, write, level, t);
+	}
+	mem->current = -1;
+	if(ret < 0){
+		return -1;
+	}
+	mem->procs[k].stats.accesses++;
+	if(*level != 0){
+		mem->procs[k].stats.faults++;
+	}
+	isu_mmu_stats_access(mem, *level, *t - start);
+	return ret;
+}
+
+int isu_mmu_set_page_tables(isu_mmu_t mem, int scope){
+	int i;
+	if(mem->procs){
+		return 0;
+	}
+	if(mem->last_slot >= 0 || mem->levels[0].used){
+		isu_print(PRINT_ERROR, "page tables have to be set before the first request");
+		return -1;
+	}
+	/// OPT was told the future in addresses without an address space
+	if(mem->policy && mem->policy->future){
+		isu_print(PRINT_ERROR, "the %s policy can't be used with page tables", mem->policy->name);
+		return -1;
+	}
+	if(scope == ISU_MMU_LOCAL && mem->rep_mode > 2){
+		isu_print(PRINT_ERROR, "local replacement needs FIFO, LRU or clock");
+		return -1;
+	}
+	if(scope != ISU_MMU_GLOBAL && scope != ISU_MMU_LOCAL){
+		isu_print(PRINT_ERROR, "%d is not a replacement scope", scope);
+		return -1;
+	}
+	for(i = 0; i < mem->n_levels; i++){
+		if(mem->block_size % mem->levels[i].page_size){
+			isu_print(PRINT_ERROR, "the page size of level %d doesn't divide %u", i, mem->block_size);
+			return -1;
+		}
+	}
+	mem->max_procs = 4;
+	mem->procs = calloc(mem->max_procs, sizeof(struct ISU_MMU_PROCESS));
+	mem->asids = isu_page_index_create(mem->max_procs);
+	mem->max_blocks = 64;
+	mem->block_owner = malloc(mem->max_blocks * sizeof(unsigned int));
+	if(mem->procs == NULL || mem->asids == NULL || mem->block_owner == NULL){
+		isu_print(PRINT_ERROR, "malloc returned NULL");
+		free(mem->procs);
+		free(mem->block_owner);
+		if(mem->asids){
+			isu_page_index_destroy(mem->asids);
+		}
+		mem->procs = NULL;
+		mem->block_owner = NULL;
+		mem->asids = NULL;
+		return -1;
+	}
+	mem->scope = scope;
+	return 0;
+}
+
+int isu_mmu_get_process_stats(isu_mmu_t mem, unsigned int asid, isu_mmu_process_stats_t *stats){
+	long long k;
+	if(mem->procs == NULL || (k = isu_page_index_find(mem->asids, asid)) < 0){
+		return -1;
+	}
+	*stats = mem->procs[k].stats;
+	return 0;
+}
+
+unsigned int isu_mmu_process_count(isu_mmu_t mem){
+	return mem->n_procs;
+}
+
+/// handles an access of the translated address `addr`, `level` is set to the
+/// level `addr` was found in, -1 if it came from disk
+int isu_mmu_page_access(isu_mmu_t mem, uint64_t addr, int write, int *level, unsigned long long *t){
+	int ret;
+	int i;
+	int page = addr / mem->levels[0].page_size;
+
+	/// prefetches that arrived by now are placed before the access
+	if(mem->prefetcher){
+		isu_mmu_prefetch_arrive(mem, page, t);
+	}
+	ret = isu_mmu_page_load(mem, addr, write, level, &i, t);
+	if(mem->prefetcher && ret == 0){
+		isu_mmu_prefetch_access(mem, page, *level, i, *t);
+	}
+	return ret;
+}
+
+/// brings the page of `addr` to L1, the way any access does but without
+/// the prefetcher seeing it, `slot` is set to the slot of L1 it is in
+int isu_mmu_page_load(isu_mmu_t mem, uint64_t addr, int write, int *level, int *slot, unsigned long long *t){
+	int ret;
+	int i;
+	unsigned int base;
+	struct ISU_MMU_LEVEL_STRUCT *L1 = &mem->levels[0];
+	int page = addr / L1->page_size;
+
+	/// runs of accesses to one page are common, while the page of the last
+	/// access is still in L1 it is a hit without searching the hierarchy
+	i = mem->last_slot;
+	if(i >= 0 && L1->page[i] == page){
+		*level = 0;
+		L1->ref[i] = mem->epoch;
+		isu_mmu_slot_touch(mem, 0, i, *t);
+		if(mem->policy){
+			base = i - i % L1->ways;
+			mem->policy->hit(mem->policy_obj[base / L1->ways], page, i - base);
+		}
+		ret = 0;
+	}else{
+		ret = isu_mmu_page_rep(mem, addr, level, t);
+		mem->last_slot = i = (int)isu_page_index_find(L1->index, page);
+	}
+	/// every access leaves the page in L1, a write makes it dirty there
+	if(write && ret == 0){
+		mem->write_stats.writes++;
+		if(i >= 0){
+			L1->dirty[i] = 1;
+		}
+	}
+	*slot = i;
+	return ret;
+}
+
+/// runs the replacement of the mode of `mem` for an access of `addr`
+int isu_mmu_page_rep(isu_mmu_t mem, uint64_t addr, int *level, unsigned long long *t){
+	// run certain replacement algorithms based on the value of mode
+	switch(mem->rep_mode){
+	case 1: return isu_mmu_page_rep_lru(mem, addr, level, t);
+	case 2: return isu_mmu_page_rep_clock(mem, addr, level, t);
+	case 3:
+	case 4:
+	case 5:
+	case 6: return isu_mmu_page_rep_policy(mem, addr, level, t);
+	default: return isu_mmu_page_rep_fifo(mem, addr, level, t);
+	}
+}
+
+int isu_mmu_set_prefetcher(isu_mmu_t mem, int kind, unsigned int degree){
+	const isu_mmu_prefetcher_t *pf = NULL;
+	void *obj = NULL;
+	int *pages = NULL;
+	if(kind){
+		pf = isu_mmu_prefetcher_get(kind);
+		if(pf == NULL){
+			isu_print(PRINT_ERROR, "%d is not a prefetcher", kind);
+			return -1;
+		}
+		/// prefetched pages would be placed out of the order OPT was told
+		if(mem->policy && mem->policy->future){
+			isu_print(PRINT_ERROR, "the %s policy can't be used with a prefetcher", mem->policy->name);
+			return -1;
+		}
+		if(mem->prefetched == NULL){
+			mem->prefetched = calloc(mem->levels[0].capacity, sizeof(char));
+		}
+		obj = pf->construct(degree);
+		pages = malloc((degree ? degree : 1) * sizeof(int));
+		if(mem->prefetched == NULL || obj == NULL || pages == NULL){
+			isu_print(PRINT_ERROR, "malloc returned NULL");
+			if(obj){
+				pf->destruct(obj);
+			}
+			free(pages);
+			return -1;
+		}
+	}
+	if(mem->prefetch_obj){
+		mem->prefetcher->destruct(mem->prefetch_obj);
+	}
+	free(mem->prefetch_pages);
+	mem->prefetcher = pf;
+	mem->prefetch_obj = obj;
+	mem->prefetch_pages = pages;
+	mem->n_pending = 0;
+	return 0;
+}
+
+void isu_mmu_get_prefetch_stats(isu_mmu_t mem, isu_mmu_prefetch_stats_t *stats){
+	*stats = mem->prefetch_stats;
+}
+
+int isu_mmu_set_tlb(isu_mmu_t mem, const isu_mmu_tlb_desc_t *desc){
+	isu_tlb_t tlb = NULL;
+	if(desc){
+		tlb = isu_tlb_create(desc->entries, desc->ways, desc->rep_mode);
+		if(tlb == NULL){
+			return -1;
+		}
+		mem->tlb_hit_latency = desc->hit_latency;
+		mem->tlb_miss_latency = desc->miss_latency;
+	}
+	if(mem->tlb){
+		isu_tlb_destroy(mem->tlb);
+	}
+	mem->tlb = tlb;
+	return 0;
+}
+
+void isu_mmu_get_tlb_stats(isu_mmu_t mem, isu_mmu_tlb_stats_t *stats){
+	*stats = mem->tlb_stats;
+}
+
+int isu_mmu_set_page_walk(isu_mmu_t mem, const isu_mmu_walk_desc_t *desc){
+	unsigned int d;
+	unsigned int bits = 0;
+	isu_tlb_t pwc[ISU_PAGE_TABLE_MAX_DEPTH - 1] = {NULL};
+	if(desc == NULL){
+		mem->walk_depth = 0;
+		return 0;
+	}
+	if(mem->procs == NULL){
+		isu_print(PRINT_ERROR, "walking needs page tables");
+		return -1;
+	}
+	if(mem->n_procs){
+		isu_print(PRINT_ERROR, "the walk has to be set before the first request");
+		return -1;
+	}
+	if(mem->huge_size){
+		isu_print(PRINT_ERROR, "the walk has to be set before the huge pages");
+		return -1;
+	}
+	if(desc->depth < 2 || desc->depth > ISU_PAGE_TABLE_MAX_DEPTH){
+		isu_print(PRINT_ERROR, "a page table can't have %u levels", desc->depth);
+		return -1;
+	}
+	/// a node fills one block, the largest page
+	while((unsigned int)(PTE_SIZE << (bits + 1)) <= mem->block_size){
+		bits++;
+	}
+	if(bits == 0){
+		isu_print(PRINT_ERROR, "a page of %u bytes can't hold a node", mem->block_size);
+		return -1;
+	}
+	for(d = 0; desc->pwc_entries && d < desc->depth - 1; d++){
+		pwc[d] = isu_tlb_create(desc->pwc_entries, 0, ISU_TLB_LRU);
+		if(pwc[d] == NULL){
+			while(d > 0){
+				isu_tlb_destroy(pwc[--d]);
+			}
+			return -1;
+		}
+	}
+	for(d = 0; d < ISU_PAGE_TABLE_MAX_DEPTH - 1; d++){
+		if(mem->pwc[d]){
+			isu_tlb_destroy(mem->pwc[d]);
+		}
+		mem->pwc[d] = pwc[d];
+	}
+	mem->walk_depth = desc->depth;
+	mem->walk_bits = bits;
+	return 0;
+}
+
+void isu_mmu_get_walk_stats(isu_mmu_t mem, isu_mmu_walk_stats_t *stats){
+	*stats = mem->walk_stats;
+}
+
+int isu_mmu_set_huge_pages(isu_mmu_t mem, const isu_mmu_huge_desc_t *desc){
+	unsigned int blocks;
+	unsigned int shift = 0;
+	isu_tlb_t tlb = NULL;
+	if(mem->procs == NULL){
+		isu_print(PRINT_ERROR, "huge pages need page tables");
+		return -1;
+	}
+	if(mem->n_procs){
+		isu_print(PRINT_ERROR, "huge pages have to be set before the first request");
+		return -1;
+	}
+	if(desc == NULL){
+		mem->huge_size = 0;
+		return 0;
+	}
+	blocks = desc->size / mem->block_size;
+	if(desc->size % mem->block_size || blocks < 2 || (blocks & (blocks - 1))){
+		isu_print(PRINT_ERROR, "a huge page of %u bytes isn't a power of two pages of %u bytes", desc->size, mem->block_size);
+		return -1;
+	}
+	if(desc->promote == 0 || desc->promote > blocks){
+		isu_print(PRINT_ERROR, "a huge page of %u pages can't be promoted after %u of them", blocks, desc->promote);
+		return -1;
+	}
+	while((1U << shift) < blocks){
+		shift++;
+	}
+	/// a huge page is mapped by an entry above the leaves, so it has to be
+	/// the size one of those entries maps
+	if(mem->walk_depth && (shift % mem->walk_bits || shift / mem->walk_bits >= mem->walk_depth)){
+		isu_print(PRINT_ERROR, "no level of the page tables maps a huge page of %u bytes", desc->size);
+		return -1;
+	}
+	if(desc->tlb_entries){
+		tlb = isu_tlb_create(desc->tlb_entries, 0, ISU_TLB_LRU);
+		if(tlb == NULL){
+			return -1;
+		}
+	}
+	if(mem->huge_tlb){
+		isu_tlb_destroy(mem->huge_tlb);
+	}
+	mem->huge_tlb = tlb;
+	mem->huge_size = desc->size;
+	mem->huge_blocks = blocks;
+	mem->promote = desc->promote;
+	mem->huge_levels = mem->walk_depth ? shift / mem->walk_bits : 0;
+	return 0;
+}
+
+void isu_mmu_get_huge_stats(isu_mmu_t mem, isu_mmu_huge_stats_t *stats){
+	*stats = mem->huge_stats;
+}
+
+unsigned int isu_mmu_get_page_size(isu_mmu_t mem){
+	return mem->levels[0].page_size;
+}
+
+int isu_mmu_set_write_buffer(isu_mmu_t mem, unsigned int entries){
+	isu_write_buffer_t wb = NULL;
+	if(entries){
+		wb = isu_write_buffer_create(entries, mem->disk_delay);
+		if(wb == NULL){
+			return -1;
+		}
+	}
+	if(mem->write_buffer){
+		isu_write_buffer_destroy(mem->write_buffer);
+	}
+	mem->write_buffer = wb;
+	return 0;
+}
+
+int isu_mmu_set_mshrs(isu_mmu_t mem, unsigned int entries){
+	isu_mshr_t mshr = NULL;
+	if(entries){
+		mshr = isu_mshr_create(entries);
+		if(mshr == NULL){
+			return -1;
+		}
+	}
+	if(mem->mshr){
+		isu_mshr_destroy(mem->mshr);
+	}
+	mem->mshr = mshr;
+	return 0;
+}
+
+void isu_mmu_get_mshr_stats(isu_mmu_t mem, isu_mmu_mshr_stats_t *stats){
+	*stats = mem->mshr_stats;
+}
+
+void isu_mmu_get_stats(isu_mmu_t mem, isu_mmu_stats_t *stats){
+	*stats = mem->stats;
+	stats->p50 = isu_mmu_hist_percentile(stats->histogram, 0.5);
+	stats->p99 = isu_mmu_hist_percentile(stats->histogram, 0.99);
+	stats->p999 = isu_mmu_hist_percentile(stats->histogram, 0.999);
+	/// the top of a bucket can be past the longest access in it
+	if(stats->p50 > stats->max_latency){
+		stats->p50 = stats->max_latency;
+	}
+	if(stats->p99 > stats->max_latency){
+		stats->p99 = stats->max_latency;
+	}
+	if(stats->p999 > stats->max_latency){
+		stats->p999 = stats->max_latency;
+	}
+}
+
+int isu_mmu_get_level_stats(isu_mmu_t mem, int level, isu_mmu_level_stats_t *stats){
+	int i;
+	unsigned long long found = 0;
+	if(level < 0 || level >= mem->n_levels){
+		return -1;
+	}
+	/// every access looks in the levels in order until it finds its page
+	for(i = 0; i <= level; i++){
+		found += mem->levels[i].stats.hits;
+	}
+	*stats = mem->levels[level].stats;
+	stats->misses = mem->stats.accesses - found;
+	return 0;
+}
 
-struct ISU_MEM_PAGE_STRUCT{
+unsigned int isu_mmu_hist_bucket(unsigned long long latency){
+	int e;
+	if(latency < ISU_MMU_HIST_SUB){
+		return (unsigned int)latency;
+	}
+	/// the power of two of the latency picks the row, the bits after its
+	/// top bit the bucket within the row
+	e = 63 - __builtin_clzll(latency);
+	return (unsigned int)((e - 2) * ISU_MMU_HIST_SUB + ((latency >> (e - 3)) & (ISU_MMU_HIST_SUB - 1)));
+}
+
+/// the largest latency of bucket `b`
+static unsigned long long isu_mmu_hist_top(unsigned int b){
+	int e;
+	if(b < ISU_MMU_HIST_SUB){
+		return b;
+	}
+	e = (int)(b / ISU_MMU_HIST_SUB) + 2;
+	return ((unsigned long long)(ISU_MMU_HIST_SUB + b % ISU_MMU_HIST_SUB) << (e - 3)) + ((1ULL << (e - 3)) - 1);
+}
 
-	/// reference bit
-	char ref;
+unsigned long long isu_mmu_hist_percentile(const unsigned long long *histogram, double q){
+	unsigned int b;
+	unsigned long long n = 0;
+	unsigned long long seen = 0;
+	unsigned long long rank;
+	for(b = 0; b < ISU_MMU_HIST_BUCKETS; b++){
+		n += histogram[b];
+	}
+	if(n == 0){
+		return 0;
+	}
+	/// the rank of the access the share ends at, counting from 1
+	rank = (unsigned long long)(q * (double)n);
+	if((double)rank < q * (double)n || rank == 0){
+		rank++;
+	}
+	for(b = 0; b < ISU_MMU_HIST_BUCKETS; b++){
+		seen += histogram[b];
+		if(seen >= rank){
+			break;
+		}
+	}
+	return isu_mmu_hist_top(b < ISU_MMU_HIST_BUCKETS ? b : ISU_MMU_HIST_BUCKETS - 1);
+}
 
-	/// dirty bit
-	char dirty;
+void isu_mmu_get_write_stats(isu_mmu_t mem, isu_mmu_write_stats_t *stats){
+	*stats = mem->write_stats;
+}
 
-	/// the page number
+int isu_mmu_set_future(isu_mmu_t mem, const unsigned short *addrs, unsigned int n){
+	unsigned int i;
+	unsigned int set;
+	int ret = 0;
 	int page;
+	int *pages;
+	/// where the requests of each set start in `pages`
+	unsigned int *start;
+	struct ISU_MMU_LEVEL_STRUCT *L1 = &mem->levels[0];
+	if(mem->policy == NULL || mem->policy->future == NULL){
+		isu_print(PRINT_ERROR, "replacement mode %d does not use future requests", mem->rep_mode);
+		return -1;
+	}
+	pages = malloc((n ? n : 1) * sizeof(int));
+	start = calloc(L1->sets + 1, sizeof(unsigned int));
+	if(pages == NULL || start == NULL){
+		isu_print(PRINT_ERROR, "malloc returned NULL");
+		free(pages);
+		free(start);
+		return -1;
+	}
+	/// each set only sees its own requests, so they are grouped by set
+	/// keeping their order
+	for(i = 0; i < n; i++){
+		start[((addrs[i] / L1->page_size) & (L1->sets - 1)) + 1]++;
+	}
+	for(set = 0; set < L1->sets; set++){
+		start[set + 1] += start[set];
+	}
+	for(i = 0; i < n; i++){
+		page = addrs[i] / L1->page_size;
+		pages[start[page & (L1->sets - 1)]++] = page;
+	}
+	for(set = 0; set < L1->sets && ret == 0; set++){
+		/// `start` now holds where each set ends
+		i = set ? start[set - 1] : 0;
+		ret = mem->policy->future(mem->policy_obj[set], pages + i, start[set] - i);
+	}
+	free(pages);
+	free(start);
+	return ret;
+}
 
-	/// the time of last access
-	unsigned long long access_time;
+int isu_mmu_ref_clear(isu_mmu_t mem){
+	/// a new epoch leaves every slot unreferenced without touching them, the
+	/// slots are only walked when the epoch wraps
+	int i;
+	mem->epoch++;
+	if(mem->epoch == 0){
+		for(i = 0; i < mem->n_levels; i++){
+			memset(mem->levels[i].ref, 0, mem->levels[i].capacity * sizeof(unsigned int));
+		}
+		mem->epoch = 1;
+	}
+	return 0;
+}
 
-	/// the time of placement
-	unsigned long long placement_time;
-};
+/// finds the slot with the earliest time in `times` that has no reference in
+/// `epoch` and
+/// is earlier than slot 0, ties go to the lowest slot
+/// returns -1 if there is no such slot
+static int isu_mmu_min_time_unref(const unsigned long long *times, const unsigned int *ref, unsigned int epoch, unsigned int n){
+	unsigned int i;
+	int min_index = -1;
+	unsigned long long min_time = times[0];
+	for(i = 0; i < n; i++){
+		if(ref[i] != epoch && times[i] < min_time){
+			min_time = times[i];
+			min_index = i;
+		}
+	}
+	return min_index;
+}
 
-typedef struct ISU_MEM_PAGE_STRUCT *isu_mem_page_t;
+/// finds the slot with the earliest time in `times`, ties go to the lowest slot
+static int isu_mmu_min_time(const unsigned long long *times, unsigned int n){
+	unsigned int i;
+	int min_index = 0;
+	unsigned long long min_time = times[0];
+	for(i = 1; i < n; i++){
+		if(times[i] < min_time){
+			min_time = times[i];
+			min_index = i;
+		}
+	}
+	return min_index;
+}
 
-struct ISU_MMU_STRUCT{
-	/// array representing L1 cache
-	isu_mem_page_t *L1;
+/// converts page `p` of level `from` to the page of level `to` holding the
+/// same address
+static int isu_mmu_page_convert(isu_mmu_t mem, int p, int from, int to){
+	if(mem->levels[from].page_size == mem->levels[to].page_size){
+		return p;
+	}
+	return (int)(((unsigned long long)p * mem->levels[from].page_size) / mem->levels[to].page_size);
+}
 
-	/// array representing L2 cache
-	isu_mem_page_t *L2;
+/// finds the slot of page `p` in level `level`, returns -1 if it isn't there
+static int isu_mmu_slot_find(isu_mmu_t mem, int level, int p){
+	if(p < 0){
+		return -1;
+	}
+	return (int)isu_page_index_find(mem->levels[level].index, p);
+}
 
-	/// array representing L3 cache
-	isu_mem_page_t *RAM;
-	
-	/// the mode of operation for page replacement
-	int rep_mode;
+/// finds the first slot of the set page `p` goes in at level `level`
+static unsigned int isu_mmu_set_base(isu_mmu_t mem, int level, int p){
+	struct ISU_MMU_LEVEL_STRUCT *lvl = &mem->levels[level];
+	return ((unsigned int)p & (lvl->sets - 1)) * lvl->ways;
+}
 
-	/// the position of the hand for the clock algorithm
-	int hand;
-};
+/// the last address of the hierarchy, the end of the backing space with
+/// page tables
+static uint64_t isu_mmu_addr_max(isu_mmu_t mem){
+	if(mem->procs == NULL){
+		return ADDR_MAX;
+	}
+	return mem->n_blocks * mem->block_size - 1;
+}
 
-isu_mmu_t isu_mmu_create(int mode){
-	int i;
-	isu_mmu_t mmu;
-	mmu = calloc(1, sizeof(struct ISU_MMU_STRUCT));
-	if(mmu == NULL){
-		isu_print(PRINT_ERROR, "calloc returned NULL");
-		return NULL;
+/// finds the first empty slot of the set of page `p` in level `level`,
+/// returns -1 if the set is full
+static int isu_mmu_slot_find_empty(isu_mmu_t mem, int level, int p){
+	unsigned int i;
+	unsigned int base;
+	struct ISU_MMU_LEVEL_STRUCT *lvl = &mem->levels[level];
+	if(lvl->used == lvl->capacity){
+		return -1;
 	}
-	mmu->L1 = malloc(L1_SIZE * sizeof(isu_mem_page_t));
-	mmu->L2 = malloc(L2_SIZE * sizeof(isu_mem_page_t));
-	mmu->RAM = malloc(RAM_SIZE * sizeof(isu_mem_page_t));
-
-	for(i = 0; i < L1_SIZE; i++){
-		mmu->L1[i] = calloc(1, sizeof(struct ISU_MEM_PAGE_STRUCT));
-		mmu->L1[i]->page = -1;
-		mmu->L1[i]->access_time = -1;
-		mmu->L1[i]->ref = 0;
-		mmu->L1[i]->dirty = 0;
-	}
-	for(i = 0; i < L2_SIZE; i++){
-		mmu->L2[i] = calloc(1, sizeof(struct ISU_MEM_PAGE_STRUCT));
-		mmu->L2[i]->page = -1;
-		mmu->L2[i]->access_time = -1;
-		mmu->L2[i]->ref = 0;
-		mmu->L2[i]->dirty = 0;
-	}
-	for(i = 0; i < RAM_SIZE; i++){
-		mmu->RAM[i] = calloc(1, sizeof(struct ISU_MEM_PAGE_STRUCT));
-		mmu->RAM[i]->page = -1;
-		mmu->RAM[i]->access_time = -1;
-		mmu->RAM[i]->ref = 0;
-		mmu->RAM[i]->dirty = 0;
+	base = isu_mmu_set_base(mem, level, p);
+	for(i = base; i < base + lvl->ways; i++){
+		if(lvl->page[i] == -1){
+			return (int)i;
+		}
 	}
-	mmu->rep_mode = mode;
-	mmu->hand = 0;
-	isu_print(PRINT_DEBUG, "created new MMU");
-	return mmu;
+	return -1;
 }
 
-void isu_mmu_destroy(isu_mmu_t mem){
-	free(mem->L1);
-	mem->L1 = 0;
-	free(mem->L2);
-	mem->L2 = 0;
-	free(mem->RAM);
-	mem->RAM = 0;
-	free(mem);
-	mem = 0;
+/// finds the entry in `procs` of the process owning L1 page `p`
+static unsigned int isu_mmu_page_owner(isu_mmu_t mem, int p){
+	return mem->block_owner[(unsigned long long)p * mem->levels[0].page_size / mem->block_size];
 }
 
-int isu_mmu_handle_req(isu_mmu_t mem, isu_mem_req_t req, unsigned long long *t){
-	// return value
+/// sets the page held by slot `i` of level `level`, keeping the index of the
+/// level up to date. `p` is -1 to empty the slot
+static void isu_mmu_slot_set_page(isu_mmu_t mem, int level, int i, int p){
+	unsigned int k;
+	struct ISU_MMU_LEVEL_STRUCT *lvl = &mem->levels[level];
+	/// the pages of each process in L1 are counted for local replacement,
+	/// and the ones another process pushed out for global replacement
+	if(level == 0 && mem->procs){
+		if(lvl->page[i] != -1){
+			k = isu_mmu_page_owner(mem, lvl->page[i]);
+			mem->procs[k].stats.resident--;
+			if(mem->current >= 0 && k != (unsigned int)mem->current){
+				mem->procs[k].stats.evicted++;
+			}
+		}
+		if(p != -1){
+			mem->procs[isu_mmu_page_owner(mem, p)].stats.resident++;
+		}
+	}
+	if(lvl->page[i] != -1){
+		isu_page_index_remove(lvl->index, lvl->page[i]);
+		lvl->used--;
+	}
+	lvl->page[i] = p;
+	if(level == 0 && mem->prefetched){
+		mem->prefetched[i] = 0;
+	}
+	if(p != -1){
+		isu_page_index_insert(lvl->index, p, i);
+		lvl->used++;
+	}else{
+		isu_slot_list_remove(lvl->recency[i / lvl->ways], i % lvl->ways);
+	}
+}
+
+/// marks slot `i` of level `level` as accessed at time `t`, making it the most
+/// recently used slot of the level
+static void isu_mmu_slot_touch(isu_mmu_t mem, int level, int i, unsigned long long t){
+	struct ISU_MMU_LEVEL_STRUCT *lvl = &mem->levels[level];
+	lvl->access_time[i] = t;
+	isu_slot_list_push_head(lvl->recency[i / lvl->ways], i % lvl->ways);
+}
+
+/// finds the least recently used slot of level `level` in the set of page `p`
+static int isu_mmu_slot_lru(isu_mmu_t mem, int level, int p){
+	struct ISU_MMU_LEVEL_STRUCT *lvl = &mem->levels[level];
+	unsigned int base = isu_mmu_set_base(mem, level, p);
+	return (int)base + isu_slot_list_tail(lvl->recency[base / lvl->ways]);
+}
+
+/// advances the clock hand of the set of page `p` in L1 past the referenced
+/// slots, clearing their reference bits, and returns the slot it stops at
+static int isu_mmu_slot_clock(isu_mmu_t mem, int p){
+	struct ISU_MMU_LEVEL_STRUCT *L1 = &mem->levels[0];
+	unsigned int base = isu_mmu_set_base(mem, 0, p);
+	int *hand = &L1->hand[base / L1->ways];
 	int ret;
+	while(L1->ref[base + *hand] == mem->epoch){
+		// ref bit is 0
+		L1->ref[base + *hand] = 0;
 
-	/// book keeping where we set the time of the request being started
-	isu_mem_req_set_req_time(req, *t);
-	// run certain replacement algorithms based on the value of mode
-	switch(mem->rep_mode){
-	case 1: ret = isu_mmu_page_rep_lru(mem, req, t);
-		break;
-	case 2: ret = isu_mmu_page_rep_clock(mem, req, t);
-		break;
-	default: ret = isu_mmu_page_rep_fifo(mem, req, t);
-		break;
+		// Advance clock pointer
+		*hand += 1;
+
+		// If clock hand is greater than set size, reset clock hand
+		if(*hand >= (int)L1->ways){
+			*hand = 0;
+		}
 	}
+	ret = (int)base + *hand;
+	*hand += 1;
+	if(*hand >= (int)L1->ways){
+		*hand = 0;
+	}
+	return ret;
+}
 
-	/// book keeping where we set the time of the request being handled
-	isu_mem_req_set_handle_time(req, *t);
+/// picks the slot of L1 to give up for page `p` under local replacement,
+/// returns -1 if the choice is left to the global replacement, which is when
+/// the process being handled holds less than its share of L1, or none of the
+/// set of `p`
+static int isu_mmu_local_victim(isu_mmu_t mem, int p){
+	struct ISU_MMU_LEVEL_STRUCT *L1 = &mem->levels[0];
+	unsigned int base;
+	unsigned int share;
+	unsigned int i;
+	unsigned int n = 0;
+	int *hand;
+	int j;
+	int victim = -1;
+	if(mem->scope != ISU_MMU_LOCAL || mem->current < 0){
+		return -1;
+	}
+	share = L1->capacity / mem->n_procs;
+	if(mem->procs[mem->current].stats.resident < (share ? share : 1)){
+		return -1;
+	}
+	base = isu_mmu_set_base(mem, 0, p);
+	for(i = base; i < base + L1->ways; i++){
+		if(L1->page[i] != -1 && isu_mmu_page_owner(mem, L1->page[i]) == (unsigned int)mem->current){
+			n++;
+			/// FIFO takes the unreferenced page placed first, or the page
+			/// placed first if all are referenced
+			if(victim < 0 || (L1->ref[i] == mem->epoch) < (L1->ref[victim] == mem->epoch) ||
+			   ((L1->ref[i] == mem->epoch) == (L1->ref[victim] == mem->epoch) &&
+			    L1->placement_time[i] < L1->placement_time[victim])){
+				victim = (int)i;
+			}
+		}
+	}
+	if(n == 0){
+		return -1;
+	}
+	if(mem->rep_mode == 1){
+		/// the least recently used of the pages of the process
+		j = isu_slot_list_tail(L1->recency[base / L1->ways]);
+		while(j >= 0 && isu_mmu_page_owner(mem, L1->page[base + j]) != (unsigned int)mem->current){
+			j = isu_slot_list_prev(L1->recency[base / L1->ways], j);
+		}
+		victim = j >= 0 ? (int)base + j : -1;
+	}else if(mem->rep_mode == 2){
+		/// the clock hand passes over the pages of other processes, and
+		/// only clears the reference bits of the pages of this one
+		hand = &L1->hand[base / L1->ways];
+		for(;;){
+			i = base + *hand;
+			*hand += 1;
+			if(*hand >= (int)L1->ways){
+				*hand = 0;
+			}
+			if(L1->page[i] == -1 || isu_mmu_page_owner(mem, L1->page[i]) != (unsigned int)mem->current){
+				continue;
+			}
+			if(L1->ref[i] != mem->epoch){
+				break;
+			}
+			L1->ref[i] = 0;
+		}
+		victim = (int)i;
+	}
+	return victim;
+}
 
-	return ret;
+/// places page `p` in slot `i` of level `level` at time `t`
+static void isu_mmu_slot_fill(isu_mmu_t mem, int level, int i, int p, unsigned long long t){
+	struct ISU_MMU_LEVEL_STRUCT *lvl = &mem->levels[level];
+	isu_mmu_slot_set_page(mem, level, i, p);
+	lvl->placement_time[i] = t;
+	isu_mmu_slot_touch(mem, level, i, t);
+	lvl->ref[i] = 0;
+	lvl->dirty[i] = 0;
 }
 
-int isu_mmu_ref_clear(isu_mmu_t mem){
+/// places prefetched page `p` in L1 at time `when`, when it arrived
+static void isu_mmu_prefetch_fill(isu_mmu_t mem, int p, unsigned long long when){
+	int level;
 	int i;
-	for(i = 0; i < L1_SIZE; i++){
-		mem->L1[i]->ref = 0;
+	int current = mem->current;
+	unsigned long long t = when;
+	if(isu_mmu_slot_find(mem, 0, p) >= 0){
+		return;
 	}
-	for(i = 0; i < L2_SIZE; i++){
-		mem->L2[i]->ref = 0;
+	/// the page is placed the way a demand access would, for the process
+	/// owning it, but on a clock of its own so no request waits for it
+	if(mem->procs){
+		mem->current = (int)isu_mmu_page_owner(mem, p);
 	}
-	for(i = 0; i < RAM_SIZE; i++){
-		mem->RAM[i]->ref = 0;
+	isu_mmu_page_rep(mem, (uint64_t)p * mem->levels[0].page_size, &level, &t);
+	mem->current = current;
+	i = isu_mmu_slot_find(mem, 0, p);
+	if(i >= 0){
+		mem->prefetched[i] = 1;
 	}
 }
 
-/// checks if the page `page` exists in any level of memory in `mem`
-/// returns 0 if in L1
-/// returns 1 if in L2
-/// returns 2 if in L3
-/// returns -1 if not in `mem`
-int isu_mmu_page_check(isu_mmu_t mem, int p){
-	if(p < 0){
-		isu_print(PRINT_ERROR, "Error in value of p: value not applicable");
+/// places the prefetches that arrived by `*t`, an access of page `p` that is
+/// still on its way first waits for it
+static void isu_mmu_prefetch_arrive(isu_mmu_t mem, int p, unsigned long long *t){
+	unsigned int k;
+	for(k = 0; k < mem->n_pending; k++){
+		if(mem->pending_page[k] == p && mem->pending_ready[k] > *t){
+			mem->prefetch_stats.late++;
+			*t = mem->pending_ready[k];
+		}
 	}
-
-	int i;
-	for(i = 0; i < L1_SIZE; i++){
-		if(mem->L1[i]->page == p){
-			mem->L1[i]->ref = 1;
-			return 0;
+	k = 0;
+	while(k < mem->n_pending){
+		if(mem->pending_ready[k] > *t){
+			k++;
+			continue;
 		}
+		isu_mmu_prefetch_fill(mem, mem->pending_page[k], mem->pending_ready[k]);
+		mem->n_pending--;
+		mem->pending_page[k] = mem->pending_page[mem->n_pending];
+		mem->pending_ready[k] = mem->pending_ready[mem->n_pending];
 	}
+}
 
-	for(i = 0; i < L2_SIZE; i++){
-		if(mem->L2[i]->page == p){
-			mem->L2[i]->ref = 1;
-			return 1;
+/// starts a prefetch of L1 page `p` at time `t`, unless it is not an address
+/// or is already in L1 or on its way
+static void isu_mmu_prefetch_issue(isu_mmu_t mem, int p, unsigned long long t){
+	int level;
+	unsigned int k;
+	unsigned long long cost = mem->disk_delay;
+	if(p < 0 || (unsigned long long)p * mem->levels[0].page_size > isu_mmu_addr_max(mem) ||
+	   mem->n_pending == PREFETCH_QUEUE || isu_mmu_slot_find(mem, 0, p) >= 0){
+		return;
+	}
+	for(k = 0; k < mem->n_pending; k++){
+		if(mem->pending_page[k] == p){
+			return;
 		}
 	}
+	/// a page in a lower level is swapped up, anything else comes from disk
+	for(level = 1; level < mem->n_levels; level++){
+		if(isu_mmu_slot_find(mem, level, isu_mmu_page_convert(mem, p, 0, level)) >= 0){
+			cost = 2 * mem->levels[level].latency;
+			break;
+		}
+	}
+	mem->pending_page[mem->n_pending] = p;
+	mem->pending_ready[mem->n_pending] = t + cost;
+	mem->n_pending++;
+	mem->prefetch_stats.issued++;
+}
+
+/// tells the prefetcher about the access of page `p`, found in `level` and
+/// now in slot `slot` of L1, and starts the prefetches it asks for
+static void isu_mmu_prefetch_access(isu_mmu_t mem, int p, int level, int slot, unsigned long long t){
+	unsigned int k;
+	unsigned int n;
+	int outcome = ISU_MMU_PREFETCH_HIT;
+	if(level != 0){
+		mem->prefetch_stats.misses++;
+		outcome = ISU_MMU_PREFETCH_MISS;
+	}else if(slot >= 0 && mem->prefetched[slot]){
+		mem->prefetch_stats.useful++;
+		mem->prefetched[slot] = 0;
+		outcome = ISU_MMU_PREFETCH_USED;
+	}
+	n = mem->prefetcher->access(mem->prefetch_obj, p, outcome, mem->prefetch_pages);
+	for(k = 0; k < n; k++){
+		isu_mmu_prefetch_issue(mem, mem->prefetch_pages[k], t);
+	}
+}
+
+/// writes dirty page `p` of the last level back to disk, through the write
+/// buffer if there is one
+static void isu_mmu_write_back(isu_mmu_t mem, int p, unsigned long long *t){
+	int coalesced;
+	unsigned long long queued;
+	mem->write_stats.writebacks++;
+	if(mem->write_buffer == NULL){
+		*t += mem->disk_delay;
+		return;
+	}
+	queued = isu_write_buffer_put(mem->write_buffer, p, *t, &coalesced);
+	if(coalesced){
+		mem->write_stats.coalesced++;
+	}else{
+		mem->write_stats.buffered++;
+	}
+	if(queued > *t){
+		mem->write_stats.stalls++;
+		mem->write_stats.stall_time += queued - *t;
+		*t = queued;
+	}
+}
+
+/// reads L1 page `p` from disk, or from the write buffer if it is still
+/// waiting there
+static void isu_mmu_disk_read(isu_mmu_t mem, int p, unsigned long long *t){
+	int last = mem->n_levels - 1;
+	if(mem->write_buffer &&
+	   isu_write_buffer_contains(mem->write_buffer, isu_mmu_page_convert(mem, p, 0, last), *t)){
+		mem->write_stats.buffer_reads++;
+		*t += mem->levels[last].latency;
+		return;
+	}
+	*t += mem->disk_delay;
+}
 
-	for(i = 0; i < RAM_SIZE; i++){
-		if(mem->RAM[i]->page == p){
-			mem->RAM[i]->ref = 1;
-			return 2;
+/// checks if the address `addr` exists in any level of memory in `mem`
+/// returns the level it was found in, 0 being L1
+/// returns -1 if not in `mem`
+int isu_mmu_page_check(isu_mmu_t mem, uint64_t addr){
+	int level;
+	int i;
+	for(level = 0; level < mem->n_levels; level++){
+		i = isu_mmu_slot_find(mem, level, addr / mem->levels[level].page_size);
+		if(i >= 0){
+			mem->levels[level].ref[i] = mem->epoch;
+			return level;
 		}
 	}
 	// can't find it in `mem`
 	return -1;
 }
 
-int isu_mmu_page_move(isu_mmu_t mem, int p, int from_level, unsigned long long *t){
-	int i;
-	unsigned long long temp_time;
-	int replace_index = INT_MAX;
-	/// if the move is to occur from L1
-	if(from_level == 0){
-		/// first, check if there are any open slots in L2
-		for(i = 0; i < L2_SIZE; i++){
-			/// if there is, then we move the passed in page into the open
-			/// slot
-			if(mem->L2[i]->page == -1){
-				/// add delay of writing to L2
-				*t += L2_DELAY;
-				/// write over current slot in L2
-				mem->L2[i]->page = p;
-				mem->L2[i]->placement_time = *t;
-				mem->L2[i]->access_time = *t;
-				mem->L2[i]->ref = 0;
-				mem->L2[i]->dirty = 0;
-				return 0;
-			}
+/// moves page `p` of level `from_level` down to the next level, pushing
+/// pages further down the hierarchy as needed. `dirty` goes along with the
+/// page, and dirty pages moved out of the last level are written to disk
+int isu_mmu_page_move(isu_mmu_t mem, int p, char dirty, int from_level, unsigned long long *t){
+	int j;
+	int end;
+	int replace_index;
+	unsigned int base;
+	int to_level = from_level + 1;
+	struct ISU_MMU_LEVEL_STRUCT *lvl;
+
+	/// clean pages leaving the last level just disappear, disk already has them
+	if(to_level >= mem->n_levels){
+		if(dirty){
+			isu_mmu_write_back(mem, p, t);
 		}
-		/// if there wasn't an open slot then we would have to move a page from
-		/// the current level down to RAM. Choosing the page to be moved based
-		/// on when page was last accessed as chances are that if a page hasn't
-		/// been accessed in a while, it won't be accessed again
-		temp_time = mem->L2[0]->access_time;
-		for(i = 0; i < L2_SIZE; i++){
-			if(!(mem->L2[i]->ref) && temp_time > mem->L2[i]->access_time){
-				temp_time = mem->L2[i]->access_time;
-				replace_index = i;
-			}
+		/// the page is no longer mapped, so neither is any L1 page in it
+		if(mem->tlb){
+			j = isu_mmu_page_convert(mem, p, from_level, 0);
+			end = isu_mmu_page_convert(mem, p + 1, from_level, 0);
+			do{
+				isu_tlb_invalidate(mem->tlb, j);
+			}while(++j < end);
 		}
-		/// if a move candidate was not found
-		if(replace_index == INT_MAX){
-			/// we loop through L2 again, this time, not worrying about reference bit
-			replace_index = 0;
-			for(i = 0; i < L2_SIZE; i++){
-				if(temp_time > mem->L2[i]->access_time){
-					temp_time = mem->L2[i]->access_time;
-					replace_index = i;
-				}
-			}
-			/// now we are guaranteed that there will be a valid replace index
+		/// nor is the huge page it is part of
+		if(isu_mmu_block_huge(mem, (long long)((unsigned long long)p * mem->levels[from_level].page_size / mem->block_size)) &&
+		   (mem->huge_tlb || mem->tlb)){
+			j = isu_mmu_page_convert(mem, p, from_level, 0);
+			j -= j % (mem->huge_size / mem->levels[0].page_size);
+			isu_tlb_invalidate(mem->huge_tlb ? mem->huge_tlb : mem->tlb, j);
 		}
+		return 0;
+	}
+	lvl = &mem->levels[to_level];
+	p = isu_mmu_page_convert(mem, p, from_level, to_level);
 
-		isu_mmu_page_move(mem, mem->L2[replace_index]->page, 1, t);
-		/// once move is complete, we put our page that we want into
-		/// the `replace_index` slot
+	/// if the page of the lower level is already there(the levels have
+	/// different page sizes), we only have to write to it
+	j = isu_mmu_slot_find(mem, to_level, p);
+	if(j >= 0){
+		*t += lvl->latency;
+		isu_mmu_slot_touch(mem, to_level, j, *t);
+		lvl->dirty[j] |= dirty;
+		return 0;
+	}
 
-		/// add the delay of writing to L2
-		*t += L2_DELAY;
-		mem->L2[replace_index]->page = p;
-		mem->L2[replace_index]->placement_time = *t;
-		mem->L2[replace_index]->access_time = *t;
-		mem->L2[replace_index]->ref = 0;
-		mem->L2[replace_index]->dirty = 0;
+	/// first, check if there are any open slots in the set of the next level
+	j = isu_mmu_slot_find_empty(mem, to_level, p);
+	/// if there is, then we move the passed in page into the open
+	/// slot
+	if(j >= 0){
+		/// add delay of writing to the next level
+		*t += lvl->latency;
+		/// write over current slot
+		isu_mmu_slot_fill(mem, to_level, j, p, *t);
+		lvl->dirty[j] = dirty;
 		return 0;
-	}else if(from_level == 1){	
-		/// first, check if there are any open slots in RAM
-		for(i = 0; i < L2_SIZE; i++){
-			/// if there is, then we move the passed in page into the open
-			/// slot
-			if(mem->RAM[i]->page == -1){
-				/// add delay of writing to RAM
-				*t += RAM_DELAY;
-				/// write over current slot in RAM
-				mem->RAM[i]->page = p;
-				mem->RAM[i]->placement_time = *t;
-				mem->RAM[i]->access_time = *t;
-				mem->RAM[i]->ref = 0;
-				mem->RAM[i]->dirty = 0;
-				return 0;
-			}
-		}
-		/// if there wasn't an open slot then we would have to move a page from
-		/// the current level down to disk. Choosing the page to be moved based
-		/// on when page was last accessed as chances are that if a page hasn't
-		/// been accessed in a while, it won't be accessed again
-		temp_time = mem->RAM[0]->access_time;
-		for(i = 0; i < RAM_SIZE; i++){
-			if(!(mem->RAM[i]->ref) && temp_time > mem->RAM[i]->access_time){
-				temp_time = mem->RAM[i]->access_time;
-				replace_index = i;
-			}
-		}
+	}
+	/// if there wasn't an open slot then we would have to move a page from
+	/// the next level further down. Choosing the page to be moved based
+	/// on when page was last accessed as chances are that if a page hasn't
+	/// been accessed in a while, it won't be accessed again
+	if(mem->rep_mode == 1){
+		/// LRU takes the tail of the recency list
+		replace_index = isu_mmu_slot_lru(mem, to_level, p);
+	}else{
+		base = isu_mmu_set_base(mem, to_level, p);
+		replace_index = isu_mmu_min_time_unref(lvl->access_time + base, lvl->ref + base, mem->epoch, lvl->ways);
 		/// if a move candidate was not found
-		if(replace_index == INT_MAX){
-			/// we loop through RAM again, this time, not worrying about reference bit
-			replace_index = 0;
-			for(i = 0; i < RAM_SIZE; i++){
-				if(temp_time > mem->RAM[i]->access_time){
-					temp_time = mem->RAM[i]->access_time;
-					replace_index = i;
-				}
-			}
+		if(replace_index < 0){
+			/// we look through the set again, this time, not worrying about reference bit
+			replace_index = isu_mmu_min_time(lvl->access_time + base, lvl->ways);
 			/// now we are guaranteed that there will be a valid replace index
 		}
+		replace_index += base;
+	}
 
-		/// since there is no access to disk here, it just disappears from RAM
-		/// once move is complete, we put our page that we want into
-		/// the `replace_index` slot
+	lvl->stats.evictions++;
+	lvl->stats.writebacks += lvl->dirty[replace_index] != 0;
+	isu_mmu_page_move(mem, lvl->page[replace_index], lvl->dirty[replace_index], to_level, t);
+	/// once move is complete, we put our page that we want into
+	/// the `replace_index` slot
 
-		/// add the delay of writing to RAM
-		*t += RAM_DELAY;
-		mem->RAM[replace_index]->page = p;
-		mem->RAM[replace_index]->placement_time = *t;
-		mem->RAM[replace_index]->access_time = *t;
-		mem->RAM[replace_index]->ref = 0;
-		mem->RAM[replace_index]->dirty = 0;
-		return 0;
-	}
+	/// add the delay of writing to the next level
+	*t += lvl->latency;
+	isu_mmu_slot_fill(mem, to_level, replace_index, p, *t);
+	lvl->dirty[replace_index] = dirty;
+	return 0;
 }
 
 int isu_mmu_page_fetch(isu_mmu_t mem, int p, unsigned long long *t){
-	/// counter
-	int i;
-	/// variable to keep track of state
-	int ret;
-	/// Flag for clock algorithm
-	int flag = 1;
-	/// after this line, the variables are for handling when an empty slot cannot be found
-	/// temporary variable to store the time when a page is placed in the slot
-	unsigned long long temp_time;
 	/// the index of the slot that will be replaced
-	int replace_index = 0;
-	/// loop through L1 cache to find an empty slot
-	for(i = 0; i < L1_SIZE; i++){
-		/// if the current slot in L1 is empty
-		if(-1 == mem->L1[i]->page){
-			/// increment time due to reading stuff from disk
-			*t += DISK_DELAY;
-			/// place our page here
-			mem->L1[i]->page = p;
-			mem->L1[i]->placement_time = *t;
-			mem->L1[i]->access_time = *t;
-			if(mem->rep_mode < 2){
-				mem->L1[i]->ref = 1;
-			}else{
-				mem->L1[i]->ref = 0;
-			}
-			mem->L1[i]->dirty = 0;
-			return 0;
+	int replace_index;
+	/// L1 cache
+	struct ISU_MMU_LEVEL_STRUCT *L1 = &mem->levels[0];
+	/// the first slot of the set of `p` in L1
+	unsigned int base = isu_mmu_set_base(mem, 0, p);
+	/// look through the set of L1 to find an empty slot
+	replace_index = isu_mmu_slot_find_empty(mem, 0, p);
+	L1->stats.promotions++;
+	/// if there is an empty slot in L1
+	if(replace_index >= 0){
+		/// increment time due to reading stuff from disk
+		isu_mmu_disk_read(mem, p, t);
+		/// place our page here
+		isu_mmu_slot_fill(mem, 0, replace_index, p, *t);
+		if(mem->rep_mode < 2){
+			L1->ref[replace_index] = mem->epoch;
 		}
+		if(mem->policy){
+			mem->policy->place(mem->policy_obj[base / L1->ways], p, replace_index - base);
+		}
+		return 0;
 	}
-	
+
 	/// if there were no empty slots in L1, we must replace a page in L1 with the page
 	/// we want. To do that, we first need to move the page based on the replacement
 	/// algorithm(the case for the clock algorithm can change)
-	switch(mem->rep_mode){
-	case 0: /// fifo page replacement
-		temp_time = mem->L1[0]->placement_time;
-		for(i = 0; i < L1_SIZE; i++){
-			/// if the page of the current slot has no references
-			if(!(mem->L1[i]->ref)){
-				/// if the page at the current slot has been around longer
-				/// than the last one
-				if(temp_time > mem->L1[i]->placement_time){
-					temp_time = mem->L1[i]->placement_time;
-					replace_index = i;
-				}
-			}
-		}
-		/// once we know the replace index, we call the move function to move the
-		/// page in L1 that we just found to a lower level of cache
-		isu_mmu_page_move(mem, mem->L1[replace_index]->page, 0, t);
-
-		/// move was successful, now we place our new page in the place of
-		/// the moved page
-		/// increment time due to reading stuff from disk
-		*t += DISK_DELAY;
-		mem->L1[replace_index]->page = p;
-		mem->L1[replace_index]->placement_time = *t;
-		mem->L1[replace_index]->access_time = *t;
-		mem->L1[replace_index]->ref = 1;
-		mem->L1[replace_index]->dirty = 0;
-		break;
-	case 1: /// LRU page replacement
-		temp_time = mem->L1[0]->access_time;
-		for(i = 0; i < L1_SIZE; i++){
-			/// if the page of the current slot has no references
-			if(!(mem->L1[i]->ref)){
-				/// if the page at the current slot has been used least recently
-				/// than the last one
-				if(temp_time > mem->L1[i]->access_time){
-					temp_time = mem->L1[i]->access_time;
-					replace_index = i;
-				}
+	/// local replacement may pick one of the pages of the process instead
+	replace_index = isu_mmu_local_victim(mem, p);
+	if(replace_index < 0){
+		switch(mem->rep_mode){
+		case 0: /// fifo page replacement
+			/// the unreferenced page that has been around the longest
+			replace_index = isu_mmu_min_time_unref(L1->placement_time + base, L1->ref + base, mem->epoch, L1->ways);
+			if(replace_index < 0){
+				replace_index = 0;
 			}
-		}
-		/// once we know the replace index, we call the move function to move the
-		/// page in L1 that we just found to a lower level of cache
-		isu_mmu_page_move(mem, mem->L1[replace_index]->page, 0, t);
-
-		/// move was successful, now we place our new page in the place of
-		/// the moved page
-		/// increment time due to reading stuff from disk
-		*t += DISK_DELAY;
-		mem->L1[replace_index]->page = p;
-		mem->L1[replace_index]->placement_time = *t;
-		mem->L1[replace_index]->access_time = *t;
-		mem->L1[replace_index]->ref = 1;
-		mem->L1[replace_index]->dirty = 0;
-		break;
-	case 2:	/// clock page replacement
-		while(mem->L1[mem->hand]->ref){
-			// ref bit is 0
-			mem->L1[mem->hand]->ref = 0;
-			
-			// Advance clock pointer
-			mem->hand += 1;
-			
-			// If clock hand is greater than cache size, reset clock hand
-			if(mem->hand >= L1_SIZE){
-				mem->hand = 0;
+			replace_index += base;
+			break;
+		case 1: /// LRU page replacement
+			/// the page that has been used least recently
+			replace_index = isu_mmu_slot_lru(mem, 0, p);
+			break;
+		case 2:	/// clock page replacement
+			replace_index = isu_mmu_slot_clock(mem, p);
+			break;
+		default:
+			/// the policy picks the page to give up
+			if(mem->policy == NULL){
+				return 0;
 			}
+			replace_index = base + mem->policy->victim(mem->policy_obj[base / L1->ways], p);
+			break;
 		}
+	}
 
-		/// once we know the replace index, we call the move function to move the
-		/// page in L1 that we just found to a lower level of cache
-		isu_mmu_page_move(mem, mem->L1[mem->hand]->page, 0, t);
+	/// once we know the replace index, we call the move function to move the
+	/// page in L1 that we just found to a lower level of cache
+	L1->stats.evictions++;
+	L1->stats.writebacks += L1->dirty[replace_index] != 0;
+	isu_mmu_page_move(mem, L1->page[replace_index], L1->dirty[replace_index], 0, t);
 
-		/// move was successful, now we place our new page in the place of
-		/// the moved page
-		/// increment time due to reading stuff from disk
-		*t += DISK_DELAY;
-		mem->L1[mem->hand]->page = p;
-		mem->L1[mem->hand]->placement_time = *t;
-		mem->L1[mem->hand]->access_time = *t;
-		mem->L1[mem->hand]->ref = 1;
-		mem->L1[mem->hand]->dirty = 0;
-		
-		mem->hand += 1;
-		if(mem->hand >= L1_SIZE){
-			mem->hand = 0;
-		}
-		break;
+	/// move was successful, now we place our new page in the place of
+	/// the moved page
+	/// increment time due to reading stuff from disk
+	isu_mmu_disk_read(mem, p, t);
+	isu_mmu_slot_fill(mem, 0, replace_index, p, *t);
+	L1->ref[replace_index] = mem->epoch;
+	if(mem->policy){
+		mem->policy->place(mem->policy_obj[base / L1->ways], p, replace_index - base);
 	}
 	return 0;
 }
 
-int isu_mmu_page_swap(isu_mmu_t mem, int old, int new, int new_level, unsigned long long *t){
+/// swaps page `old` in L1 with the page holding `addr` in level `new_level`
+int isu_mmu_page_swap(isu_mmu_t mem, int old, uint64_t addr, int new_level, unsigned long long *t){
+	/// the page of `addr` in L1 and in `new_level`
+	int new = addr / mem->levels[0].page_size;
+	int lower_new = addr / mem->levels[new_level].page_size;
+	/// the page of `old` in `new_level`
+	int lower_old;
+	int replace_index;
+	int i;
+	int j;
+	/// the dirty bits of `old` and `new`, they travel with their pages
+	char old_dirty;
+	char new_dirty;
+	struct ISU_MMU_LEVEL_STRUCT *L1 = &mem->levels[0];
+	struct ISU_MMU_LEVEL_STRUCT *lvl = &mem->levels[new_level];
+
 	/// if the page values are out of range, return -1(error)
-	if(old < 0 || new < 0){
+	if(old < 0 || new_level < 1 || new_level >= mem->n_levels){
 		return -1;
+	}
+	/// find the index of `old` in L1 and the spot of `new` in `new_level`
+	replace_index = isu_mmu_slot_find(mem, 0, old);
+	i = isu_mmu_slot_find(mem, new_level, lower_new);
+	if(replace_index < 0 || i < 0){
+		return -1;
+	}
+	lower_old = isu_mmu_page_convert(mem, old, 0, new_level);
+	old_dirty = L1->dirty[replace_index];
+	new_dirty = lvl->dirty[i];
+	L1->stats.evictions++;
+	L1->stats.writebacks += old_dirty != 0;
+	L1->stats.promotions++;
+	lvl->stats.swaps++;
+
+	/// switch the places of `old` and `new`
+	isu_mmu_slot_set_page(mem, 0, replace_index, new);
+	*t += lvl->latency;
+	isu_mmu_slot_touch(mem, 0, replace_index, *t);
+	L1->placement_time[replace_index] = *t;
+	/// with different page sizes the lower page of `old` may already be
+	/// in `new_level`, in which case it is only written to
+	j = isu_mmu_slot_find(mem, new_level, lower_old);
+	if(j < 0 && isu_mmu_set_base(mem, new_level, lower_old) != i - i % lvl->ways){
+		/// in a set-associative level `old` may belong to another set than
+		/// `new`, it goes there like any page leaving the level above
+		isu_mmu_slot_set_page(mem, new_level, i, -1);
+		lvl->access_time[i] = -1;
+		isu_mmu_page_move(mem, isu_mmu_page_convert(mem, old, 0, new_level - 1), old_dirty, new_level - 1, t);
 	}else{
-		/// loop through L1 cache to find the index of `old`
-		int i;
-		int replace_index = INT_MAX;
-		for(i = 0; i < L1_SIZE; i++){
-			if(mem->L1[i]->page == old){
-				replace_index = i;
-				break;
-			}
-		}
-		switch(new_level){
-		case 1: /// `new` is in L2 cache
-			/// find the spot of `new`
-			for(i = 0; i < L2_SIZE; i++){
-				if(mem->L2[i]->page == new){
-					/// switch the places of `old` and `new`
-					mem->L2[i]->page = old;
-					mem->L1[replace_index]->page = new;
-					*t += L2_DELAY;
-					mem->L1[replace_index]->access_time = *t;
-					mem->L1[replace_index]->placement_time = *t;
-					*t += L2_DELAY;
-					mem->L2[i]->placement_time = *t;
-					mem->L2[i]->access_time = *t;
-					if(mem->rep_mode < 2){
-						mem->L1[replace_index]->ref = 1;
-					}else{
-						mem->L2[replace_index]->ref = 0;
-					}
-					mem->L2[i]->ref = 0;
-					mem->L1[replace_index]->dirty = 0;
-					mem->L2[i]->dirty = 1;
-				}
-			}
-			break;
-		case 2: /// `new` is in RAM
-			/// find the spot of `new`
-			for(i = 0; i < RAM_SIZE; i++){
-				if(mem->RAM[i]->page == new){
-					/// switch the places of `old` and `new`
-					mem->RAM[i]->page = old;
-					mem->L1[replace_index]->page = new;
-					*t += RAM_DELAY;
-					mem->L1[replace_index]->access_time = *t;
-					mem->L1[replace_index]->placement_time = *t;
-					*t += RAM_DELAY;
-					mem->RAM[i]->access_time = *t;
-					mem->RAM[i]->placement_time = *t;
-					if(mem->rep_mode < 2){
-						mem->L1[replace_index]->ref = 1;
-					}else{
-						mem->L1[replace_index]->ref = 0;
-					}
-					mem->RAM[i]->ref = 0;
-					mem->L1[replace_index]->dirty = 0;
-					mem->RAM[i]->dirty = 1;
-				}
-			}
-			break;
+		*t += lvl->latency;
+		if(j >= 0 && j != i){
+			isu_mmu_slot_touch(mem, new_level, j, *t);
+			old_dirty |= lvl->dirty[j];
+			isu_mmu_slot_set_page(mem, new_level, i, -1);
+			lvl->access_time[i] = -1;
+			i = j;
+		}else{
+			isu_mmu_slot_set_page(mem, new_level, i, lower_old);
+			lvl->placement_time[i] = *t;
+			isu_mmu_slot_touch(mem, new_level, i, *t);
 		}
+		lvl->ref[i] = 0;
+		lvl->dirty[i] = old_dirty;
+	}
+	if(mem->rep_mode < 2){
+		L1->ref[replace_index] = mem->epoch;
+	}else{
+		L1->ref[replace_index] = 0;
 	}
+	L1->dirty[replace_index] = new_dirty;
 	return 0;
 }
 
-int isu_mmu_page_rep_fifo(isu_mmu_t mem, isu_mem_req_t req, unsigned long long *t){
+int isu_mmu_page_rep_fifo(isu_mmu_t mem, uint64_t addr, int *level, unsigned long long *t){
 	int ret;
-	int new;
 	int old;
-	int i;
+	int victim;
+	unsigned int i;
+	struct ISU_MMU_LEVEL_STRUCT *L1 = &mem->levels[0];
 
-	/// book keeping purposes, copying all the pages in L1 cache
-	for(i = 0; i < L1_SIZE; i++){
-		isu_mem_req_add_page(req, mem->L1[i]->page);
-	}
-	
 	//first, calculate the page the address is in
-	unsigned short addr = isu_mem_req_get_address(req);
-	int page = addr / 4096;
+	int page = addr / L1->page_size;
 
 	//once we have the page number, check if it is in memory
 	//if the page is in L1 cache, it is a hit, otherwise it is a miss
 	//	if it is a miss, but it is still in memory, we swap it out
 	//	if it is not in memory, we have to go fetch it
-	char hit = (char)isu_mmu_page_check(mem, page);
+	int hit = isu_mmu_page_check(mem, addr);
+	*level = hit;
 	/// if `hit` is 0, it is a hit, and that the memory is in L1
 	if(0 == hit){
-		isu_mem_req_set_access_hit(req, 1);
-		for(i = 0; i < L1_SIZE; i++){
-			if(mem->L1[i]->page == page){
-				mem->L1[i]->access_time = *t;
-				mem->L1[i]->ref = 1;
-			}
-		}
+		i = isu_mmu_slot_find(mem, 0, page);
+		isu_mmu_slot_touch(mem, 0, i, *t);
+		L1->ref[i] = mem->epoch;
 		ret = 0;
-	/// if `hit` is 1 then `page` is in L2; if `hit` is 2 then `page` is in RAM
+	/// if `hit` is greater than 0 then `page` is in that lower level
 	}else if(0 < hit){
-		/// the new page to be put in the working set is `page`
-		new = page;
-
 		/// now we figure out which one is to be replaced
 		/// first find the one with the least remaining time
-		unsigned long long temp = mem->L1[0]->placement_time;
-		old = mem->L1[0]->page;
-		for(i = 0; i < L1_SIZE; i++){
-			if(temp > mem->L1[i]->placement_time){
-				temp = mem->L1[i]->placement_time;
-				old = mem->L1[i]->page;
-			}
+		victim = isu_mmu_local_victim(mem, page);
+		if(victim < 0){
+			i = isu_mmu_set_base(mem, 0, page);
+			victim = (int)i + isu_mmu_min_time(L1->placement_time + i, L1->ways);
 		}
-		
+		old = L1->page[victim];
+
 		/// once the loop is complete, we know the `old` page to be replaced with
 		/// the `new` page, and `hit` tells us the which level to look for `new`
-		ret = isu_mmu_page_swap(mem, old, new, hit, t);
+		ret = isu_mmu_page_swap(mem, old, addr, hit, t);
 	}else{
 		/// the page is not in memory, so we have to fetch it
 		ret = isu_mmu_page_fetch(mem, page, t);
@@ -557,58 +2064,42 @@ int isu_mmu_page_rep_fifo(isu_mmu_t mem, isu_mem_req_t req, unsigned long long *
 	return ret;
 }
 
-int isu_mmu_page_rep_lru(isu_mmu_t mem, isu_mem_req_t req, unsigned long long *t){
+int isu_mmu_page_rep_lru(isu_mmu_t mem, uint64_t addr, int *level, unsigned long long *t){
 	/// implement the LRU page replacement algorithm here
-	/// First we want to do some book keeping, copy the elements in L1
-	/// to the memory request class
 	int ret;
-	int new;
 	int old;
-	int i;
+	int victim;
+	unsigned int i;
+	struct ISU_MMU_LEVEL_STRUCT *L1 = &mem->levels[0];
 
-	/// book keeping purposes, copying all the pages in L1 cache
-	for(i = 0; i < L1_SIZE; i++){
-		isu_mem_req_add_page(req, mem->L1[i]->page);
-	}
-	
 	//first, calculate the page the address is in
-	unsigned short addr = isu_mem_req_get_address(req);
-	int page = addr / 4096;
+	int page = addr / L1->page_size;
 
 	//once we have the page number, check if it is in memory
 	//if the page is in L1 cache, it is a hit, otherwise it is a miss
 	//	if it is a miss, but it is still in memory, we swap it out
 	//	if it is not in memory, we have to go fetch it
-	char hit = (char)isu_mmu_page_check(mem, page);
+	int hit = isu_mmu_page_check(mem, addr);
+	*level = hit;
 	/// if `hit` is 0, it is a hit, and that the memory is in L1
 	if(0 == hit){
-		isu_mem_req_set_access_hit(req, 1);
-		for(i = 0; i < L1_SIZE; i++){
-			if(mem->L1[i]->page == page){
-				mem->L1[i]->access_time = *t;
-				mem->L1[i]->ref = 1;
-			}
-		}
+		i = isu_mmu_slot_find(mem, 0, page);
+		isu_mmu_slot_touch(mem, 0, i, *t);
+		L1->ref[i] = mem->epoch;
 		ret = 0;
-	/// if `hit` is 1 then `page` is in L2; if `hit` is 2 then `page` is in RAM
+	/// if `hit` is greater than 0 then `page` is in that lower level
 	}else if(0 < hit){
-		/// the new page to be put in the working set is `page`
-		new = page;
-
 		/// now we figure out which one is to be replaced
-		/// first find the one with the least recently used time
-		unsigned long long temp = mem->L1[0]->access_time;
-		old = mem->L1[0]->page;
-		for(i = 0; i < L1_SIZE; i++){
-			if(temp > mem->L1[i]->access_time){
-				temp = mem->L1[i]->access_time;
-				old = mem->L1[i]->page;
-			}
+		/// it is the one at the tail of the recency list
+		victim = isu_mmu_local_victim(mem, page);
+		if(victim < 0){
+			victim = isu_mmu_slot_lru(mem, 0, page);
 		}
-		
+		old = L1->page[victim];
+
 		/// once the loop is complete, we know the `old` page to be replaced with
 		/// the `new` page, and `hit` tells us the which level to look for `new`
-		ret = isu_mmu_page_swap(mem, old, new, hit, t);
+		ret = isu_mmu_page_swap(mem, old, addr, hit, t);
 	}else{
 		/// the page is not in memory, so we have to fetch it
 		ret = isu_mmu_page_fetch(mem, page, t);
@@ -617,64 +2108,40 @@ int isu_mmu_page_rep_lru(isu_mmu_t mem, isu_mem_req_t req, unsigned long long *t
 	return ret;
 }
 
-int isu_mmu_page_rep_clock(isu_mmu_t mem, isu_mem_req_t req, unsigned long long *t){
+int isu_mmu_page_rep_clock(isu_mmu_t mem, uint64_t addr, int *level, unsigned long long *t){
 	/// implement the clock page replacement algorithm here
-	/// First we want to do some book keeping, copy the elements in L1
-	/// to the memory request class
 	int ret;
-	int new;
 	int old;
-	int i;
+	int victim;
+	unsigned int i;
+	struct ISU_MMU_LEVEL_STRUCT *L1 = &mem->levels[0];
 
-	/// book keeping purposes, copying all the pages in L1 cache
-	for(i = 0; i < L1_SIZE; i++){
-		isu_mem_req_add_page(req, mem->L1[i]->page);
-	}
-	
 	//first, calculate the page the address is in
-	unsigned short addr = isu_mem_req_get_address(req);
-	int page = addr / 4096;
+	int page = addr / L1->page_size;
 
 	//once we have the page number, check if it is in memory
 	//if the page is in L1 cache, it is a hit, otherwise it is a miss
 	//	if it is a miss, but it is still in memory, we swap it out
 	//	if it is not in memory, we have to go fetch it
-	char hit = (char)isu_mmu_page_check(mem, page);
+	int hit = isu_mmu_page_check(mem, addr);
+	*level = hit;
 	/// if `hit` is 0, it is a hit, and that the memory is in L1
 	if(0 == hit){
-		isu_mem_req_set_access_hit(req, 1);
-		for(i = 0; i < L1_SIZE; i++){
-			if(mem->L1[i]->page == page){
-				mem->L1[i]->access_time = *t;
-				mem->L1[i]->ref = 1;
-			}
-		}
+		i = isu_mmu_slot_find(mem, 0, page);
+		isu_mmu_slot_touch(mem, 0, i, *t);
+		L1->ref[i] = mem->epoch;
 		ret = 0;
-	/// if `hit` is 1 then `page` is in L2; if `hit` is 2 then `page` is in RAM
+	/// if `hit` is greater than 0 then `page` is in that lower level
 	}else if(0 < hit){
-		/// the new page to be put in the working set is `page`
-		new = page;
-		
-		while(mem->L1[mem->hand]->ref){
-			// ref bit is 0
-			mem->L1[mem->hand]->ref = 0;
-			
-			// Advance clock pointer
-			mem->hand += 1;
-			// If clock hand is greater than cache size, reset clock hand
-			if(mem->hand >= L1_SIZE){
-				mem->hand = 0;
-			}
+		victim = isu_mmu_local_victim(mem, page);
+		if(victim < 0){
+			victim = isu_mmu_slot_clock(mem, page);
 		}
-		old = mem->L1[mem->hand]->page;
-		mem->hand += 1;
-		if(mem->hand >= L1_SIZE){
-			mem->hand = 0;
-		}
-		
+		old = L1->page[victim];
+
 		/// once the loop is complete, we know the `old` page to be replaced with
 		/// the `new` page, and `hit` tells us the which level to look for `new`
-		ret = isu_mmu_page_swap(mem, old, new, hit, t);
+		ret = isu_mmu_page_swap(mem, old, addr, hit, t);
 	}else{
 		/// the page is not in memory, so we have to fetch it
 		ret = isu_mmu_page_fetch(mem, page, t);
@@ -683,6 +2150,39 @@ int isu_mmu_page_rep_clock(isu_mmu_t mem, isu_mem_req_t req, unsigned long long
 	return ret;
 }
 
-int isu_mmu_page_rep_second_chance(isu_mmu_t mem, isu_mem_req_t req, unsigned long long *t){
-	/// TODO
+int isu_mmu_page_rep_policy(isu_mmu_t mem, uint64_t addr, int *level, unsigned long long *t){
+	/// ARC, 2Q, LIRS and OPT keep their own lists of the pages in L1, the MMU
+	/// tells the policy about every hit and placement, and asks it for the
+	/// page to give up
+	int ret;
+	int slot;
+	struct ISU_MMU_LEVEL_STRUCT *L1 = &mem->levels[0];
+
+	//first, calculate the page the address is in
+	int page = addr / L1->page_size;
+	/// the first slot of the set of `page`, and the policy of that set
+	unsigned int base = isu_mmu_set_base(mem, 0, page);
+	void *obj = mem->policy_obj[base / L1->ways];
+
+	int hit = isu_mmu_page_check(mem, addr);
+	*level = hit;
+	/// if `hit` is 0, it is a hit, and that the memory is in L1
+	if(0 == hit){
+		slot = isu_mmu_slot_find(mem, 0, page);
+		isu_mmu_slot_touch(mem, 0, slot, *t);
+		L1->ref[slot] = mem->epoch;
+		mem->policy->hit(obj, page, slot - base);
+		ret = 0;
+	/// if `hit` is greater than 0 then `page` is in that lower level
+	}else if(0 < hit){
+		/// the swap puts `page` in the slot of the victim
+		slot = mem->policy->victim(obj, page);
+		ret = isu_mmu_page_swap(mem, L1->page[base + slot], addr, hit, t);
+		mem->policy->place(obj, page, slot);
+	}else{
+		/// the page is not in memory, so we have to fetch it
+		ret = isu_mmu_page_fetch(mem, page, t);
+	}
+
+	return ret;
 }
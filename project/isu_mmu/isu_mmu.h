@@ -9,6 +9,8 @@
 #ifndef ISU_MMU_H
 #define ISU_MMU_H
 
+#include <stddef.h>
+#include <stdint.h>
 #include "common/isu_types.h"
 #include "page_req/isu_mem_req.h"
 
@@ -17,17 +19,57 @@
  * @brief	The main memory object
  * @details	The main memory object that emulates the hierarchy and latency of memory of a more modern system
  * 		Assuming that the page size is 4KB and a 16-bit memory space(what is this, 1985?)
+ * 		unless isu_mmu_set_page_tables() gives every process a 64-bit
+ * 		address space of its own
  */
 typedef struct ISU_MMU_STRUCT *isu_mmu_t;
 
+/**
+ * @brief	describes the shape of one level of the memory hierarchy
+ * @details	Level 0 is the level closest to the processor(L1).  Pages that
+ * 		fall out of the last level are gone to disk.
+ */
+typedef struct ISU_MMU_LEVEL_DESC{
+	/// the number of page slots in this level
+	unsigned int capacity;
+
+	/// the delay of reading or writing a page at this level, in nanoseconds
+	unsigned long long latency;
+
+	/// the size of a page at this level, in bytes
+	unsigned int page_size;
+
+	/// the number of slots in each set, 0 for a fully associative level.
+	/// `capacity` / `ways` sets must be a power of two, the set of a page
+	/// is the low bits of its page number
+	unsigned int ways;
+}isu_mmu_level_desc_t;
+
 /**
  * @brief	constructs a new main memory object
  * @param	mode
- * 			
+ * 			the page replacement algorithm to use, 0 for FIFO, 1 for LRU,
+ * 			2 for clock, 3 for ARC, 4 for 2Q, 5 for LIRS and 6 for OPT
  * @return	the main memory of the test system or NULL if a failure occurs
+ * @details	Uses the default hierarchy of a 4 page L1, an 8 page L2 and 32
+ * 		pages of RAM, all with 4KB pages.
  */
 isu_mmu_t isu_mmu_create(int mode);
 
+/**
+ * @brief	constructs a new main memory object with a custom hierarchy
+ * @param	mode
+ * 			the page replacement algorithm to use
+ * @param	levels
+ * 			array describing each level of the hierarchy, starting at L1
+ * @param	n_levels
+ * 			the number of entries in `levels`
+ * @param	disk_latency
+ * 			the delay of fetching a page that is not in any level, in nanoseconds
+ * @return	the main memory of the test system or NULL if a failure occurs
+ */
+isu_mmu_t isu_mmu_create_ex(int mode, const isu_mmu_level_desc_t *levels, int n_levels, unsigned long long disk_latency);
+
 /**
  * @brief	destroys the main memory object
  * @param	mem
@@ -50,12 +92,659 @@ void isu_mmu_destroy(isu_mmu_t mem);
  */
 int isu_mmu_handle_req(isu_mmu_t mem, isu_mem_req_t req, unsigned long long *t);
 
+/**
+ * @brief	where isu_mmu_handle_batch() puts the outcome of each request
+ * @details	Each array is indexed by request and must hold as many entries
+ * 		as requests in the batch.  Any may be NULL if not wanted.
+ */
+typedef struct ISU_MMU_BATCH_RESULT{
+	/// the level each request was found in, 0 being L1, -1 if it came from disk
+	int8_t *level;
+
+	/// the time taken by each request, in nanoseconds
+	unsigned long long *latency;
+
+	/// the size of the page that translated each request
+	unsigned int *page_size;
+
+	/// the time each request was issued, which is when the request before
+	/// it was done unless MSHRs let it go ahead
+	unsigned long long *issue;
+}isu_mmu_batch_result_t;
+
+/**
+ * @brief	handles a batch of memory requests
+ * @param	mem
+ * 			main memory to check in
+ * @param	addrs
+ * 			the address of each request, in order
+ * @param	writes
+ * 			1 for each request that is a write, 0 for a read, NULL if
+ * 			every request is a read
+ * @param	n
+ * 			the number of entries in `addrs`
+ * @param	results
+ * 			where to put the level and latency of each request, may be NULL
+ * @param	t
+ * 			the current time when the first request is to be handled,
+ * 			set to the time the last request was handled
+ * @return	0:
+ * 			requests handled successfully
+ * @return	-1:
+ * 			an error occured in page request handling
+ * @details	Same as calling isu_mmu_handle_req() on each address, clearing
+ * 		the reference bits before each one unless the mode is clock,
+ * 		without creating the memory request objects.  With MSHRs the
+ * 		misses of the batch overlap, see isu_mmu_set_mshrs().
+ *
+ * 		Only the request objects and the copy of L1 each one keeps are
+ * 		saved, the levels do the same work either way, so mmu_bench
+ * 		measures this at about 2 to 3 times as fast per request.
+ */
+int isu_mmu_handle_batch(isu_mmu_t mem, const uint16_t *addrs, const uint8_t *writes, size_t n, isu_mmu_batch_result_t *results, unsigned long long *t);
+
+/**
+ * @brief	handles a batch of memory requests of several processes
+ * @param	mem
+ * 			main memory to check in
+ * @param	asids
+ * 			the address space of each request, NULL if every request is
+ * 			of address space 0
+ * @param	addrs
+ * 			the address of each request, in order
+ * @param	writes
+ * 			1 for each request that is a write, 0 for a read, NULL if
+ * 			every request is a read
+ * @param	n
+ * 			the number of entries in `addrs`
+ * @param	results
+ * 			where to put the level and latency of each request, may be NULL
+ * @param	t
+ * 			the current time when the first request is to be handled,
+ * 			set to the time the last request was handled
+ * @return	0:
+ * 			requests handled successfully
+ * @return	-1:
+ * 			an error occured in page request handling
+ * @details	Same as isu_mmu_handle_batch() with each request going through
+ * 		isu_mmu_access().
+ */
+int isu_mmu_handle_batch64(isu_mmu_t mem, const unsigned int *asids, const uint64_t *addrs, const uint8_t *writes, size_t n,
+			   isu_mmu_batch_result_t *results, unsigned long long *t);
+
+/**
+ * @brief	handles an access of a process
+ * @param	mem
+ * 			main memory to check in
+ * @param	asid
+ * 			the address space(process) of the access
+ * @param	addr
+ * 			the virtual address accessed
+ * @param	write
+ * 			1 if the access is a write, 0 for a read
+ * @param	level
+ * 			set to the level the page was found in, 0 being L1, -1 if it
+ * 			came from disk
+ * @param	t
+ * 			the current time, set to the time the access was handled
+ * @return	0:
+ * 			access handled successfully
+ * @return	-1:
+ * 			`addr` is outside of the memory, or an error occured
+ * @details	Without page tables `asid` is ignored and `addr` is used as it
+ * 		is, so it must be in the 16-bit space of the hierarchy.  With
+ * 		page tables `addr` is looked up in the page table of `asid`,
+ * 		and pages are mapped the first time they are used.
+ */
+int isu_mmu_access(isu_mmu_t mem, unsigned int asid, uint64_t addr, int write, int *level, unsigned long long *t);
+
+/// replacement picks from the pages of every process
+#define ISU_MMU_GLOBAL 0
+/// replacement picks from the pages of the process that faulted once it has
+/// its share of L1
+#define ISU_MMU_LOCAL 1
+
+/**
+ * @brief	gives every address space a page table of its own
+ * @param	mem
+ * 			main memory to add the page tables to
+ * @param	scope
+ * 			ISU_MMU_GLOBAL or ISU_MMU_LOCAL replacement
+ * @return	0:
+ * 			the page tables were set up
+ * @return	-1:
+ * 			`mem` already handled a request, the mode is OPT, local
+ * 			replacement was asked for with a mode other than FIFO, LRU
+ * 			or clock, or the page sizes of the levels don't divide the
+ * 			largest one
+ * @details	Virtual pages are mapped, in blocks of the largest page size
+ * 		of the levels, to the next free block of a backing space the
+ * 		hierarchy works on, the first time they are used.  With local
+ * 		replacement each process gets an equal share of L1 and, once
+ * 		it holds its share, a fault replaces one of its own pages in
+ * 		the set of the new page if it has one there.
+ */
+int isu_mmu_set_page_tables(isu_mmu_t mem, int scope);
+
+/**
+ * @brief	the accesses of one process
+ */
+typedef struct ISU_MMU_PROCESS_STATS{
+	/// the accesses of the process
+	unsigned long long accesses;
+	/// the accesses that missed L1
+	unsigned long long faults;
+	/// the pages of the process in L1
+	unsigned long long resident;
+	/// the blocks mapped by the page table of the process
+	unsigned long long mapped;
+	/// the pages of the process the faults of other processes pushed out
+	/// of L1
+	unsigned long long evicted;
+}isu_mmu_process_stats_t;
+
+/**
+ * @brief	gets the counters of a process
+ * @param	mem
+ * 			main memory the process ran on
+ * @param	asid
+ * 			the address space of the process
+ * @param	stats
+ * 			where to put the counters
+ * @return	0:
+ * 			the counters were found
+ * @return	-1:
+ * 			`mem` has no page tables or `asid` never made an access
+ */
+int isu_mmu_get_process_stats(isu_mmu_t mem, unsigned int asid, isu_mmu_process_stats_t *stats);
+
+/**
+ * @brief	gets the number of processes seen
+ * @param	mem
+ * 			main memory to count the processes of
+ * @return	the number of address spaces that made an access, 0 without
+ * 		page tables
+ */
+unsigned int isu_mmu_process_count(isu_mmu_t mem);
+
+/**
+ * @brief	the write traffic an MMU has seen
+ */
+typedef struct ISU_MMU_WRITE_STATS{
+	/// the number of write requests
+	unsigned long long writes;
+	/// dirty pages evicted from the last level
+	unsigned long long writebacks;
+	/// write-backs that took a new write buffer entry
+	unsigned long long buffered;
+	/// write-backs merged into an entry already waiting in the write buffer
+	unsigned long long coalesced;
+	/// write-backs that had to wait for the write buffer to drain
+	unsigned long long stalls;
+	/// the total time spent waiting for the write buffer
+	unsigned long long stall_time;
+	/// pages fetched out of the write buffer instead of disk
+	unsigned long long buffer_reads;
+}isu_mmu_write_stats_t;
+
+/**
+ * @brief	puts a write buffer between the last level and disk
+ * @param	mem
+ * 			main memory to add the write buffer to
+ * @param	entries
+ * 			the number of pages the buffer holds, 0 to remove the buffer
+ * @return	0:
+ * 			the write buffer was set
+ * @return	-1:
+ * 			an error occured allocating the buffer
+ * @details	Without a write buffer each dirty page evicted from the last
+ * 		level costs a full disk delay.  With one the write is queued
+ * 		and drains in the background, one disk write at a time, and
+ * 		the request only waits when the buffer is full.  Writes of a
+ * 		page already queued are merged, and fetches of a queued page
+ * 		are served from the buffer.
+ */
+int isu_mmu_set_write_buffer(isu_mmu_t mem, unsigned int entries);
+
+/**
+ * @brief	describes a TLB in front of the hierarchy
+ */
+typedef struct ISU_MMU_TLB_DESC{
+	/// the number of translations the TLB holds
+	unsigned int entries;
+
+	/// the number of entries in each set, 0 for a fully associative TLB
+	unsigned int ways;
+
+	/// ISU_TLB_FIFO(0), ISU_TLB_LRU(1) or ISU_TLB_RANDOM(2)
+	int rep_mode;
+
+	/// the delay of a lookup that finds the translation, in nanoseconds
+	unsigned long long hit_latency;
+
+	/// the delay of a lookup that has to fill the translation, in nanoseconds
+	unsigned long long miss_latency;
+}isu_mmu_tlb_desc_t;
+
+/**
+ * @brief	the TLB lookups an MMU has done
+ */
+typedef struct ISU_MMU_TLB_STATS{
+	/// lookups that found the translation
+	unsigned long long hits;
+	/// lookups that had to fill the translation
+	unsigned long long misses;
+}isu_mmu_tlb_stats_t;
+
+/**
+ * @brief	puts a TLB in front of the hierarchy
+ * @param	mem
+ * 			main memory to add the TLB to
+ * @param	desc
+ * 			the shape of the TLB, NULL to remove the TLB
+ * @return	0:
+ * 			the TLB was set
+ * @return	-1:
+ * 			`desc` is not a valid TLB or an error occured allocating it
+ * @details	Every request looks up the L1 page of its address in the TLB
+ * 		before the hierarchy, paying the hit or miss delay of the TLB.
+ * 		Pages leaving the last level lose their translation.
+ */
+int isu_mmu_set_tlb(isu_mmu_t mem, const isu_mmu_tlb_desc_t *desc);
+
+/**
+ * @brief	gets the TLB counters
+ * @param	mem
+ * 			main memory to get the counters of
+ * @param	stats
+ * 			where to put the counters
+ */
+void isu_mmu_get_tlb_stats(isu_mmu_t mem, isu_mmu_tlb_stats_t *stats);
+
+/**
+ * @brief	describes the radix page tables walked on a TLB miss
+ */
+typedef struct ISU_MMU_WALK_DESC{
+	/// the levels of each page table, 2 to 4
+	unsigned int depth;
+
+	/// the entries of the page walk cache of each level above the leaves,
+	/// 0 for no page walk caches
+	unsigned int pwc_entries;
+}isu_mmu_walk_desc_t;
+
+/**
+ * @brief	the page walks an MMU has done
+ */
+typedef struct ISU_MMU_WALK_STATS{
+	/// walks done, one for each translation the TLB didn't have
+	unsigned long long walks;
+	/// page table entries read through the hierarchy
+	unsigned long long reads;
+	/// reads that didn't find the entry in L1
+	unsigned long long read_misses;
+	/// walks that a page walk cache let start below the root
+	unsigned long long pwc_hits;
+	/// reads the page walk caches saved
+	unsigned long long skipped;
+	/// the nanoseconds spent walking
+	unsigned long long time;
+	/// the nodes of every page table
+	unsigned long long nodes;
+}isu_mmu_walk_stats_t;
+
+/**
+ * @brief	walks radix page tables to translate the addresses the TLB misses
+ * @param	mem
+ * 			main memory to walk the page tables of
+ * @param	desc
+ * 			the shape of the tables, NULL to go back to the miss delay of
+ * 			the TLB
+ * @return	0:
+ * 			the walk was set
+ * @return	-1:
+ * 			`mem` has no page tables, already handled a request, `desc`
+ * 			is not valid or an error occured allocating the caches
+ * @details	Each node of a table fills one page of the largest page size
+ * 		with 8 byte entries, and is placed in the backing space of the
+ * 		process the first time a walk needs it.  A walk reads one entry
+ * 		of each level, from the root down, as accesses through the
+ * 		hierarchy, so the nodes compete with the data for the levels
+ * 		and a walk costs whatever those accesses cost.  The page walk
+ * 		cache of a level holds the entries read there lately, and a
+ * 		walk starts below the deepest level whose cache has its entry.
+ * 		A walk replaces the miss delay of the TLB, and without a TLB
+ * 		every request walks.
+ */
+int isu_mmu_set_page_walk(isu_mmu_t mem, const isu_mmu_walk_desc_t *desc);
+
+/**
+ * @brief	gets the page walk counters
+ * @param	mem
+ * 			main memory to get the counters of
+ * @param	stats
+ * 			where to put the counters
+ */
+void isu_mmu_get_walk_stats(isu_mmu_t mem, isu_mmu_walk_stats_t *stats);
+
+/**
+ * @brief	describes the huge pages of the page tables
+ */
+typedef struct ISU_MMU_HUGE_DESC{
+	/// the size of a huge page in bytes, a power of two times the largest
+	/// page size of the levels
+	unsigned int size;
+
+	/// the pages of the largest page size a region of a huge page has to
+	/// use before it is promoted, 1 to promote it on its first use
+	unsigned int promote;
+
+	/// the translations of huge pages a TLB of their own holds, 0 to keep
+	/// them in the TLB of the other pages
+	unsigned int tlb_entries;
+}isu_mmu_huge_desc_t;
+
+/**
+ * @brief	the huge pages an MMU has made and used
+ * @details	The fragmentation of the backing space is the reserved pages
+ * 		that are not `used` along with the `gaps`.
+ */
+typedef struct ISU_MMU_HUGE_STATS{
+	/// regions promoted to a huge page
+	unsigned long long promotions;
+	/// requests translated by a huge page
+	unsigned long long accesses;
+	/// lookups of the translation of a huge page that found it
+	unsigned long long tlb_hits;
+	/// lookups of the translation of a huge page that had to fill it
+	unsigned long long tlb_misses;
+	/// pages of the largest page size reserved for huge pages
+	unsigned long long reserved;
+	/// reserved pages a process used
+	unsigned long long used;
+	/// pages skipped to align the reservations
+	unsigned long long gaps;
+}isu_mmu_huge_stats_t;
+
+/**
+ * @brief	maps the regions processes use enough of with huge pages
+ * @param	mem
+ * 			main memory to add huge pages to
+ * @param	desc
+ * 			the huge pages, NULL for none
+ * @return	0:
+ * 			the huge pages were set
+ * @return	-1:
+ * 			`mem` has no page tables, already handled a request, `desc`
+ * 			is not valid for the levels or the walk, or an error occured
+ * 			allocating the TLB
+ * @details	The first use of an aligned region of the size of a huge page
+ * 		reserves a huge frame of the backing space for it, so its
+ * 		pages are contiguous whenever it is promoted.  Once `promote`
+ * 		pages of the region are in use, one translation covers the
+ * 		whole region, which takes one TLB entry in place of one per
+ * 		page, and a walk of the page table stops at the level whose
+ * 		entries map the size of a huge page.  The levels still move
+ * 		the pages of the region one at a time.  Set after
+ * 		isu_mmu_set_page_walk().
+ */
+int isu_mmu_set_huge_pages(isu_mmu_t mem, const isu_mmu_huge_desc_t *desc);
+
+/**
+ * @brief	gets the huge page counters
+ * @param	mem
+ * 			main memory to get the counters of
+ * @param	stats
+ * 			where to put the counters
+ */
+void isu_mmu_get_huge_stats(isu_mmu_t mem, isu_mmu_huge_stats_t *stats);
+
+/**
+ * @brief	gets the size of the pages of L1
+ * @param	mem
+ * 			main memory to get the page size of
+ * @return	the size of a page of L1, the page that translates a request
+ * 		unless a huge page does
+ */
+unsigned int isu_mmu_get_page_size(isu_mmu_t mem);
+
+/**
+ * @brief	the misses the MSHRs of an MMU held
+ * @details	The memory-level parallelism of a run, the average misses in
+ * 		flight, is `serial_time` over the time the run took.
+ */
+typedef struct ISU_MMU_MSHR_STATS{
+	/// requests that missed L1 and took an MSHR
+	unsigned long long misses;
+	/// requests for a page already on its way, which waited for it
+	unsigned long long merged;
+	/// misses that found every MSHR taken
+	unsigned long long stalls;
+	/// the time spent waiting for an MSHR
+	unsigned long long stall_time;
+	/// the most misses in flight at once
+	unsigned long long peak;
+	/// the time the misses would have taken one after the other
+	unsigned long long serial_time;
+}isu_mmu_mshr_stats_t;
+
+/**
+ * @brief	lets the misses of a batch overlap
+ * @param	mem
+ * 			main memory to add the MSHRs to
+ * @param	entries
+ * 			the most misses in flight at once, 0 to handle one request
+ * 			at a time
+ * @return	0:
+ * 			the MSHRs were set
+ * @return	-1:
+ * 			an error occured allocating the MSHRs
+ * @details	Without MSHRs a request is issued once the one before it is
+ * 		done.  With them a request that misses L1 holds an MSHR for as
+ * 		long as the hierarchy takes to bring its page, in a queue
+ * 		ordered by the time each miss is done, and the next request is
+ * 		issued right away.  Only a miss that finds every MSHR taken
+ * 		waits, for the first one to be done, and a request for a page
+ * 		that is on its way waits for it without an MSHR of its own.
+ * 		Hits are still done before the next request is issued.  The
+ * 		levels take in a page when its miss is issued, so they see the
+ * 		requests in the same order as without MSHRs, but at times that
+ * 		overlap, and modes that order pages by time can pick other
+ * 		victims.  A batch ends when its last miss is done.
+ * 		Requests handled with isu_mmu_handle_req() don't use the MSHRs.
+ */
+int isu_mmu_set_mshrs(isu_mmu_t mem, unsigned int entries);
+
+/**
+ * @brief	gets the MSHR counters
+ * @param	mem
+ * 			main memory to get the counters of
+ * @param	stats
+ * 			where to put the counters
+ */
+void isu_mmu_get_mshr_stats(isu_mmu_t mem, isu_mmu_mshr_stats_t *stats);
+
+/**
+ * @brief	the prefetches an MMU has made
+ * @details	The accuracy of a prefetcher is `useful` / `issued`, and its
+ * 		coverage, the share of L1 misses it saved, is `useful` /
+ * 		(`useful` + `misses`).
+ */
+typedef struct ISU_MMU_PREFETCH_STATS{
+	/// prefetches started
+	unsigned long long issued;
+	/// prefetched pages used by a request
+	unsigned long long useful;
+	/// useful prefetches that a request had to wait for
+	unsigned long long late;
+	/// requests that missed L1 anyway
+	unsigned long long misses;
+}isu_mmu_prefetch_stats_t;
+
+/**
+ * @brief	sets the prefetcher filling L1
+ * @param	mem
+ * 			main memory to add the prefetcher to
+ * @param	kind
+ * 			1 for next pages, 2 for stride, 3 for stream buffers, 0 to
+ * 			remove the prefetcher
+ * @param	degree
+ * 			the most pages prefetched after one request
+ * @return	0:
+ * 			the prefetcher was set
+ * @return	-1:
+ * 			`kind` is not a prefetcher, the mode is OPT, or an error
+ * 			occured allocating the prefetcher
+ * @details	Prefetches run in the background.  Each one takes as long as
+ * 		the page would take to reach L1 on a miss, starting at the
+ * 		request that asked for it, and no request waits for it unless
+ * 		that request is for the page itself.  Arrived pages are placed
+ * 		in L1 by the replacement mode like any other page.
+ */
+int isu_mmu_set_prefetcher(isu_mmu_t mem, int kind, unsigned int degree);
+
+/**
+ * @brief	gets the prefetch counters
+ * @param	mem
+ * 			main memory to get the counters of
+ * @param	stats
+ * 			where to put the counters
+ */
+void isu_mmu_get_prefetch_stats(isu_mmu_t mem, isu_mmu_prefetch_stats_t *stats);
+
+/// the latencies a histogram bucket tells apart within each power of two
+#define ISU_MMU_HIST_SUB 8
+/// the buckets of a latency histogram, enough for any 64-bit latency
+#define ISU_MMU_HIST_BUCKETS 496
+
+/**
+ * @brief	the accesses one level of an MMU has handled
+ * @details	Only L1 takes in pages from the levels below it, on a swap or
+ * 		a fetch from disk, the other levels get theirs from above, so
+ * 		`promotions` is 0 for them.
+ */
+typedef struct ISU_MMU_LEVEL_STATS{
+	/// accesses that found their page in the level
+	unsigned long long hits;
+	/// accesses that looked in the level and went on to the next
+	unsigned long long misses;
+	/// pages the level gave up to the next level, or to disk
+	unsigned long long evictions;
+	/// the evicted pages that were dirty
+	unsigned long long writebacks;
+	/// hits that traded the page with one of L1
+	unsigned long long swaps;
+	/// pages the level took in from below it
+	unsigned long long promotions;
+	/// the latencies of the hits, bucketed as by isu_mmu_hist_bucket()
+	unsigned long long histogram[ISU_MMU_HIST_BUCKETS];
+}isu_mmu_level_stats_t;
+
+/**
+ * @brief	the accesses an MMU has handled and what they took
+ * @details	The latency of an access runs from its issue to its page being
+ * 		in L1, including the TLB and any page walk, but not the time a
+ * 		batch waited for an MSHR.  The percentiles are read off the
+ * 		histogram, so each is the top of its bucket, at most 1 /
+ * 		ISU_MMU_HIST_SUB more than the latency it stands for.
+ */
+typedef struct ISU_MMU_STATS{
+	/// the accesses handled
+	unsigned long long accesses;
+	/// accesses that found their page in no level and read it from disk
+	unsigned long long disk;
+	/// the time taken by all the accesses
+	unsigned long long total_latency;
+	/// the longest access
+	unsigned long long max_latency;
+	/// the latency half, 99% and 99.9% of the accesses took at most
+	unsigned long long p50;
+	unsigned long long p99;
+	unsigned long long p999;
+	/// the latencies of every access, bucketed as by isu_mmu_hist_bucket()
+	unsigned long long histogram[ISU_MMU_HIST_BUCKETS];
+}isu_mmu_stats_t;
+
+/**
+ * @brief	gets the counters and latencies of every access
+ * @param	mem
+ * 			main memory to get the counters of
+ * @param	stats
+ * 			where to put the counters
+ */
+void isu_mmu_get_stats(isu_mmu_t mem, isu_mmu_stats_t *stats);
+
+/**
+ * @brief	gets the counters of one level
+ * @param	mem
+ * 			main memory to get the counters of
+ * @param	level
+ * 			the level, 0 being L1
+ * @param	stats
+ * 			where to put the counters
+ * @return	0:
+ * 			the counters were found
+ * @return	-1:
+ * 			`level` is not one of the levels of `mem`
+ */
+int isu_mmu_get_level_stats(isu_mmu_t mem, int level, isu_mmu_level_stats_t *stats);
+
+/**
+ * @brief	gets the histogram bucket of a latency
+ * @param	latency
+ * 			the latency, in nanoseconds
+ * @return	the bucket, less than ISU_MMU_HIST_BUCKETS
+ * @details	Latencies below ISU_MMU_HIST_SUB get a bucket each, after that
+ * 		each power of two is split into ISU_MMU_HIST_SUB buckets.
+ */
+unsigned int isu_mmu_hist_bucket(unsigned long long latency);
+
+/**
+ * @brief	gets the latency a share of a histogram is at or below
+ * @param	histogram
+ * 			the ISU_MMU_HIST_BUCKETS counts of the histogram
+ * @param	q
+ * 			the share, 0.5 for the median
+ * @return	the top of the bucket the share ends in, 0 if the histogram
+ * 		is empty
+ */
+unsigned long long isu_mmu_hist_percentile(const unsigned long long *histogram, double q);
+
+/**
+ * @brief	gets the write traffic counters
+ * @param	mem
+ * 			main memory to get the counters of
+ * @param	stats
+ * 			where to put the counters
+ */
+void isu_mmu_get_write_stats(isu_mmu_t mem, isu_mmu_write_stats_t *stats);
+
+/**
+ * @brief	gives the MMU every request it will handle, in order
+ * @param	mem
+ * 			main memory that will handle the requests
+ * @param	addrs
+ * 			the address of each request
+ * @param	n
+ * 			the number of entries in `addrs`
+ * @return	0:
+ * 			the requests were taken
+ * @return	-1:
+ * 			the replacement mode does not look ahead, or an error occured
+ * @details	Needed by the OPT(6) mode, which must know when each page is
+ * 		used next.  Requests handled past the end of `addrs`, or that
+ * 		differ from it, are treated as never used again.
+ */
+int isu_mmu_set_future(isu_mmu_t mem, const unsigned short *addrs, unsigned int n);
+
 /**
  * @brief clears the reference bit for all pages
  * @param	mem
  * 			main memory to clear reference bit
  * @return	0:
  * 			reference bits cleared correctly
+ * @details	Starts a new epoch of reference bits rather than clearing every
+ * 		slot, so it takes constant time however large the levels are.
  */
 int isu_mmu_ref_clear(isu_mmu_t mem);
 #endif
@@ -0,0 +1,121 @@
+/**
+ * @file	isu_mmu_2q.c
+ * @brief	2Q page replacement
+ * @details	New pages enter A1in, a FIFO of about a quarter of the slots.
+ * 		Pages pushed out of A1in are remembered in the ghost list A1out.
+ * 		Only a page referenced again while in A1out is promoted to Am, the
+ * 		LRU main list, so a scan passes through A1in without disturbing
+ * 		the hot pages in Am.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "isu_mmu_policy.h"
+#include "isu_slot_list.h"
+#include "isu_ghost_list.h"
+#include "common/isu_error.h"
+
+//-- Prototypes --//
+void *twoq_construct(unsigned int capacity);
+void twoq_destruct(void *this);
+void twoq_hit(void *this, int page, int slot);
+int twoq_victim(void *this, int page);
+void twoq_place(void *this, int page, int slot);
+
+/**
+ * instantiated policy object
+ */
+typedef struct TWOQ_OBJECT_STRUCT{
+	/// the most slots A1in holds before it gives up its pages
+	unsigned int kin;
+	/// resident pages seen once, newest at the head
+	isu_slot_list_t a1in;
+	/// resident hot pages, most recent at the head
+	isu_slot_list_t am;
+	/// pages pushed out of A1in
+	isu_ghost_list_t a1out;
+	/// the page held by each slot
+	int *slot_page;
+	/// the page being placed was found in A1out by twoq_victim()
+	int ghost_hit;
+	/// the page twoq_victim() was called for
+	int ghost_page;
+}twoq_obj_t;
+
+const isu_mmu_policy_t isu_mmu_policy_2q = {
+	twoq_construct,
+	twoq_destruct,
+	twoq_hit,
+	twoq_victim,
+	twoq_place,
+	"2q",
+	NULL
+};
+
+void *twoq_construct(unsigned int capacity){
+	twoq_obj_t *q = calloc(1, sizeof(twoq_obj_t));
+	if(q == NULL){
+		isu_print(PRINT_ERROR, "calloc returned NULL");
+		return NULL;
+	}
+	/// the sizes recommended by the paper, Kin 25% and Kout 50% of the slots
+	q->kin = capacity / 4 ? capacity / 4 : 1;
+	q->a1in = isu_slot_list_create(capacity);
+	q->am = isu_slot_list_create(capacity);
+	q->a1out = isu_ghost_list_create(capacity / 2 ? capacity / 2 : 1);
+	q->slot_page = malloc(capacity * sizeof(int));
+	if(q->a1in == NULL || q->am == NULL || q->a1out == NULL || q->slot_page == NULL){
+		twoq_destruct(q);
+		return NULL;
+	}
+	return q;
+}
+
+void twoq_destruct(void *this){
+	twoq_obj_t *q = this;
+	if(q->a1in) isu_slot_list_destroy(q->a1in);
+	if(q->am) isu_slot_list_destroy(q->am);
+	if(q->a1out) isu_ghost_list_destroy(q->a1out);
+	free(q->slot_page);
+	free(q);
+}
+
+void twoq_hit(void *this, int page, int slot){
+	twoq_obj_t *q = this;
+	(void)page;
+	/// a hit in A1in does nothing, a hit in Am is an LRU hit
+	if(isu_slot_list_contains(q->am, slot)){
+		isu_slot_list_push_head(q->am, slot);
+	}
+}
+
+int twoq_victim(void *this, int page){
+	twoq_obj_t *q = this;
+	int slot;
+	q->ghost_page = page;
+	q->ghost_hit = isu_ghost_list_remove(q->a1out, page);
+	if(isu_slot_list_count(q->a1in) > q->kin || isu_slot_list_count(q->am) == 0){
+		/// page out the oldest page of A1in and remember it in A1out
+		slot = isu_slot_list_pop_tail(q->a1in);
+		isu_ghost_list_push_head(q->a1out, q->slot_page[slot]);
+	}else{
+		/// page out the LRU page of Am, it is not remembered
+		slot = isu_slot_list_pop_tail(q->am);
+	}
+	return slot;
+}
+
+void twoq_place(void *this, int page, int slot){
+	twoq_obj_t *q = this;
+	int hot = q->ghost_hit && q->ghost_page == page;
+	q->ghost_hit = 0;
+	if(!hot){
+		hot = isu_ghost_list_remove(q->a1out, page);
+	}
+	q->slot_page[slot] = page;
+	if(hot){
+		isu_slot_list_push_head(q->am, slot);
+	}else{
+		isu_slot_list_push_head(q->a1in, slot);
+	}
+}
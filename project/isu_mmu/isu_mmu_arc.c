@@ -0,0 +1,161 @@
+/**
+ * @file	isu_mmu_arc.c
+ * @brief	Adaptive Replacement Cache page replacement
+ * @details	Resident pages are split between T1, pages seen once recently,
+ * 		and T2, pages seen at least twice.  The ghost lists B1 and B2
+ * 		remember pages recently evicted from T1 and T2.  A hit in a ghost
+ * 		list moves the target size `p` of T1 towards the list that would
+ * 		have kept the page, which lets ARC resist scans while still
+ * 		adapting to recency.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "isu_mmu_policy.h"
+#include "isu_slot_list.h"
+#include "isu_ghost_list.h"
+#include "common/isu_error.h"
+
+//-- Prototypes --//
+void *arc_construct(unsigned int capacity);
+void arc_destruct(void *this);
+void arc_hit(void *this, int page, int slot);
+int arc_victim(void *this, int page);
+void arc_place(void *this, int page, int slot);
+
+/**
+ * instantiated policy object
+ */
+typedef struct ARC_OBJECT_STRUCT{
+	/// the number of slots
+	unsigned int c;
+	/// the target size of T1
+	unsigned int p;
+	/// resident pages seen once, most recent at the head
+	isu_slot_list_t t1;
+	/// resident pages seen more than once, most recent at the head
+	isu_slot_list_t t2;
+	/// pages evicted from T1
+	isu_ghost_list_t b1;
+	/// pages evicted from T2
+	isu_ghost_list_t b2;
+	/// the page held by each slot
+	int *slot_page;
+	/// the page being placed was found in a ghost list by arc_victim()
+	int ghost_hit;
+	/// the page arc_victim() was called for
+	int ghost_page;
+}arc_obj_t;
+
+const isu_mmu_policy_t isu_mmu_policy_arc = {
+	arc_construct,
+	arc_destruct,
+	arc_hit,
+	arc_victim,
+	arc_place,
+	"arc",
+	NULL
+};
+
+void *arc_construct(unsigned int capacity){
+	arc_obj_t *arc = calloc(1, sizeof(arc_obj_t));
+	if(arc == NULL){
+		isu_print(PRINT_ERROR, "calloc returned NULL");
+		return NULL;
+	}
+	arc->c = capacity;
+	arc->t1 = isu_slot_list_create(capacity);
+	arc->t2 = isu_slot_list_create(capacity);
+	arc->b1 = isu_ghost_list_create(capacity);
+	arc->b2 = isu_ghost_list_create(capacity);
+	arc->slot_page = malloc(capacity * sizeof(int));
+	if(arc->t1 == NULL || arc->t2 == NULL || arc->b1 == NULL || arc->b2 == NULL || arc->slot_page == NULL){
+		arc_destruct(arc);
+		return NULL;
+	}
+	return arc;
+}
+
+void arc_destruct(void *this){
+	arc_obj_t *arc = this;
+	if(arc->t1) isu_slot_list_destroy(arc->t1);
+	if(arc->t2) isu_slot_list_destroy(arc->t2);
+	if(arc->b1) isu_ghost_list_destroy(arc->b1);
+	if(arc->b2) isu_ghost_list_destroy(arc->b2);
+	free(arc->slot_page);
+	free(arc);
+}
+
+void arc_hit(void *this, int page, int slot){
+	arc_obj_t *arc = this;
+	(void)page;
+	/// any hit makes the page frequent
+	isu_slot_list_remove(arc->t1, slot);
+	isu_slot_list_push_head(arc->t2, slot);
+}
+
+/// the REPLACE routine of ARC, evicts from T1 or T2 depending on `p`
+static int arc_replace(arc_obj_t *arc, int in_b2){
+	unsigned int t1 = isu_slot_list_count(arc->t1);
+	int slot;
+	if(t1 >= 1 && ((in_b2 && t1 == arc->p) || t1 > arc->p || isu_slot_list_count(arc->t2) == 0)){
+		slot = isu_slot_list_pop_tail(arc->t1);
+		isu_ghost_list_push_head(arc->b1, arc->slot_page[slot]);
+	}else{
+		slot = isu_slot_list_pop_tail(arc->t2);
+		isu_ghost_list_push_head(arc->b2, arc->slot_page[slot]);
+	}
+	return slot;
+}
+
+int arc_victim(void *this, int page){
+	arc_obj_t *arc = this;
+	unsigned int b1 = isu_ghost_list_count(arc->b1);
+	unsigned int b2 = isu_ghost_list_count(arc->b2);
+	unsigned int delta;
+
+	arc->ghost_page = page;
+	arc->ghost_hit = 0;
+	if(isu_ghost_list_remove(arc->b1, page)){
+		/// recency would have kept the page, grow T1
+		delta = (b1 >= b2) ? 1 : b2 / b1;
+		arc->p = (arc->p + delta > arc->c) ? arc->c : arc->p + delta;
+		arc->ghost_hit = 1;
+		return arc_replace(arc, 0);
+	}
+	if(isu_ghost_list_remove(arc->b2, page)){
+		/// frequency would have kept the page, shrink T1
+		delta = (b2 >= b1) ? 1 : b1 / b2;
+		arc->p = (arc->p > delta) ? arc->p - delta : 0;
+		arc->ghost_hit = 1;
+		return arc_replace(arc, 1);
+	}
+	/// a page that has not been seen recently
+	if(isu_slot_list_count(arc->t1) + b1 >= arc->c){
+		if(isu_slot_list_count(arc->t1) < arc->c){
+			isu_ghost_list_pop_tail(arc->b1);
+			return arc_replace(arc, 0);
+		}
+		/// B1 is empty and T1 is the whole cache, drop the LRU page of T1
+		return isu_slot_list_pop_tail(arc->t1);
+	}
+	if(isu_slot_list_count(arc->t1) + isu_slot_list_count(arc->t2) + b1 + b2 >= 2 * arc->c){
+		isu_ghost_list_pop_tail(arc->b2);
+	}
+	return arc_replace(arc, 0);
+}
+
+void arc_place(void *this, int page, int slot){
+	arc_obj_t *arc = this;
+	int seen = arc->ghost_hit && arc->ghost_page == page;
+	arc->ghost_hit = 0;
+	if(!seen){
+		seen = isu_ghost_list_remove(arc->b1, page) || isu_ghost_list_remove(arc->b2, page);
+	}
+	arc->slot_page[slot] = page;
+	if(seen){
+		isu_slot_list_push_head(arc->t2, slot);
+	}else{
+		isu_slot_list_push_head(arc->t1, slot);
+	}
+}
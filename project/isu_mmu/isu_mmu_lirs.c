@@ -0,0 +1,257 @@
+/**
+ * @file	isu_mmu_lirs.c
+ * @brief	Low Inter-reference Recency Set page replacement
+ * @details	Pages are LIR, pages with a short reuse distance that always stay
+ * 		resident, or HIR.  Only a small part of the slots(1%, at least one
+ * 		slot) holds resident HIR pages, kept in the FIFO queue Q, and the
+ * 		victim is always the front of Q.  The recency stack S holds the
+ * 		LIR pages and the HIR pages seen since the oldest LIR page, resident
+ * 		or not.  A HIR page referenced again while it is in S has a shorter
+ * 		reuse distance than the oldest LIR page and takes its place.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "isu_mmu_policy.h"
+#include "isu_slot_list.h"
+#include "isu_page_index.h"
+#include "common/isu_error.h"
+
+/// a resident page with a short reuse distance
+#define LIR 0
+/// a resident page with a long reuse distance
+#define HIR_RESIDENT 1
+/// a page no longer resident that is remembered in S
+#define HIR_GHOST 2
+
+//-- Prototypes --//
+void *lirs_construct(unsigned int capacity);
+void lirs_destruct(void *this);
+void lirs_hit(void *this, int page, int slot);
+int lirs_victim(void *this, int page);
+void lirs_place(void *this, int page, int slot);
+
+/**
+ * instantiated policy object.  Pages are tracked by nodes, one for every
+ * resident page and for each HIR page remembered in S.
+ */
+typedef struct LIRS_OBJECT_STRUCT{
+	/// the most LIR pages
+	unsigned int lir_max;
+	/// the number of LIR pages
+	unsigned int n_lir;
+	/// the page of each node
+	int *node_page;
+	/// the state of each node
+	char *node_state;
+	/// the slot of each resident node
+	int *node_slot;
+	/// the node of each slot
+	int *slot_node;
+	/// the recency stack, top at the head
+	isu_slot_list_t s;
+	/// the resident HIR pages, the front(next victim) at the tail
+	isu_slot_list_t q;
+	/// the non-resident HIR nodes, oldest at the tail, so the node pool can
+	/// drop the oldest when it runs out
+	isu_slot_list_t ghosts;
+	/// maps a page to its node
+	isu_page_index_t index;
+	/// the nodes not in use
+	int *free_nodes;
+	/// the number of entries in `free_nodes`
+	unsigned int n_free;
+}lirs_obj_t;
+
+const isu_mmu_policy_t isu_mmu_policy_lirs = {
+	lirs_construct,
+	lirs_destruct,
+	lirs_hit,
+	lirs_victim,
+	lirs_place,
+	"lirs",
+	NULL
+};
+
+void *lirs_construct(unsigned int capacity){
+	unsigned int i;
+	/// one node per slot and up to two non-resident pages per slot
+	unsigned int n_nodes = 3 * capacity;
+	unsigned int hir_slots = capacity / 100 ? capacity / 100 : 1;
+	lirs_obj_t *l = calloc(1, sizeof(lirs_obj_t));
+	if(l == NULL){
+		isu_print(PRINT_ERROR, "calloc returned NULL");
+		return NULL;
+	}
+	l->lir_max = capacity > hir_slots ? capacity - hir_slots : 0;
+	l->node_page = malloc(n_nodes * sizeof(int));
+	l->node_state = malloc(n_nodes * sizeof(char));
+	l->node_slot = malloc(n_nodes * sizeof(int));
+	l->slot_node = malloc(capacity * sizeof(int));
+	l->free_nodes = malloc(n_nodes * sizeof(int));
+	l->s = isu_slot_list_create(n_nodes);
+	l->q = isu_slot_list_create(n_nodes);
+	l->ghosts = isu_slot_list_create(n_nodes);
+	l->index = isu_page_index_create(n_nodes);
+	if(l->node_page == NULL || l->node_state == NULL || l->node_slot == NULL ||
+	   l->slot_node == NULL || l->free_nodes == NULL || l->s == NULL ||
+	   l->q == NULL || l->ghosts == NULL || l->index == NULL){
+		lirs_destruct(l);
+		return NULL;
+	}
+	for(i = 0; i < n_nodes; i++){
+		l->free_nodes[i] = n_nodes - 1 - i;
+	}
+	l->n_free = n_nodes;
+	return l;
+}
+
+void lirs_destruct(void *this){
+	lirs_obj_t *l = this;
+	if(l->s) isu_slot_list_destroy(l->s);
+	if(l->q) isu_slot_list_destroy(l->q);
+	if(l->ghosts) isu_slot_list_destroy(l->ghosts);
+	if(l->index) isu_page_index_destroy(l->index);
+	free(l->node_page);
+	free(l->node_state);
+	free(l->node_slot);
+	free(l->slot_node);
+	free(l->free_nodes);
+	free(l);
+}
+
+/// gives node `n` back to the pool
+static void lirs_node_free(lirs_obj_t *l, int n){
+	isu_slot_list_remove(l->s, n);
+	isu_slot_list_remove(l->q, n);
+	isu_slot_list_remove(l->ghosts, n);
+	isu_page_index_remove(l->index, l->node_page[n]);
+	l->free_nodes[l->n_free++] = n;
+}
+
+/// takes a node from the pool for `page`, forgetting the oldest non-resident
+/// page if the pool is empty
+static int lirs_node_alloc(lirs_obj_t *l, int page){
+	int n;
+	if(l->n_free == 0){
+		lirs_node_free(l, isu_slot_list_tail(l->ghosts));
+	}
+	n = l->free_nodes[--l->n_free];
+	l->node_page[n] = page;
+	isu_page_index_insert(l->index, page, n);
+	return n;
+}
+
+/// removes HIR nodes from the bottom of S until the bottom is a LIR page
+static void lirs_prune(lirs_obj_t *l){
+	int n = isu_slot_list_tail(l->s);
+	while(n >= 0 && l->node_state[n] != LIR){
+		isu_slot_list_remove(l->s, n);
+		if(l->node_state[n] == HIR_GHOST){
+			lirs_node_free(l, n);
+		}
+		n = isu_slot_list_tail(l->s);
+	}
+}
+
+/// turns the LIR page at the bottom of S into a resident HIR page while there
+/// are too many LIR pages
+static void lirs_balance(lirs_obj_t *l){
+	int n;
+	while(l->n_lir > l->lir_max){
+		lirs_prune(l);
+		n = isu_slot_list_tail(l->s);
+		if(n < 0){
+			return;
+		}
+		l->node_state[n] = HIR_RESIDENT;
+		l->n_lir--;
+		isu_slot_list_remove(l->s, n);
+		isu_slot_list_push_head(l->q, n);
+		lirs_prune(l);
+	}
+}
+
+/// makes node `n` a LIR page at the top of S
+static void lirs_make_lir(lirs_obj_t *l, int n){
+	isu_slot_list_remove(l->q, n);
+	isu_slot_list_remove(l->ghosts, n);
+	l->node_state[n] = LIR;
+	l->n_lir++;
+	isu_slot_list_push_head(l->s, n);
+	lirs_balance(l);
+}
+
+void lirs_hit(void *this, int page, int slot){
+	lirs_obj_t *l = this;
+	int n = l->slot_node[slot];
+	int was_bottom;
+	(void)page;
+	if(l->node_state[n] == LIR){
+		was_bottom = isu_slot_list_tail(l->s) == n;
+		isu_slot_list_push_head(l->s, n);
+		if(was_bottom){
+			lirs_prune(l);
+		}
+	}else if(isu_slot_list_contains(l->s, n)){
+		/// reused sooner than the oldest LIR page
+		lirs_make_lir(l, n);
+	}else{
+		isu_slot_list_push_head(l->s, n);
+		isu_slot_list_push_head(l->q, n);
+	}
+}
+
+int lirs_victim(void *this, int page){
+	lirs_obj_t *l = this;
+	int n = isu_slot_list_tail(l->q);
+	int slot;
+	(void)page;
+	if(n < 0){
+		/// every slot holds a LIR page, demote the oldest
+		lirs_prune(l);
+		n = isu_slot_list_tail(l->s);
+		l->node_state[n] = HIR_RESIDENT;
+		l->n_lir--;
+		isu_slot_list_remove(l->s, n);
+		lirs_prune(l);
+	}
+	slot = l->node_slot[n];
+	isu_slot_list_remove(l->q, n);
+	l->node_slot[n] = -1;
+	if(isu_slot_list_contains(l->s, n)){
+		/// keep remembering it in S
+		l->node_state[n] = HIR_GHOST;
+		isu_slot_list_push_head(l->ghosts, n);
+	}else{
+		lirs_node_free(l, n);
+	}
+	return slot;
+}
+
+void lirs_place(void *this, int page, int slot){
+	lirs_obj_t *l = this;
+	long long found = isu_page_index_find(l->index, page);
+	int n;
+	if(found >= 0){
+		/// a non-resident HIR page still in S
+		n = (int)found;
+		l->node_slot[n] = slot;
+		l->slot_node[slot] = n;
+		lirs_make_lir(l, n);
+		return;
+	}
+	n = lirs_node_alloc(l, page);
+	l->node_slot[n] = slot;
+	l->slot_node[slot] = n;
+	if(l->n_lir < l->lir_max){
+		/// still filling the LIR set
+		l->node_state[n] = LIR;
+		l->n_lir++;
+		isu_slot_list_push_head(l->s, n);
+	}else{
+		l->node_state[n] = HIR_RESIDENT;
+		isu_slot_list_push_head(l->s, n);
+		isu_slot_list_push_head(l->q, n);
+	}
+}
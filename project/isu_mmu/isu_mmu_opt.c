@@ -0,0 +1,198 @@
+/**
+ * @file	isu_mmu_opt.c
+ * @brief	Belady's optimal(OPT) page replacement
+ * @details	OPT needs the whole request stream up front, given by
+ * 		isu_mmu_set_future().  A backward pass over the stream finds, for
+ * 		every request, the position of the next request to the same page.
+ * 		Each resident page is keyed by that position in a max-heap, so the
+ * 		victim, the page used furthest in the future, is always at the root.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "isu_mmu_policy.h"
+#include "isu_page_index.h"
+#include "common/isu_error.h"
+
+/// the next use of a page that is never used again
+#define NEVER UINT_MAX
+
+//-- Prototypes --//
+void *opt_construct(unsigned int capacity);
+void opt_destruct(void *this);
+void opt_hit(void *this, int page, int slot);
+int opt_victim(void *this, int page);
+void opt_place(void *this, int page, int slot);
+int opt_future(void *this, const int *pages, unsigned int n);
+
+/**
+ * instantiated policy object
+ */
+typedef struct OPT_OBJECT_STRUCT{
+	/// the pages of the request stream
+	int *pages;
+	/// the position of the next request to the same page, for every request
+	unsigned int *next;
+	/// the number of requests in the stream
+	unsigned int n;
+	/// the position of the current request in the stream
+	unsigned int cursor;
+	/// the next use of the page held by each slot
+	unsigned int *slot_next;
+	/// the slots ordered as a max-heap on `slot_next`
+	int *heap;
+	/// the position of each slot in `heap`, -1 if not in the heap
+	int *heap_pos;
+	/// the number of slots in `heap`
+	unsigned int heap_size;
+}opt_obj_t;
+
+const isu_mmu_policy_t isu_mmu_policy_opt = {
+	opt_construct,
+	opt_destruct,
+	opt_hit,
+	opt_victim,
+	opt_place,
+	"opt",
+	opt_future
+};
+
+void *opt_construct(unsigned int capacity){
+	unsigned int i;
+	opt_obj_t *o = calloc(1, sizeof(opt_obj_t));
+	if(o == NULL){
+		isu_print(PRINT_ERROR, "calloc returned NULL");
+		return NULL;
+	}
+	o->slot_next = malloc(capacity * sizeof(unsigned int));
+	o->heap = malloc(capacity * sizeof(int));
+	o->heap_pos = malloc(capacity * sizeof(int));
+	if(o->slot_next == NULL || o->heap == NULL || o->heap_pos == NULL){
+		isu_print(PRINT_ERROR, "malloc returned NULL");
+		opt_destruct(o);
+		return NULL;
+	}
+	for(i = 0; i < capacity; i++){
+		o->heap_pos[i] = -1;
+	}
+	return o;
+}
+
+void opt_destruct(void *this){
+	opt_obj_t *o = this;
+	free(o->pages);
+	free(o->next);
+	free(o->slot_next);
+	free(o->heap);
+	free(o->heap_pos);
+	free(o);
+}
+
+int opt_future(void *this, const int *pages, unsigned int n){
+	opt_obj_t *o = this;
+	unsigned int i;
+	long long last;
+	/// the last position seen of each page, walking backwards
+	isu_page_index_t seen = isu_page_index_create(n);
+
+	free(o->pages);
+	free(o->next);
+	o->pages = malloc(n * sizeof(int));
+	o->next = malloc(n * sizeof(unsigned int));
+	if(seen == NULL || (n && (o->pages == NULL || o->next == NULL))){
+		isu_print(PRINT_ERROR, "malloc returned NULL");
+		if(seen){
+			isu_page_index_destroy(seen);
+		}
+		o->n = 0;
+		return -1;
+	}
+	if(n){
+		memcpy(o->pages, pages, n * sizeof(int));
+	}
+	for(i = n; i-- > 0;){
+		last = isu_page_index_find(seen, pages[i]);
+		o->next[i] = last < 0 ? NEVER : (unsigned int)last;
+		if(last >= 0){
+			isu_page_index_remove(seen, pages[i]);
+		}
+		isu_page_index_insert(seen, pages[i], i);
+	}
+	isu_page_index_destroy(seen);
+	o->n = n;
+	o->cursor = 0;
+	return 0;
+}
+
+/// swaps two entries of the heap
+static void opt_heap_swap(opt_obj_t *o, unsigned int a, unsigned int b){
+	int s = o->heap[a];
+	o->heap[a] = o->heap[b];
+	o->heap[b] = s;
+	o->heap_pos[o->heap[a]] = a;
+	o->heap_pos[o->heap[b]] = b;
+}
+
+/// restores the heap around entry `i` after its key changed
+static void opt_heap_fix(opt_obj_t *o, unsigned int i){
+	unsigned int child;
+	while(i > 0 && o->slot_next[o->heap[(i - 1) / 2]] < o->slot_next[o->heap[i]]){
+		opt_heap_swap(o, i, (i - 1) / 2);
+		i = (i - 1) / 2;
+	}
+	for(;;){
+		child = 2 * i + 1;
+		if(child >= o->heap_size){
+			return;
+		}
+		if(child + 1 < o->heap_size && o->slot_next[o->heap[child + 1]] > o->slot_next[o->heap[child]]){
+			child++;
+		}
+		if(o->slot_next[o->heap[child]] <= o->slot_next[o->heap[i]]){
+			return;
+		}
+		opt_heap_swap(o, i, child);
+		i = child;
+	}
+}
+
+/// consumes the current request for `page`, returns when it is used next
+static unsigned int opt_advance(opt_obj_t *o, int page){
+	unsigned int i = o->cursor++;
+	/// requests beyond or different from the stream are never seen again
+	if(i >= o->n || o->pages[i] != page){
+		return NEVER;
+	}
+	return o->next[i];
+}
+
+void opt_hit(void *this, int page, int slot){
+	opt_obj_t *o = this;
+	o->slot_next[slot] = opt_advance(o, page);
+	opt_heap_fix(o, o->heap_pos[slot]);
+}
+
+int opt_victim(void *this, int page){
+	opt_obj_t *o = this;
+	int slot = o->heap[0];
+	(void)page;
+	o->heap_pos[slot] = -1;
+	o->heap_size--;
+	if(o->heap_size){
+		o->heap[0] = o->heap[o->heap_size];
+		o->heap_pos[o->heap[0]] = 0;
+		opt_heap_fix(o, 0);
+	}
+	return slot;
+}
+
+void opt_place(void *this, int page, int slot){
+	opt_obj_t *o = this;
+	o->slot_next[slot] = opt_advance(o, page);
+	o->heap[o->heap_size] = slot;
+	o->heap_pos[slot] = o->heap_size;
+	o->heap_size++;
+	opt_heap_fix(o, o->heap_pos[slot]);
+}
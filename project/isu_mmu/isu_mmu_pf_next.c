@@ -0,0 +1,59 @@
+/**
+ * @file	isu_mmu_pf_next.c
+ * @brief	next-N-page prefetching
+ * @details	A miss on a page, or the first use of a prefetched page, asks
+ * 		for the `degree` pages following it.  Using a prefetched page
+ * 		keeps a sequential scan running ahead without waiting for the
+ * 		next miss.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "isu_mmu_prefetch.h"
+#include "common/isu_error.h"
+
+//-- Prototypes --//
+void *next_construct(unsigned int degree);
+void next_destruct(void *this);
+unsigned int next_access(void *this, int page, int outcome, int *pages);
+
+/**
+ * instantiated prefetcher object
+ */
+typedef struct NEXT_OBJECT_STRUCT{
+	/// the pages to ask for after a trigger
+	unsigned int degree;
+}next_obj_t;
+
+const isu_mmu_prefetcher_t isu_mmu_prefetch_next = {
+	next_construct,
+	next_destruct,
+	next_access,
+	"next"
+};
+
+void *next_construct(unsigned int degree){
+	next_obj_t *o = calloc(1, sizeof(next_obj_t));
+	if(o == NULL){
+		isu_print(PRINT_ERROR, "calloc returned NULL");
+		return NULL;
+	}
+	o->degree = degree;
+	return o;
+}
+
+void next_destruct(void *this){
+	free(this);
+}
+
+unsigned int next_access(void *this, int page, int outcome, int *pages){
+	next_obj_t *o = this;
+	unsigned int i;
+	if(outcome == ISU_MMU_PREFETCH_HIT){
+		return 0;
+	}
+	for(i = 0; i < o->degree; i++){
+		pages[i] = page + 1 + (int)i;
+	}
+	return o->degree;
+}
@@ -0,0 +1,108 @@
+/**
+ * @file	isu_mmu_pf_stream.c
+ * @brief	stream buffer prefetching(Jouppi)
+ * @details	A miss starts a stream buffer, in place of the least recently
+ * 		used one, that asks for the `degree` pages after the missed
+ * 		page.  Each time a page of a buffer is used the buffer runs one
+ * 		page further ahead, so it stays `degree` pages in front of its
+ * 		stream.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "isu_mmu_prefetch.h"
+#include "common/isu_error.h"
+
+/// the number of stream buffers
+#define STREAM_BUFFERS 4
+
+//-- Prototypes --//
+void *stream_construct(unsigned int degree);
+void stream_destruct(void *this);
+unsigned int stream_access(void *this, int page, int outcome, int *pages);
+
+/// one stream buffer, holding the pages from `head` to `tail`
+struct STREAM_BUFFER{
+	/// the first page of the buffer not yet used, -1 if the buffer is unused
+	int head;
+	/// the last page the buffer asked for
+	int tail;
+	/// when the buffer was last used
+	unsigned long long used;
+};
+
+/**
+ * instantiated prefetcher object
+ */
+typedef struct STREAM_OBJECT_STRUCT{
+	/// the number of pages each buffer runs ahead
+	unsigned int degree;
+	/// the buffers
+	struct STREAM_BUFFER buffers[STREAM_BUFFERS];
+	/// the number of accesses seen
+	unsigned long long clock;
+}stream_obj_t;
+
+const isu_mmu_prefetcher_t isu_mmu_prefetch_stream = {
+	stream_construct,
+	stream_destruct,
+	stream_access,
+	"stream"
+};
+
+void *stream_construct(unsigned int degree){
+	int i;
+	stream_obj_t *o = calloc(1, sizeof(stream_obj_t));
+	if(o == NULL){
+		isu_print(PRINT_ERROR, "calloc returned NULL");
+		return NULL;
+	}
+	o->degree = degree;
+	for(i = 0; i < STREAM_BUFFERS; i++){
+		o->buffers[i].head = -1;
+	}
+	return o;
+}
+
+void stream_destruct(void *this){
+	free(this);
+}
+
+unsigned int stream_access(void *this, int page, int outcome, int *pages){
+	stream_obj_t *o = this;
+	struct STREAM_BUFFER *b;
+	struct STREAM_BUFFER *lru = &o->buffers[0];
+	unsigned int n = 0;
+	int i;
+
+	o->clock++;
+	if(outcome == ISU_MMU_PREFETCH_HIT){
+		return 0;
+	}
+	for(i = 0; i < STREAM_BUFFERS; i++){
+		b = &o->buffers[i];
+		if(b->head >= 0 && page >= b->head && page <= b->tail){
+			/// the buffer moves past `page` and asks for as many new
+			/// pages as it used up
+			b->used = o->clock;
+			while(b->head <= page){
+				b->head++;
+				pages[n++] = ++b->tail;
+			}
+			return n;
+		}
+		if(b->used < lru->used){
+			lru = b;
+		}
+	}
+	if(outcome != ISU_MMU_PREFETCH_MISS || o->degree == 0){
+		return 0;
+	}
+	lru->head = page + 1;
+	lru->tail = page;
+	lru->used = o->clock;
+	while(n < o->degree){
+		pages[n++] = ++lru->tail;
+	}
+	return n;
+}
@@ -0,0 +1,137 @@
+/**
+ * @file	isu_mmu_pf_stride.c
+ * @brief	stride prefetching over several streams
+ * @details	Without program counters to tell streams apart, an access
+ * 		belongs to the stream whose last page is nearest, if that is
+ * 		within STRIDE_WINDOW pages, otherwise it starts a new stream in
+ * 		place of the least recently used one.  A stream that moves by
+ * 		the same stride twice in a row asks for the next `degree` pages
+ * 		along that stride.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "isu_mmu_prefetch.h"
+#include "common/isu_error.h"
+
+/// the number of streams followed at once
+#define STRIDE_STREAMS 8
+/// the furthest, in pages, an access can be from a stream to belong to it
+#define STRIDE_WINDOW 16
+/// the confidence a stream needs before it prefetches
+#define STRIDE_CONFIRM 1
+/// the highest confidence of a stream
+#define STRIDE_MAX_CONF 3
+
+//-- Prototypes --//
+void *stride_construct(unsigned int degree);
+void stride_destruct(void *this);
+unsigned int stride_access(void *this, int page, int outcome, int *pages);
+
+/// one stream of accesses
+struct STRIDE_STREAM{
+	/// the last page of the stream, -1 if the stream is unused
+	int last;
+	/// the distance between the last two pages of the stream
+	int stride;
+	/// how many times in a row the stream repeated `stride`
+	int conf;
+	/// when the stream was last used
+	unsigned long long used;
+};
+
+/**
+ * instantiated prefetcher object
+ */
+typedef struct STRIDE_OBJECT_STRUCT{
+	/// the pages to ask for after a confirmed stride
+	unsigned int degree;
+	/// the streams being followed
+	struct STRIDE_STREAM streams[STRIDE_STREAMS];
+	/// the number of accesses seen
+	unsigned long long clock;
+}stride_obj_t;
+
+const isu_mmu_prefetcher_t isu_mmu_prefetch_stride = {
+	stride_construct,
+	stride_destruct,
+	stride_access,
+	"stride"
+};
+
+void *stride_construct(unsigned int degree){
+	int i;
+	stride_obj_t *o = calloc(1, sizeof(stride_obj_t));
+	if(o == NULL){
+		isu_print(PRINT_ERROR, "calloc returned NULL");
+		return NULL;
+	}
+	o->degree = degree;
+	for(i = 0; i < STRIDE_STREAMS; i++){
+		o->streams[i].last = -1;
+	}
+	return o;
+}
+
+void stride_destruct(void *this){
+	free(this);
+}
+
+unsigned int stride_access(void *this, int page, int outcome, int *pages){
+	stride_obj_t *o = this;
+	struct STRIDE_STREAM *s = NULL;
+	struct STRIDE_STREAM *lru = &o->streams[0];
+	int i;
+	int delta;
+	int best = STRIDE_WINDOW + 1;
+	unsigned int n;
+	/// hits train the streams too, once the prefetches keep ahead of a
+	/// stream its accesses stop missing
+	(void)outcome;
+
+	o->clock++;
+	/// unused streams were never used, so they are the first to be taken
+	for(i = 0; i < STRIDE_STREAMS; i++){
+		if(o->streams[i].used < lru->used){
+			lru = &o->streams[i];
+		}
+		if(o->streams[i].last < 0){
+			continue;
+		}
+		delta = abs(page - o->streams[i].last);
+		if(delta < best){
+			best = delta;
+			s = &o->streams[i];
+		}
+	}
+	/// a new stream takes the place of the least recently used one
+	if(s == NULL){
+		lru->last = page;
+		lru->stride = 0;
+		lru->conf = 0;
+		lru->used = o->clock;
+		return 0;
+	}
+	s->used = o->clock;
+	/// staying on a page says nothing about the stride
+	if(page == s->last){
+		return 0;
+	}
+	delta = page - s->last;
+	if(delta == s->stride){
+		if(s->conf < STRIDE_MAX_CONF){
+			s->conf++;
+		}
+	}else{
+		s->stride = delta;
+		s->conf = 0;
+	}
+	s->last = page;
+	if(s->conf < STRIDE_CONFIRM){
+		return 0;
+	}
+	for(n = 0; n < o->degree; n++){
+		pages[n] = page + s->stride * (int)(n + 1);
+	}
+	return n;
+}
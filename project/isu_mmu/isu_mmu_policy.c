@@ -0,0 +1,17 @@
+/**
+ * @file	isu_mmu_policy.c
+ * @brief	source file of isu_mmu_policy.h
+ */
+
+#include <stdio.h>
+#include "isu_mmu_policy.h"
+
+const isu_mmu_policy_t *isu_mmu_policy_get(int rep_mode){
+	switch(rep_mode){
+	case 3: return &isu_mmu_policy_arc;
+	case 4: return &isu_mmu_policy_2q;
+	case 5: return &isu_mmu_policy_lirs;
+	case 6: return &isu_mmu_policy_opt;
+	default: return NULL;
+	}
+}
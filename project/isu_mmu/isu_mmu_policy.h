@@ -0,0 +1,105 @@
+/**
+ * @file	isu_mmu_policy.h
+ * @brief	interface for page replacement policies of the L1 working set
+ * @details	FIFO, LRU and clock are built into isu_mmu.c.  Other policies
+ * 		implement the function pointers of isu_mmu_policy_t and are
+ * 		picked by their `rep_mode` in isu_mmu_policy_get().  The MMU tells
+ * 		the policy about every hit and placement in L1 and asks it for a
+ * 		victim slot whenever L1 is full.
+ */
+
+#ifndef ISU_MMU_POLICY_H
+#define ISU_MMU_POLICY_H
+
+/**
+ * @class	isu_mmu_policy_t
+ * @brief	an abstract class that new replacement policies can implement
+ */
+typedef struct ISU_MMU_POLICY_CLASS{
+	/**
+	 * @brief	construct a new policy object for a level
+	 * @param	capacity
+	 * 			the number of slots of the level, slots are 0 to capacity-1
+	 * @return	the new policy object or NULL if a failure occurs
+	 */
+	void *(*construct)(unsigned int capacity);
+
+	/**
+	 * @brief	destruct the policy object and free all of its memory
+	 * @param	this
+	 * 			this policy object
+	 */
+	void (*destruct)(void *this);
+
+	/**
+	 * @brief	a page in the level was accessed
+	 * @param	this
+	 * 			this policy object
+	 * @param	page
+	 * 			the page that was accessed
+	 * @param	slot
+	 * 			the slot holding `page`
+	 */
+	void (*hit)(void *this, int page, int slot);
+
+	/**
+	 * @brief	pick the slot to give up to make room for `page`
+	 * @param	this
+	 * 			this policy object
+	 * @param	page
+	 * 			the page that is about to be placed
+	 * @return	the slot whose page will leave the level
+	 * @details	Only called when every slot is used.  The page in the
+	 * 		returned slot is considered gone from the level, and the next
+	 * 		call will be place() with `page` and the returned slot.
+	 */
+	int (*victim)(void *this, int page);
+
+	/**
+	 * @brief	a page was placed in the level
+	 * @param	this
+	 * 			this policy object
+	 * @param	page
+	 * 			the page that was placed
+	 * @param	slot
+	 * 			the slot `page` was placed in
+	 */
+	void (*place)(void *this, int page, int slot);
+
+	/**
+	 * the name of this policy, used to name the output files
+	 */
+	char const *name;
+
+	/**
+	 * @brief	give the policy the pages of every request to come
+	 * @param	this
+	 * 			this policy object
+	 * @param	pages
+	 * 			the L1 page of each request, in order
+	 * @param	n
+	 * 			the number of entries in `pages`
+	 * @return	0 on success, -1 on failure
+	 * @details	Only needed by offline policies, NULL for the others.
+	 */
+	int (*future)(void *this, const int *pages, unsigned int n);
+}isu_mmu_policy_t;
+
+/// Adaptive Replacement Cache(Megiddo and Modha)
+extern const isu_mmu_policy_t isu_mmu_policy_arc;
+/// the full 2Q algorithm(Johnson and Shasha)
+extern const isu_mmu_policy_t isu_mmu_policy_2q;
+/// Low Inter-reference Recency Set(Jiang and Zhang)
+extern const isu_mmu_policy_t isu_mmu_policy_lirs;
+/// Belady's optimal replacement, needs the future requests
+extern const isu_mmu_policy_t isu_mmu_policy_opt;
+
+/**
+ * @brief	gets the policy used for a replacement mode
+ * @param	rep_mode
+ * 			the mode passed to isu_mmu_create()
+ * @return	the policy or NULL if `rep_mode` is one built into the MMU
+ */
+const isu_mmu_policy_t *isu_mmu_policy_get(int rep_mode);
+
+#endif
@@ -0,0 +1,16 @@
+/**
+ * @file	isu_mmu_prefetch.c
+ * @brief	source file of isu_mmu_prefetch.h
+ */
+
+#include <stdio.h>
+#include "isu_mmu_prefetch.h"
+
+const isu_mmu_prefetcher_t *isu_mmu_prefetcher_get(int kind){
+	switch(kind){
+	case 1: return &isu_mmu_prefetch_next;
+	case 2: return &isu_mmu_prefetch_stride;
+	case 3: return &isu_mmu_prefetch_stream;
+	default: return NULL;
+	}
+}
@@ -0,0 +1,82 @@
+/**
+ * @file	isu_mmu_prefetch.h
+ * @brief	interface for prefetchers filling L1 ahead of demand
+ * @details	A prefetcher implements the function pointers of
+ * 		isu_mmu_prefetcher_t and is picked by its kind in
+ * 		isu_mmu_prefetcher_get().  The MMU tells the prefetcher about
+ * 		every demand access and the prefetcher answers with the pages it
+ * 		expects to be used next.  The MMU fetches those in the background
+ * 		and places them in L1 once they arrive.
+ */
+
+#ifndef ISU_MMU_PREFETCH_H
+#define ISU_MMU_PREFETCH_H
+
+/// the page of the access was in L1
+#define ISU_MMU_PREFETCH_HIT 0
+/// the page of the access was not in L1
+#define ISU_MMU_PREFETCH_MISS 1
+/// the page of the access was in L1 because it was prefetched, and this is
+/// its first use
+#define ISU_MMU_PREFETCH_USED 2
+
+/**
+ * @class	isu_mmu_prefetcher_t
+ * @brief	an abstract class that new prefetchers can implement
+ */
+typedef struct ISU_MMU_PREFETCHER_CLASS{
+	/**
+	 * @brief	construct a new prefetcher object
+	 * @param	degree
+	 * 			the most pages to prefetch after one access
+	 * @return	the new prefetcher object or NULL if a failure occurs
+	 */
+	void *(*construct)(unsigned int degree);
+
+	/**
+	 * @brief	destruct the prefetcher object and free all of its memory
+	 * @param	this
+	 * 			this prefetcher object
+	 */
+	void (*destruct)(void *this);
+
+	/**
+	 * @brief	a demand access was made
+	 * @param	this
+	 * 			this prefetcher object
+	 * @param	page
+	 * 			the L1 page that was accessed
+	 * @param	outcome
+	 * 			ISU_MMU_PREFETCH_HIT, ISU_MMU_PREFETCH_MISS or
+	 * 			ISU_MMU_PREFETCH_USED
+	 * @param	pages
+	 * 			where to put the pages to prefetch, room for `degree`
+	 * @return	the number of pages put in `pages`
+	 * @details	The pages may be outside of the address space, or already
+	 * 		in L1 or on their way, the MMU skips those.
+	 */
+	unsigned int (*access)(void *this, int page, int outcome, int *pages);
+
+	/**
+	 * the name of this prefetcher, used in reports
+	 */
+	char const *name;
+}isu_mmu_prefetcher_t;
+
+/// prefetches the next `degree` pages after a miss or the use of a
+/// prefetched page
+extern const isu_mmu_prefetcher_t isu_mmu_prefetch_next;
+/// detects constant strides in several streams of accesses at once
+extern const isu_mmu_prefetcher_t isu_mmu_prefetch_stride;
+/// stream buffers that are started by misses and run ahead of their stream
+extern const isu_mmu_prefetcher_t isu_mmu_prefetch_stream;
+
+/**
+ * @brief	gets a prefetcher
+ * @param	kind
+ * 			1 for next pages, 2 for stride and 3 for stream buffers
+ * @return	the prefetcher or NULL if `kind` is not one
+ */
+const isu_mmu_prefetcher_t *isu_mmu_prefetcher_get(int kind);
+
+#endif
@@ -0,0 +1,129 @@
+/**
+ * @file	isu_mshr.c
+ * @brief	source file of isu_mshr.h
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "isu_mshr.h"
+#include "common/isu_error.h"
+
+/// one miss in flight
+struct ISU_MSHR_ENTRY{
+	/// the time the page arrives
+	unsigned long long ready;
+
+	/// the address space and number of the page
+	unsigned int asid;
+	uint64_t page;
+};
+
+struct ISU_MSHR_STRUCT{
+	/// a binary min-heap of the misses in flight, ordered by `ready`
+	struct ISU_MSHR_ENTRY *heap;
+
+	/// the most entries
+	unsigned int capacity;
+
+	/// the number of entries
+	unsigned int count;
+
+	/// the latest `ready` of the entries
+	unsigned long long last;
+};
+
+isu_mshr_t isu_mshr_create(unsigned int entries){
+	isu_mshr_t mshr;
+	if(entries == 0){
+		isu_print(PRINT_ERROR, "MSHRs need at least one entry");
+		return NULL;
+	}
+	mshr = calloc(1, sizeof(struct ISU_MSHR_STRUCT));
+	if(mshr == NULL){
+		isu_print(PRINT_ERROR, "calloc returned NULL");
+		return NULL;
+	}
+	mshr->capacity = entries;
+	mshr->heap = malloc(entries * sizeof(struct ISU_MSHR_ENTRY));
+	if(mshr->heap == NULL){
+		isu_print(PRINT_ERROR, "malloc returned NULL");
+		isu_mshr_destroy(mshr);
+		return NULL;
+	}
+	return mshr;
+}
+
+void isu_mshr_destroy(isu_mshr_t mshr){
+	free(mshr->heap);
+	free(mshr);
+}
+
+/// takes the entry that is done first off the heap
+static void isu_mshr_pop(isu_mshr_t mshr){
+	unsigned int i = 0;
+	unsigned int j;
+	struct ISU_MSHR_ENTRY e = mshr->heap[--mshr->count];
+	/// the last entry sinks down from the root
+	while((j = 2 * i + 1) < mshr->count){
+		if(j + 1 < mshr->count && mshr->heap[j + 1].ready < mshr->heap[j].ready){
+			j++;
+		}
+		if(e.ready <= mshr->heap[j].ready){
+			break;
+		}
+		mshr->heap[i] = mshr->heap[j];
+		i = j;
+	}
+	mshr->heap[i] = e;
+}
+
+void isu_mshr_retire(isu_mshr_t mshr, unsigned long long now){
+	while(mshr->count && mshr->heap[0].ready <= now){
+		isu_mshr_pop(mshr);
+	}
+}
+
+int isu_mshr_find(isu_mshr_t mshr, unsigned int asid, uint64_t page, unsigned long long *ready){
+	unsigned int i;
+	/// there are few registers, so they are searched in place
+	for(i = 0; i < mshr->count; i++){
+		if(mshr->heap[i].page == page && mshr->heap[i].asid == asid){
+			*ready = mshr->heap[i].ready;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+unsigned long long isu_mshr_add(isu_mshr_t mshr, unsigned int asid, uint64_t page, unsigned long long now,
+				unsigned long long cost){
+	unsigned int i;
+	unsigned int j;
+	isu_mshr_retire(mshr, now);
+	if(mshr->count == mshr->capacity){
+		/// wait for the first miss to be done
+		now = mshr->heap[0].ready;
+		isu_mshr_retire(mshr, now);
+	}
+	/// the new entry rises from the bottom
+	i = mshr->count++;
+	while(i > 0 && mshr->heap[j = (i - 1) / 2].ready > now + cost){
+		mshr->heap[i] = mshr->heap[j];
+		i = j;
+	}
+	mshr->heap[i].ready = now + cost;
+	mshr->heap[i].asid = asid;
+	mshr->heap[i].page = page;
+	if(mshr->last < now + cost){
+		mshr->last = now + cost;
+	}
+	return now;
+}
+
+unsigned int isu_mshr_count(isu_mshr_t mshr){
+	return mshr->count;
+}
+
+unsigned long long isu_mshr_last(isu_mshr_t mshr){
+	return mshr->count ? mshr->last : 0;
+}
@@ -0,0 +1,94 @@
+/**
+ * @file	isu_mshr.h
+ * @brief	miss status holding registers, the misses an MMU has in flight
+ * @details	Each register holds one miss until the time its page arrives.
+ * 		The registers are kept in a queue ordered by that time, so the
+ * 		next one to free up is always at the front.  A request for a
+ * 		page that is already on its way takes no register of its own,
+ * 		it waits for the miss in flight.
+ */
+
+#ifndef ISU_MSHR_H
+#define ISU_MSHR_H
+
+#include <stdint.h>
+
+/**
+ * @class	isu_mshr_t
+ * @brief	a fixed number of registers, queued by the time they free up
+ */
+typedef struct ISU_MSHR_STRUCT *isu_mshr_t;
+
+/**
+ * @brief	constructs new registers
+ * @param	entries
+ * 			the most misses in flight at once
+ * @return	the new registers or NULL if a failure occurs
+ */
+isu_mshr_t isu_mshr_create(unsigned int entries);
+
+/**
+ * @brief	destroys the registers
+ * @param	mshr
+ * 			the registers to destroy
+ */
+void isu_mshr_destroy(isu_mshr_t mshr);
+
+/**
+ * @brief	frees the registers of the misses done by a time
+ * @param	mshr
+ * 			the registers
+ * @param	now
+ * 			the current time
+ */
+void isu_mshr_retire(isu_mshr_t mshr, unsigned long long now);
+
+/**
+ * @brief	looks for a miss of a page in flight
+ * @param	mshr
+ * 			the registers
+ * @param	asid
+ * 			the address space of the page
+ * @param	page
+ * 			the page to look for
+ * @param	ready
+ * 			set to the time the page arrives if it is in flight
+ * @return	1 if the page is in flight, 0 if not
+ */
+int isu_mshr_find(isu_mshr_t mshr, unsigned int asid, uint64_t page, unsigned long long *ready);
+
+/**
+ * @brief	takes a register for a miss
+ * @param	mshr
+ * 			the registers
+ * @param	asid
+ * 			the address space of the page missed
+ * @param	page
+ * 			the page missed
+ * @param	now
+ * 			the time the miss would like to start
+ * @param	cost
+ * 			the time the miss takes once it has a register
+ * @return	the time the miss started, later than `now` if every register
+ * 		was taken and the miss had to wait for the first to free up
+ */
+unsigned long long isu_mshr_add(isu_mshr_t mshr, unsigned int asid, uint64_t page, unsigned long long now,
+				unsigned long long cost);
+
+/**
+ * @brief	gets the number of misses in flight
+ * @param	mshr
+ * 			the registers
+ * @return	the registers taken
+ */
+unsigned int isu_mshr_count(isu_mshr_t mshr);
+
+/**
+ * @brief	gets the time the last miss in flight is done
+ * @param	mshr
+ * 			the registers
+ * @return	the latest time a register frees up, 0 if none is taken
+ */
+unsigned long long isu_mshr_last(isu_mshr_t mshr);
+
+#endif
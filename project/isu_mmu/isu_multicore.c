@@ -0,0 +1,442 @@
+/**
+ * @file	isu_multicore.c
+ * @brief	source file of isu_multicore.h
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sched.h>
+#include "isu_multicore.h"
+#include "isu_mmu_policy.h"
+#include "common/isu_error.h"
+
+/// the times a core looks for its turn before it gives its host CPU away
+#define SPIN_LIMIT 64
+/// the size of a cache line of the host, each bound gets one to itself
+#define LINE_SIZE 64
+
+/// the time a core can't make a shared access before, ULLONG_MAX once the
+/// core is done. Bounds only grow, and each is only written by its core
+struct ISU_MULTICORE_BOUND{
+	unsigned long long t;
+	char pad[LINE_SIZE - sizeof(unsigned long long)];
+};
+
+/// one core and its private L1, the slots of the L1 are stored as parallel
+/// arrays, the slots of set s being s * ways to s * ways + ways - 1
+struct ISU_MULTICORE_CORE{
+	/// the page held by each slot, -1 if the slot is empty
+	long long *page;
+
+	/// dirty bit of each slot
+	char *dirty;
+
+	/// the tick each slot was last used at, or placed at for FIFO
+	unsigned long long *used;
+
+	/// counts the uses of the slots of the core, the slot of a set that
+	/// FIFO or LRU gives up has the lowest tick
+	unsigned long long tick;
+
+	/// reference bit of each slot and the hand of each set, for clock
+	char *ref;
+	unsigned int *hand;
+
+	/// the objects of the policy of the shared levels, one for each set,
+	/// NULL for the modes built into the MMU
+	void **policy_obj;
+
+	/// the counters of the core
+	isu_multicore_stats_t stats;
+
+	/// the requests of the current run, the time it started and how it
+	/// went
+	const isu_multicore_stream_t *stream;
+	unsigned long long start;
+	int ret;
+
+	/// the number of the core, also its address space
+	unsigned int id;
+
+	/// the cores this one belongs to
+	isu_multicore_t mc;
+
+	/// the thread running the core
+	pthread_t thread;
+};
+
+struct ISU_MULTICORE_STRUCT{
+	/// the cores
+	struct ISU_MULTICORE_CORE *cores;
+
+	/// the bound of each core, read by the others to know whose turn it is
+	struct ISU_MULTICORE_BOUND *bounds;
+
+	/// the number of entries in `cores`
+	unsigned int n_cores;
+
+	/// the slots of each private L1, the slots of each set and the number
+	/// of sets, a power of two
+	unsigned int capacity;
+	unsigned int ways;
+	unsigned int sets;
+
+	/// the delay of writing a page to a private L1
+	unsigned long long latency;
+
+	/// the size of a page of the private L1s
+	unsigned int page_size;
+
+	/// the MMU of the shared levels
+	isu_mmu_t shared;
+
+	/// the replacement mode of `shared` and of the private L1s
+	int rep_mode;
+
+	/// the policy of `rep_mode` if it isn't built into the MMU, NULL
+	/// otherwise
+	const isu_mmu_policy_t *policy;
+
+	/// the time an access holds the port of the first shared level, and the
+	/// time the port is free
+	unsigned long long port_latency;
+	unsigned long long port_free;
+};
+
+isu_multicore_t isu_multicore_create(int mode, unsigned int cores, const isu_mmu_level_desc_t *levels, int n_levels,
+				     unsigned long long disk_latency){
+	unsigned int i;
+	unsigned int j;
+	unsigned int ways;
+	isu_multicore_t mc;
+	struct ISU_MULTICORE_CORE *c;
+
+	if(cores == 0 || levels == NULL || n_levels < 2){
+		isu_print(PRINT_ERROR, "cores need a private L1 and at least one shared level");
+		return NULL;
+	}
+	if(levels[0].capacity == 0 || levels[0].page_size == 0){
+		isu_print(PRINT_ERROR, "the private L1 has a capacity or page size of 0");
+		return NULL;
+	}
+	ways = levels[0].ways ? levels[0].ways : levels[0].capacity;
+	if(levels[0].capacity % ways || (levels[0].capacity / ways) & (levels[0].capacity / ways - 1)){
+		isu_print(PRINT_ERROR, "the private L1 can't be split into a power of two sets of %u ways", ways);
+		return NULL;
+	}
+
+	mc = calloc(1, sizeof(struct ISU_MULTICORE_STRUCT));
+	if(mc == NULL){
+		isu_print(PRINT_ERROR, "calloc returned NULL");
+		return NULL;
+	}
+	mc->capacity = levels[0].capacity;
+	mc->ways = ways;
+	mc->sets = mc->capacity / ways;
+	mc->latency = levels[0].latency;
+	mc->page_size = levels[0].page_size;
+	mc->rep_mode = mode;
+	mc->policy = isu_mmu_policy_get(mode);
+	mc->port_latency = levels[1].latency;
+
+	/// every core is an address space of the shared levels
+	mc->shared = isu_mmu_create_ex(mode, levels + 1, n_levels - 1, disk_latency);
+	if(mc->shared == NULL || isu_mmu_set_page_tables(mc->shared, ISU_MMU_GLOBAL) < 0){
+		isu_multicore_destroy(mc);
+		return NULL;
+	}
+	mc->cores = calloc(cores, sizeof(struct ISU_MULTICORE_CORE));
+	mc->bounds = aligned_alloc(LINE_SIZE, cores * sizeof(struct ISU_MULTICORE_BOUND));
+	if(mc->cores == NULL || mc->bounds == NULL){
+		isu_print(PRINT_ERROR, "calloc returned NULL");
+		isu_multicore_destroy(mc);
+		return NULL;
+	}
+	mc->n_cores = cores;
+	for(i = 0; i < cores; i++){
+		c = &mc->cores[i];
+		c->id = i;
+		c->mc = mc;
+		c->page = malloc(mc->capacity * sizeof(long long));
+		c->dirty = calloc(mc->capacity, sizeof(char));
+		c->used = calloc(mc->capacity, sizeof(unsigned long long));
+		c->ref = calloc(mc->capacity, sizeof(char));
+		c->hand = calloc(mc->sets, sizeof(unsigned int));
+		if(mc->policy){
+			c->policy_obj = calloc(mc->sets, sizeof(void *));
+		}
+		if(c->page == NULL || c->dirty == NULL || c->used == NULL || c->ref == NULL || c->hand == NULL ||
+		   (mc->policy && c->policy_obj == NULL)){
+			isu_print(PRINT_ERROR, "malloc returned NULL");
+			isu_multicore_destroy(mc);
+			return NULL;
+		}
+		for(j = 0; j < mc->capacity; j++){
+			c->page[j] = -1;
+		}
+		for(j = 0; mc->policy && j < mc->sets; j++){
+			c->policy_obj[j] = mc->policy->construct(mc->ways);
+			if(c->policy_obj[j] == NULL){
+				isu_print(PRINT_ERROR, "could not construct the %s policy", mc->policy->name);
+				isu_multicore_destroy(mc);
+				return NULL;
+			}
+		}
+	}
+	return mc;
+}
+
+void isu_multicore_destroy(isu_multicore_t mc){
+	unsigned int i;
+	unsigned int j;
+	if(mc == NULL){
+		return;
+	}
+	for(i = 0; mc->cores && i < mc->n_cores; i++){
+		free(mc->cores[i].page);
+		free(mc->cores[i].dirty);
+		free(mc->cores[i].used);
+		free(mc->cores[i].ref);
+		free(mc->cores[i].hand);
+		for(j = 0; mc->cores[i].policy_obj && j < mc->sets; j++){
+			if(mc->cores[i].policy_obj[j]){
+				mc->policy->destruct(mc->cores[i].policy_obj[j]);
+			}
+		}
+		free(mc->cores[i].policy_obj);
+	}
+	free(mc->cores);
+	free(mc->bounds);
+	if(mc->shared){
+		isu_mmu_destroy(mc->shared);
+	}
+	free(mc);
+}
+
+isu_mmu_t isu_multicore_get_shared(isu_multicore_t mc){
+	return mc->shared;
+}
+
+/// sets the bound of core `c`. Everything the core did to the shared levels
+/// before is seen by the core that takes the next turn
+static void isu_multicore_bound(isu_multicore_t mc, const struct ISU_MULTICORE_CORE *c, unsigned long long t){
+	__atomic_store_n(&mc->bounds[c->id].t, t, __ATOMIC_RELEASE);
+}
+
+/// checks if core `c` may make its shared access at time `t`, which it may
+/// once no other core can make one earlier. Ties go to the lower core, so
+/// only one core at a time has its turn
+static int isu_multicore_turn(isu_multicore_t mc, const struct ISU_MULTICORE_CORE *c, unsigned long long t){
+	unsigned int i;
+	unsigned long long bound;
+	for(i = 0; i < mc->n_cores; i++){
+		bound = __atomic_load_n(&mc->bounds[i].t, __ATOMIC_ACQUIRE);
+		if(i != c->id && (bound < t || (bound == t && i < c->id))){
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/// fetches `page` from the shared levels into `slot` of the private L1 of
+/// core `c` at time `t`, writing back the dirty page it replaces. `level`
+/// is set to the level the page was found in, counting the private L1
+static int isu_multicore_fetch(isu_multicore_t mc, struct ISU_MULTICORE_CORE *c, unsigned int slot, long long page,
+			       int *level, unsigned long long *t){
+	int ret = 0;
+	int wb_level;
+	unsigned int spins;
+
+	isu_multicore_bound(mc, c, *t);
+	for(spins = 0; !isu_multicore_turn(mc, c, *t); spins++){
+		if(spins >= SPIN_LIMIT){
+			sched_yield();
+		}
+	}
+	/// the accesses of a miss hold the port of the first shared level
+	/// together
+	if(mc->port_free > *t){
+		c->stats.conflicts++;
+		c->stats.wait_time += mc->port_free - *t;
+		*t = mc->port_free;
+	}
+	mc->port_free = *t + mc->port_latency;
+	if(mc->rep_mode != 2){
+		isu_mmu_ref_clear(mc->shared);
+	}
+	if(c->page[slot] != -1 && c->dirty[slot]){
+		ret = isu_mmu_access(mc->shared, c->id, (uint64_t)c->page[slot] * mc->page_size, 1, &wb_level, t);
+		c->stats.writebacks++;
+		c->stats.shared_accesses++;
+	}
+	if(ret == 0){
+		ret = isu_mmu_access(mc->shared, c->id, (uint64_t)page * mc->page_size, 0, level, t);
+		c->stats.shared_accesses++;
+		if(*level >= 0){
+			(*level)++;
+		}
+		/// and read out of the first shared level
+		*t += mc->port_latency;
+	}
+	isu_multicore_bound(mc, c, *t);
+	return ret;
+}
+
+/// picks the slot of the full set at `base` in the private L1 of core `c`
+/// to give up for `page`, `lru` being the slot of the set with the lowest
+/// tick
+static unsigned int isu_multicore_victim(isu_multicore_t mc, struct ISU_MULTICORE_CORE *c, unsigned int base, long long page,
+					 unsigned int lru){
+	unsigned int *hand = &c->hand[base / mc->ways];
+	unsigned int slot;
+	if(mc->policy){
+		return base + (unsigned int)mc->policy->victim(c->policy_obj[base / mc->ways], (int)page);
+	}
+	if(mc->rep_mode != 2){
+		return lru;
+	}
+	/// the hand passes over the referenced slots, clearing their bits
+	while(c->ref[base + *hand]){
+		c->ref[base + *hand] = 0;
+		*hand = (*hand + 1) % mc->ways;
+	}
+	slot = base + *hand;
+	*hand = (*hand + 1) % mc->ways;
+	return slot;
+}
+
+/// replays the stream of core `arg`
+static void *isu_multicore_core_run(void *arg){
+	size_t i;
+	unsigned int j;
+	unsigned int base;
+	unsigned int slot;
+	int found;
+	int level;
+	long long page;
+	struct ISU_MULTICORE_CORE *c = arg;
+	isu_multicore_t mc = c->mc;
+	const isu_multicore_stream_t *s = c->stream;
+	isu_mmu_batch_result_t *results = s->results;
+	unsigned long long t = c->start;
+	unsigned long long start;
+
+	for(i = 0; i < s->n; i++){
+		/// the cores waiting for their turn learn how far this one got
+		isu_multicore_bound(mc, c, t);
+		start = t;
+		page = (long long)(s->addrs[i] / mc->page_size);
+		base = (unsigned int)(page & (mc->sets - 1)) * mc->ways;
+		/// an empty slot of the set, or else the one with the lowest tick,
+		/// is taken on a miss unless the mode picks another
+		slot = base;
+		found = 0;
+		for(j = base; j < base + mc->ways; j++){
+			if(c->page[j] == page){
+				slot = j;
+				found = 1;
+				break;
+			}
+			if(c->page[slot] != -1 && (c->page[j] == -1 || c->used[j] < c->used[slot])){
+				slot = j;
+			}
+		}
+		level = 0;
+		if(found){
+			c->stats.l1_hits++;
+			if(mc->policy){
+				mc->policy->hit(c->policy_obj[base / mc->ways], (int)page, slot - base);
+			}
+		}else{
+			/// a full set gives up the slot the mode picks
+			if(c->page[slot] != -1){
+				slot = isu_multicore_victim(mc, c, base, page, slot);
+			}
+			if(isu_multicore_fetch(mc, c, slot, page, &level, &t) < 0){
+				c->ret = -1;
+				break;
+			}
+			/// the page is written to the private L1
+			t += mc->latency;
+			c->page[slot] = page;
+			c->dirty[slot] = 0;
+			if(mc->policy){
+				mc->policy->place(c->policy_obj[base / mc->ways], (int)page, slot - base);
+			}
+		}
+		c->stats.accesses++;
+		c->ref[slot] = 1;
+		/// FIFO only ticks when a page is placed
+		if(!found || mc->rep_mode != 0){
+			c->used[slot] = ++c->tick;
+		}
+		if(s->writes && s->writes[i]){
+			c->dirty[slot] = 1;
+		}
+		if(results){
+			if(results->level){
+				results->level[i] = (int8_t)level;
+			}
+			if(results->latency){
+				results->latency[i] = t - start;
+			}
+			if(results->page_size){
+				results->page_size[i] = mc->page_size;
+			}
+			if(results->issue){
+				results->issue[i] = start;
+			}
+		}
+	}
+	c->stats.time = t;
+	/// a core that is done no longer holds the others back
+	isu_multicore_bound(mc, c, ULLONG_MAX);
+	return NULL;
+}
+
+int isu_multicore_run(isu_multicore_t mc, const isu_multicore_stream_t *streams, unsigned long long *t){
+	unsigned int i;
+	unsigned int j;
+	int ret = 0;
+
+	/// every bound is set before any core starts, so none runs ahead of a
+	/// core that wasn't started yet
+	for(i = 0; i < mc->n_cores; i++){
+		mc->cores[i].stream = &streams[i];
+		mc->cores[i].start = *t;
+		mc->bounds[i].t = *t;
+		mc->cores[i].ret = 0;
+	}
+	for(i = 0; i < mc->n_cores; i++){
+		if(pthread_create(&mc->cores[i].thread, NULL, isu_multicore_core_run, &mc->cores[i])){
+			isu_print(PRINT_ERROR, "couldn't start the thread of core %u", i);
+			for(j = i; j < mc->n_cores; j++){
+				isu_multicore_bound(mc, &mc->cores[j], ULLONG_MAX);
+			}
+			ret = -1;
+			break;
+		}
+	}
+	for(j = 0; j < i; j++){
+		pthread_join(mc->cores[j].thread, NULL);
+		if(mc->cores[j].ret < 0){
+			ret = -1;
+		}
+		if(mc->cores[j].stats.time > *t){
+			*t = mc->cores[j].stats.time;
+		}
+	}
+	return ret;
+}
+
+int isu_multicore_get_stats(isu_multicore_t mc, unsigned int core, isu_multicore_stats_t *stats){
+	isu_mmu_process_stats_t ps;
+	if(core >= mc->n_cores){
+		return -1;
+	}
+	*stats = mc->cores[core].stats;
+	stats->evicted = isu_mmu_get_process_stats(mc->shared, core, &ps) < 0 ? 0 : ps.evicted;
+	return 0;
+}
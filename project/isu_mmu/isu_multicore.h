@@ -0,0 +1,144 @@
+/**
+ * @file	isu_multicore.h
+ * @brief	cores with a private L1 each, sharing the rest of a hierarchy
+ * @details	Each core replays a request stream of its own, in an address
+ * 		space of its own, on a host thread of its own.  Requests that
+ * 		find their page in the private L1 of the core never leave the
+ * 		thread.  The rest go to an MMU holding the shared levels, which
+ * 		the cores enter one at a time in the order of their simulated
+ * 		time, so a run gives the same results however the threads are
+ * 		scheduled.  The first shared level has one port, and a core
+ * 		waits while another core's access holds it.
+ *
+ * 		The private L1s are not kept coherent, which only matters if
+ * 		the shared MMU is left without page tables.
+ */
+
+#ifndef ISU_MULTICORE_H
+#define ISU_MULTICORE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "isu_mmu.h"
+
+/**
+ * @class	isu_multicore_t
+ * @brief	the cores and the levels they share
+ */
+typedef struct ISU_MULTICORE_STRUCT *isu_multicore_t;
+
+/**
+ * @brief	the requests of one core
+ */
+typedef struct ISU_MULTICORE_STREAM{
+	/// the address of each request, in order
+	const uint64_t *addrs;
+
+	/// 1 for each request that is a write, NULL if every request is a read
+	const uint8_t *writes;
+
+	/// the number of entries in `addrs`
+	size_t n;
+
+	/// where to put the level and latency of each request, may be NULL.
+	/// The level is 0 for the private L1 and 1 for the first shared level
+	isu_mmu_batch_result_t *results;
+}isu_multicore_stream_t;
+
+/**
+ * @brief	the requests of one core and what they cost
+ */
+typedef struct ISU_MULTICORE_STATS{
+	/// the requests of the core
+	unsigned long long accesses;
+	/// requests that found their page in the private L1
+	unsigned long long l1_hits;
+	/// accesses of the shared levels, the misses and write-backs of the
+	/// private L1
+	unsigned long long shared_accesses;
+	/// dirty pages the private L1 wrote back to the shared levels
+	unsigned long long writebacks;
+	/// shared accesses that found the port taken by another core
+	unsigned long long conflicts;
+	/// the nanoseconds spent waiting for the port
+	unsigned long long wait_time;
+	/// the pages of the core the misses of other cores pushed out of the
+	/// first shared level
+	unsigned long long evicted;
+	/// the time the core handled its last request
+	unsigned long long time;
+}isu_multicore_stats_t;
+
+/**
+ * @brief	constructs the cores and the levels they share
+ * @param	mode
+ * 			the page replacement algorithm of the private L1s and the
+ * 			shared levels, any mode but OPT
+ * @param	cores
+ * 			the number of cores
+ * @param	levels
+ * 			the private L1 of every core, then the shared levels
+ * @param	n_levels
+ * 			the number of entries in `levels`, at least 2
+ * @param	disk_latency
+ * 			the delay of fetching a page that is not in any level, in nanoseconds
+ * @return	the cores or NULL if a failure occurs
+ * @details	Each set of a private L1 replaces its pages by `mode` on its
+ * 		own, the way the sets of the L1 of an MMU do.  As in the levels
+ * 		of an MMU, a hit takes no time and a miss pays for moving the
+ * 		page, out of the first shared level and into the private L1.  The shared levels are an MMU with page tables, and
+ * 		core c makes its accesses as address space c.
+ */
+isu_multicore_t isu_multicore_create(int mode, unsigned int cores, const isu_mmu_level_desc_t *levels, int n_levels,
+				     unsigned long long disk_latency);
+
+/**
+ * @brief	destroys the cores and the levels they share
+ * @param	mc
+ * 			the cores to destroy
+ */
+void isu_multicore_destroy(isu_multicore_t mc);
+
+/**
+ * @brief	gets the MMU of the shared levels
+ * @param	mc
+ * 			the cores
+ * @return	the MMU, to give it a TLB, a write buffer or a prefetcher, or
+ * 		to read its counters.  It belongs to `mc`
+ */
+isu_mmu_t isu_multicore_get_shared(isu_multicore_t mc);
+
+/**
+ * @brief	runs the request stream of every core
+ * @param	mc
+ * 			the cores
+ * @param	streams
+ * 			the requests of each core, one entry per core
+ * @param	t
+ * 			the time every core starts at, set to the time the last core
+ * 			handled its last request
+ * @return	0:
+ * 			every request was handled
+ * @return	-1:
+ * 			a request failed or a thread couldn't be started
+ * @details	Each core starts a thread of its own.  A run can follow an
+ * 		earlier one, the levels keep their pages.
+ */
+int isu_multicore_run(isu_multicore_t mc, const isu_multicore_stream_t *streams, unsigned long long *t);
+
+/**
+ * @brief	gets the counters of a core
+ * @param	mc
+ * 			the cores
+ * @param	core
+ * 			the core to get the counters of
+ * @param	stats
+ * 			where to put the counters
+ * @return	0:
+ * 			the counters were found
+ * @return	-1:
+ * 			`core` is not one of the cores
+ */
+int isu_multicore_get_stats(isu_multicore_t mc, unsigned int core, isu_multicore_stats_t *stats);
+
+#endif
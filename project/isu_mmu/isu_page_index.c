@@ -0,0 +1,186 @@
+/**
+ * @file	isu_page_index.c
+ * @brief	source file of isu_page_index.h
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "isu_page_index.h"
+#include "common/isu_error.h"
+
+/// marks an unused bucket
+#define EMPTY_KEY (-1LL)
+
+struct ISU_PAGE_INDEX_STRUCT{
+	/// the keys of each bucket, EMPTY_KEY if the bucket is unused
+	long long *keys;
+
+	/// the values of each bucket
+	long long *values;
+
+	/// the number of buckets minus one, the number of buckets is a power of 2
+	unsigned long mask;
+
+	/// how far the hash is shifted down to leave log2(buckets) bits
+	int shift;
+
+	/// the number of used buckets
+	unsigned int count;
+};
+
+/// fibonacci hashing of a page number into a bucket
+static unsigned long isu_page_index_hash(isu_page_index_t idx, long long key){
+	return (unsigned long)(((unsigned long long)key * 0x9E3779B97F4A7C15ULL) >> idx->shift);
+}
+
+/// allocates the buckets for an index of `buckets` buckets
+static int isu_page_index_alloc(isu_page_index_t idx, unsigned long buckets){
+	unsigned long i;
+	idx->keys = malloc(buckets * sizeof(long long));
+	idx->values = malloc(buckets * sizeof(long long));
+	if(idx->keys == NULL || idx->values == NULL){
+		isu_print(PRINT_ERROR, "malloc returned NULL");
+		free(idx->keys);
+		free(idx->values);
+		return -1;
+	}
+	for(i = 0; i < buckets; i++){
+		idx->keys[i] = EMPTY_KEY;
+	}
+	idx->mask = buckets - 1;
+	idx->shift = 64;
+	while(buckets > 1){
+		buckets >>= 1;
+		idx->shift--;
+	}
+	idx->count = 0;
+	return 0;
+}
+
+isu_page_index_t isu_page_index_create(unsigned int capacity){
+	unsigned long buckets = 16;
+	isu_page_index_t idx = calloc(1, sizeof(struct ISU_PAGE_INDEX_STRUCT));
+	if(idx == NULL){
+		isu_print(PRINT_ERROR, "calloc returned NULL");
+		return NULL;
+	}
+	/// keep the load factor at or below one half
+	while(buckets < 2UL * capacity){
+		buckets <<= 1;
+	}
+	if(isu_page_index_alloc(idx, buckets)){
+		free(idx);
+		return NULL;
+	}
+	return idx;
+}
+
+void isu_page_index_destroy(isu_page_index_t idx){
+	free(idx->keys);
+	free(idx->values);
+	free(idx);
+}
+
+long long isu_page_index_find(isu_page_index_t idx, long long key){
+	unsigned long i = isu_page_index_hash(idx, key);
+	while(idx->keys[i] != EMPTY_KEY){
+		if(idx->keys[i] == key){
+			return idx->values[i];
+		}
+		i = (i + 1) & idx->mask;
+	}
+	return -1;
+}
+
+/// doubles the number of buckets and rehashes every page
+static int isu_page_index_grow(isu_page_index_t idx){
+	unsigned long i;
+	unsigned long old_buckets = idx->mask + 1;
+	long long *old_keys = idx->keys;
+	long long *old_values = idx->values;
+	if(isu_page_index_alloc(idx, old_buckets * 2)){
+		idx->keys = old_keys;
+		idx->values = old_values;
+		return -1;
+	}
+	for(i = 0; i < old_buckets; i++){
+		if(old_keys[i] != EMPTY_KEY){
+			isu_page_index_insert(idx, old_keys[i], old_values[i]);
+		}
+	}
+	free(old_keys);
+	free(old_values);
+	return 0;
+}
+
+int isu_page_index_insert(isu_page_index_t idx, long long key, long long value){
+	unsigned long i;
+	if(2UL * (idx->count + 1) > idx->mask + 1){
+		if(isu_page_index_grow(idx)){
+			return -1;
+		}
+	}
+	i = isu_page_index_hash(idx, key);
+	while(idx->keys[i] != EMPTY_KEY){
+		if(idx->keys[i] == key){
+			idx->values[i] = value;
+			return 0;
+		}
+		i = (i + 1) & idx->mask;
+	}
+	idx->keys[i] = key;
+	idx->values[i] = value;
+	idx->count++;
+	return 0;
+}
+
+long long isu_page_index_remove(isu_page_index_t idx, long long key){
+	unsigned long i = isu_page_index_hash(idx, key);
+	unsigned long j;
+	unsigned long home;
+	long long value;
+	while(idx->keys[i] != EMPTY_KEY){
+		if(idx->keys[i] == key){
+			break;
+		}
+		i = (i + 1) & idx->mask;
+	}
+	if(idx->keys[i] == EMPTY_KEY){
+		return -1;
+	}
+	value = idx->values[i];
+	idx->count--;
+	/// shift the following entries of the probe sequence back so that no
+	/// tombstones are needed
+	j = i;
+	for(;;){
+		idx->keys[i] = EMPTY_KEY;
+		for(;;){
+			j = (j + 1) & idx->mask;
+			if(idx->keys[j] == EMPTY_KEY){
+				return value;
+			}
+			home = isu_page_index_hash(idx, idx->keys[j]);
+			/// the entry at `j` can move to `i` if its home bucket is not
+			/// cyclically between `i` and `j`
+			if(i <= j ? (home <= i || home > j) : (home <= i && home > j)){
+				break;
+			}
+		}
+		idx->keys[i] = idx->keys[j];
+		idx->values[i] = idx->values[j];
+		i = j;
+	}
+}
+
+unsigned int isu_page_index_count(isu_page_index_t idx){
+	return idx->count;
+}
+
+void isu_page_index_clear(isu_page_index_t idx){
+	unsigned long i;
+	for(i = 0; i <= idx->mask; i++){
+		idx->keys[i] = EMPTY_KEY;
+	}
+	idx->count = 0;
+}
@@ -0,0 +1,83 @@
+/**
+ * @file	isu_page_index.h
+ * @brief	a hash table mapping page numbers to slots
+ * @details	An open addressing hash table with linear probing used by the MMU
+ * 		to find which slot of a level holds a page without scanning
+ * 		the whole level.  Keys must not be negative.
+ */
+
+#ifndef ISU_PAGE_INDEX_H
+#define ISU_PAGE_INDEX_H
+
+/**
+ * @class	isu_page_index_t
+ * @brief	maps a page number to a value, usually the slot holding the page
+ */
+typedef struct ISU_PAGE_INDEX_STRUCT *isu_page_index_t;
+
+/**
+ * @brief	constructs a new page index
+ * @param	capacity
+ * 			the number of entries expected, the index grows past this if needed
+ * @return	the new index or NULL if a failure occurs
+ */
+isu_page_index_t isu_page_index_create(unsigned int capacity);
+
+/**
+ * @brief	destroys a page index
+ * @param	idx
+ * 			the index to destroy
+ */
+void isu_page_index_destroy(isu_page_index_t idx);
+
+/**
+ * @brief	finds the value stored for a page
+ * @param	idx
+ * 			the index to look in
+ * @param	key
+ * 			the page number to look for
+ * @return	the value stored for `key` or -1 if `key` is not in the index
+ */
+long long isu_page_index_find(isu_page_index_t idx, long long key);
+
+/**
+ * @brief	stores a value for a page, replacing any value already stored
+ * @param	idx
+ * 			the index to store in
+ * @param	key
+ * 			the page number
+ * @param	value
+ * 			the value to store for `key`
+ * @return	0:
+ * 			the value was stored
+ * @return	-1:
+ * 			the index could not grow
+ */
+int isu_page_index_insert(isu_page_index_t idx, long long key, long long value);
+
+/**
+ * @brief	removes a page from the index
+ * @param	idx
+ * 			the index to remove from
+ * @param	key
+ * 			the page number to remove
+ * @return	the value that was stored for `key` or -1 if it was not in the index
+ */
+long long isu_page_index_remove(isu_page_index_t idx, long long key);
+
+/**
+ * @brief	gets the number of pages in the index
+ * @param	idx
+ * 			the index
+ * @return	the number of pages stored
+ */
+unsigned int isu_page_index_count(isu_page_index_t idx);
+
+/**
+ * @brief	removes every page from the index
+ * @param	idx
+ * 			the index to clear
+ */
+void isu_page_index_clear(isu_page_index_t idx);
+
+#endif
@@ -0,0 +1,130 @@
+/**
+ * @file	isu_page_table.c
+ * @brief	source file of isu_page_table.h
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include "isu_page_table.h"
+#include "isu_page_index.h"
+#include "common/isu_error.h"
+
+/// the number of pages a table starts with room for
+#define START_PAGES 64
+
+struct ISU_PAGE_TABLE_STRUCT{
+	/// maps each virtual page to its backing page
+	isu_page_index_t map;
+
+	/// the levels of the radix tree, 0 if the table is never walked
+	unsigned int depth;
+
+	/// the bits of the virtual page number each level resolves
+	unsigned int bits;
+
+	/// maps the virtual pages a node covers, shifted down to the node, to
+	/// the number of the node, one index for each level
+	isu_page_index_t level[ISU_PAGE_TABLE_MAX_DEPTH];
+
+	/// the number of nodes made
+	unsigned long long n_nodes;
+};
+
+isu_page_table_t isu_page_table_create(unsigned int depth, unsigned int bits){
+	unsigned int i;
+	isu_page_table_t pt;
+	if(depth > ISU_PAGE_TABLE_MAX_DEPTH || (depth && (bits == 0 || bits > 32 || depth * bits >= 64))){
+		isu_print(PRINT_ERROR, "a radix tree of %u levels of %u bits is not valid", depth, bits);
+		return NULL;
+	}
+	pt = calloc(1, sizeof(struct ISU_PAGE_TABLE_STRUCT));
+	if(pt == NULL){
+		isu_print(PRINT_ERROR, "calloc returned NULL");
+		return NULL;
+	}
+	pt->depth = depth;
+	pt->bits = bits;
+	pt->map = isu_page_index_create(START_PAGES);
+	if(pt->map == NULL){
+		isu_page_table_destroy(pt);
+		return NULL;
+	}
+	for(i = 0; i < depth; i++){
+		pt->level[i] = isu_page_index_create(START_PAGES);
+		if(pt->level[i] == NULL){
+			isu_page_table_destroy(pt);
+			return NULL;
+		}
+	}
+	return pt;
+}
+
+void isu_page_table_destroy(isu_page_table_t pt){
+	unsigned int i;
+	if(pt->map){
+		isu_page_index_destroy(pt->map);
+	}
+	for(i = 0; i < pt->depth; i++){
+		if(pt->level[i]){
+			isu_page_index_destroy(pt->level[i]);
+		}
+	}
+	free(pt);
+}
+
+long long isu_page_table_translate(isu_page_table_t pt, unsigned long long vpn){
+	if(vpn > LLONG_MAX){
+		return -1;
+	}
+	return isu_page_index_find(pt->map, (long long)vpn);
+}
+
+int isu_page_table_map(isu_page_table_t pt, unsigned long long vpn, long long page){
+	if(vpn > LLONG_MAX){
+		isu_print(PRINT_ERROR, "virtual page %llu is too large", vpn);
+		return -1;
+	}
+	return isu_page_index_insert(pt->map, (long long)vpn, page);
+}
+
+unsigned long long isu_page_table_count(isu_page_table_t pt){
+	return isu_page_index_count(pt->map);
+}
+
+int isu_page_table_walk(isu_page_table_t pt, unsigned long long vpn, unsigned int levels, long long *nodes){
+	unsigned int i;
+	long long prefix;
+	if(pt->depth == 0){
+		isu_print(PRINT_ERROR, "the page table is not a radix tree");
+		return -1;
+	}
+	if(levels == 0 || levels > pt->depth){
+		isu_print(PRINT_ERROR, "a walk of a %u level table can't read %u levels", pt->depth, levels);
+		return -1;
+	}
+	if(vpn >> (pt->depth * pt->bits)){
+		isu_print(PRINT_ERROR, "virtual page %llu is beyond the reach of a %u level table", vpn, pt->depth);
+		return -1;
+	}
+	for(i = 0; i < levels; i++){
+		/// the node of level i covers every page with the same high bits
+		prefix = (long long)(vpn >> ((pt->depth - i) * pt->bits));
+		nodes[i] = isu_page_index_find(pt->level[i], prefix);
+		if(nodes[i] < 0){
+			if(isu_page_index_insert(pt->level[i], prefix, (long long)pt->n_nodes) < 0){
+				return -1;
+			}
+			nodes[i] = (long long)pt->n_nodes++;
+		}
+	}
+	return (int)levels;
+}
+
+unsigned int isu_page_table_entry(isu_page_table_t pt, unsigned long long vpn, unsigned int level){
+	return (unsigned int)((vpn >> ((pt->depth - 1 - level) * pt->bits)) & ((1ULL << pt->bits) - 1));
+}
+
+unsigned long long isu_page_table_nodes(isu_page_table_t pt){
+	return pt->n_nodes;
+}
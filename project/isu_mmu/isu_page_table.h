@@ -0,0 +1,120 @@
+/**
+ * @file	isu_page_table.h
+ * @brief	the page table of one process
+ * @details	Maps the virtual pages of a process to the pages backing them.
+ * 		The MMU gives every process a table of its own, so the same
+ * 		virtual address in two processes is two different pages.
+ *
+ * 		A table can also have the shape of a radix tree, the way the
+ * 		tables of a real processor are laid out.  Each node resolves
+ * 		`bits` bits of the virtual page number, the root the highest,
+ * 		and only the nodes some mapped page needs exist, so a sparse
+ * 		address space needs more nodes than a dense one of the same
+ * 		size.  The tree only tells which nodes a walk reads, the
+ * 		mapping itself is always looked up directly.
+ */
+
+#ifndef ISU_PAGE_TABLE_H
+#define ISU_PAGE_TABLE_H
+
+/**
+ * @class	isu_page_table_t
+ * @brief	the mapping of the virtual pages of one process
+ */
+typedef struct ISU_PAGE_TABLE_STRUCT *isu_page_table_t;
+
+/// the most levels of a radix tree
+#define ISU_PAGE_TABLE_MAX_DEPTH 4
+
+/**
+ * @brief	constructs a new, empty page table
+ * @param	depth
+ * 			the levels of the radix tree, up to ISU_PAGE_TABLE_MAX_DEPTH,
+ * 			0 for a table that is never walked
+ * @param	bits
+ * 			the bits of the virtual page number each level resolves
+ * @return	the new page table or NULL if the shape is not valid or a
+ * 		failure occurs
+ */
+isu_page_table_t isu_page_table_create(unsigned int depth, unsigned int bits);
+
+/**
+ * @brief	destroys a page table
+ * @param	pt
+ * 			the page table to destroy
+ */
+void isu_page_table_destroy(isu_page_table_t pt);
+
+/**
+ * @brief	finds the page backing a virtual page
+ * @param	pt
+ * 			the page table
+ * @param	vpn
+ * 			the virtual page number
+ * @return	the backing page or -1 if `vpn` is not mapped
+ */
+long long isu_page_table_translate(isu_page_table_t pt, unsigned long long vpn);
+
+/**
+ * @brief	maps a virtual page
+ * @param	pt
+ * 			the page table
+ * @param	vpn
+ * 			the virtual page number, at most 2^63 - 1
+ * @param	page
+ * 			the page backing `vpn`, must not be negative
+ * @return	0:
+ * 			the page was mapped
+ * @return	-1:
+ * 			`vpn` is too large or the table could not grow
+ */
+int isu_page_table_map(isu_page_table_t pt, unsigned long long vpn, long long page);
+
+/**
+ * @brief	gets the number of mapped pages
+ * @param	pt
+ * 			the page table
+ * @return	the number of virtual pages mapped
+ */
+unsigned long long isu_page_table_count(isu_page_table_t pt);
+
+/**
+ * @brief	finds the nodes of the radix tree a walk of a virtual page reads
+ * @param	pt
+ * 			the page table
+ * @param	vpn
+ * 			the virtual page number
+ * @param	levels
+ * 			the levels to walk from the root, fewer than the depth of
+ * 			the tree when an entry above the leaves maps a huge page
+ * @param	nodes
+ * 			set to the node read at each level, the root first.  Nodes
+ * 			are numbered from 0 in the order they were made, and the
+ * 			ones the walk needs that didn't exist yet are made
+ * @return	`levels`, or -1 if the table is never walked, `levels` is
+ * 		not 1 to the depth, `vpn` is beyond the reach of the tree or
+ * 		a failure occurs
+ */
+int isu_page_table_walk(isu_page_table_t pt, unsigned long long vpn, unsigned int levels, long long *nodes);
+
+/**
+ * @brief	gets the entry of its node a walk reads at one level
+ * @param	pt
+ * 			the page table
+ * @param	vpn
+ * 			the virtual page number
+ * @param	level
+ * 			the level of the node, 0 for the root
+ * @return	the index of the entry in the node
+ */
+unsigned int isu_page_table_entry(isu_page_table_t pt, unsigned long long vpn, unsigned int level);
+
+/**
+ * @brief	gets the number of nodes of the radix tree
+ * @param	pt
+ * 			the page table
+ * @return	the number of nodes made by walks so far
+ */
+unsigned long long isu_page_table_nodes(isu_page_table_t pt);
+
+#endif
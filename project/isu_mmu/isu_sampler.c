@@ -0,0 +1,130 @@
+/**
+ * @file	isu_sampler.c
+ * @brief	source file of isu_sampler.h
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "isu_sampler.h"
+#include "common/isu_error.h"
+
+/// the normal quantile of a 95% confidence interval
+#define Z_95 1.96
+
+struct ISU_SAMPLER_STRUCT{
+	/// one page in `rate` is sampled
+	unsigned int rate;
+	/// mixed into every page before it is hashed
+	uint64_t seed;
+	/// pages hashing below this are sampled
+	uint64_t threshold;
+
+	/// the sampled requests of each group and the ones found in each level
+	unsigned long long requests[ISU_SAMPLER_GROUPS];
+	unsigned long long found[ISU_SAMPLER_GROUPS][ISU_SAMPLER_LEVELS];
+};
+
+/// the finalizer of splitmix64, every bit of `x` moves every bit of the hash
+static uint64_t mix(uint64_t x){
+	x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+	return x ^ (x >> 31);
+}
+
+isu_sampler_t isu_sampler_create(unsigned int rate, uint64_t seed){
+	isu_sampler_t s;
+	if(rate == 0){
+		isu_print(PRINT_ERROR, "the rate of a sampler must be at least 1");
+		return NULL;
+	}
+	s = calloc(1, sizeof(struct ISU_SAMPLER_STRUCT));
+	if(s == NULL){
+		isu_print(PRINT_ERROR, "calloc returned NULL");
+		return NULL;
+	}
+	s->rate = rate;
+	s->seed = mix(seed + 0x9E3779B97F4A7C15ULL);
+	s->threshold = rate == 1 ? UINT64_MAX : UINT64_MAX / rate;
+	return s;
+}
+
+void isu_sampler_destroy(isu_sampler_t s){
+	free(s);
+}
+
+int isu_sampler_group(isu_sampler_t s, uint64_t page){
+	uint64_t h = mix(page ^ s->seed);
+	if(h > s->threshold){
+		return -1;
+	}
+	/// the sampled hashes are all small, so the group comes from a second
+	/// round of the hash
+	return (int)(mix(h) % ISU_SAMPLER_GROUPS);
+}
+
+unsigned int isu_sampler_scale(isu_sampler_t s, unsigned int entries, unsigned int ways){
+	unsigned int scaled;
+	unsigned int sets;
+	unsigned int pow2 = 1;
+	if(entries == 0){
+		return 0;
+	}
+	scaled = (unsigned int)(((unsigned long long)entries + s->rate / 2) / s->rate);
+	if(ways == 0){
+		return scaled < 1 ? 1 : scaled;
+	}
+	/// a set associative level needs a power of two sets, the nearest one
+	/// to the scaled number of sets is taken
+	sets = (scaled + ways / 2) / ways;
+	while(pow2 <= sets / 2){
+		pow2 *= 2;
+	}
+	if(sets - pow2 > 2 * pow2 - sets){
+		pow2 *= 2;
+	}
+	return pow2 * ways;
+}
+
+void isu_sampler_record(isu_sampler_t s, int group, int level){
+	s->requests[group]++;
+	if(level >= 0){
+		s->found[group][level < ISU_SAMPLER_LEVELS ? level : ISU_SAMPLER_LEVELS - 1]++;
+	}
+}
+
+/// the sampled requests of `group` that missed `level`
+static unsigned long long group_misses(isu_sampler_t s, int group, int level){
+	unsigned long long misses = s->requests[group];
+	int l;
+	for(l = 0; l <= level && l < ISU_SAMPLER_LEVELS; l++){
+		misses -= s->found[group][l];
+	}
+	return misses;
+}
+
+void isu_sampler_get_estimate(isu_sampler_t s, int level, isu_sampler_estimate_t *est){
+	int g;
+	int groups = 0;
+	double d;
+	double sum = 0;
+	est->requests = 0;
+	est->misses = 0;
+	for(g = 0; g < ISU_SAMPLER_GROUPS; g++){
+		est->requests += s->requests[g];
+		est->misses += group_misses(s, g, level);
+		groups += s->requests[g] != 0;
+	}
+	est->ratio = est->requests ? (double)est->misses / (double)est->requests : 0.;
+	est->error = -1.;
+	if(groups < 2){
+		return;
+	}
+	/// the variance of a ratio over a sample of clusters, each group being
+	/// a cluster of the misses and requests of its pages
+	for(g = 0; g < ISU_SAMPLER_GROUPS; g++){
+		d = (double)group_misses(s, g, level) - est->ratio * (double)s->requests[g];
+		sum += d * d;
+	}
+	est->error = Z_95 * sqrt(sum * groups / (groups - 1)) / (double)est->requests;
+}
@@ -0,0 +1,118 @@
+/**
+ * @file	isu_sampler.h
+ * @brief	spatial sampling of the pages of a stream of requests
+ * @details	A page is sampled if a hash of its number falls under a
+ * 		threshold, so either every request to a page is simulated or none
+ * 		is, and a hierarchy with each capacity divided by the rate sees
+ * 		about the same hits and misses as the full one would on the
+ * 		requests it gets.  This is the SHARDS sampling of Waldspurger et
+ * 		al., "Efficient MRC Construction with SHARDS", applied to the
+ * 		whole hierarchy instead of a single LRU stack.
+ *
+ * 		The sampled pages are split into ISU_SAMPLER_GROUPS groups by
+ * 		more bits of the hash.  How much the miss ratio of each group
+ * 		strays from the whole gives the error of the estimate due to
+ * 		which pages were sampled, as for any ratio over a sample of
+ * 		clusters.  The error of scaling the capacities down isn't
+ * 		included, and grows as the scaled capacities get smaller.
+ */
+
+#ifndef ISU_SAMPLER_H
+#define ISU_SAMPLER_H
+
+#include <stdint.h>
+
+/// the groups the sampled pages are split into to measure the error
+#define ISU_SAMPLER_GROUPS 32
+/// the levels counted, a request found in a deeper one counts as the last
+#define ISU_SAMPLER_LEVELS 4
+
+/**
+ * @class	isu_sampler_t
+ * @brief	the sampled pages and what their requests found
+ */
+typedef struct ISU_SAMPLER_STRUCT *isu_sampler_t;
+
+/**
+ * @brief	an estimate of a miss ratio from the sampled requests
+ */
+typedef struct ISU_SAMPLER_ESTIMATE{
+	/// the requests that were sampled
+	unsigned long long requests;
+	/// the sampled requests that missed
+	unsigned long long misses;
+	/// the estimated miss ratio
+	double ratio;
+	/// half the width of the 95% confidence interval of `ratio`, -1 if
+	/// fewer than 2 groups were sampled so it can't be told
+	double error;
+}isu_sampler_estimate_t;
+
+/**
+ * @brief	constructs a sampler
+ * @param	rate
+ * 			one page in `rate` is sampled, at least 1
+ * @param	seed
+ * 			the seed of the hash, samplers of the same seed and rate
+ * 			pick the same pages
+ * @return	the sampler or NULL if a failure occurs
+ */
+isu_sampler_t isu_sampler_create(unsigned int rate, uint64_t seed);
+
+/**
+ * @brief	destroys a sampler
+ * @param	s
+ * 			the sampler to destroy
+ */
+void isu_sampler_destroy(isu_sampler_t s);
+
+/**
+ * @brief	finds out whether a page is sampled
+ * @param	s
+ * 			the sampler
+ * @param	page
+ * 			the page, with anything that tells address spaces apart
+ * 			mixed in
+ * @return	the group of the page, or -1 if it isn't sampled
+ */
+int isu_sampler_group(isu_sampler_t s, uint64_t page);
+
+/**
+ * @brief	scales a capacity down by the rate
+ * @param	s
+ * 			the sampler
+ * @param	entries
+ * 			the capacity of the full hierarchy
+ * @param	ways
+ * 			the slots of each set, 0 for a fully associative level
+ * @return	the capacity for the sampled requests, at least 1, or 0 if
+ * 		`entries` is 0.  With `ways` it is `ways` times the power of two
+ * 		nearest to the scaled number of sets
+ */
+unsigned int isu_sampler_scale(isu_sampler_t s, unsigned int entries, unsigned int ways);
+
+/**
+ * @brief	counts a sampled request
+ * @param	s
+ * 			the sampler
+ * @param	group
+ * 			the group of its page, as isu_sampler_group() gave
+ * @param	level
+ * 			the level it was found in, 0 being L1, -1 for disk
+ */
+void isu_sampler_record(isu_sampler_t s, int group, int level);
+
+/**
+ * @brief	estimates the miss ratio of a level
+ * @param	s
+ * 			the sampler
+ * @param	level
+ * 			the level, the misses being the requests not found in it or
+ * 			above it, so the deepest level gives the requests that went
+ * 			to disk
+ * @param	est
+ * 			where to put the estimate
+ */
+void isu_sampler_get_estimate(isu_sampler_t s, int level, isu_sampler_estimate_t *est);
+
+#endif
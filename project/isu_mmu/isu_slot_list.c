@@ -0,0 +1,152 @@
+/**
+ * @file	isu_slot_list.c
+ * @brief	source file of isu_slot_list.h
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "isu_slot_list.h"
+#include "common/isu_error.h"
+
+/// marks the end of the list
+#define NIL (-1)
+/// marks a slot that is not in the list
+#define NOT_LINKED (-2)
+
+struct ISU_SLOT_LIST_STRUCT{
+	/// the slot before each slot, towards the head
+	int *prev;
+
+	/// the slot after each slot, towards the tail
+	int *next;
+
+	/// the most recently pushed slot
+	int head;
+
+	/// the oldest slot
+	int tail;
+
+	/// the number of slots in the list
+	unsigned int count;
+
+	/// the number of slots that can be in the list
+	unsigned int n;
+};
+
+isu_slot_list_t isu_slot_list_create(unsigned int n){
+	isu_slot_list_t list = calloc(1, sizeof(struct ISU_SLOT_LIST_STRUCT));
+	if(list == NULL){
+		isu_print(PRINT_ERROR, "calloc returned NULL");
+		return NULL;
+	}
+	list->prev = malloc(n * sizeof(int));
+	list->next = malloc(n * sizeof(int));
+	if(list->prev == NULL || list->next == NULL){
+		isu_print(PRINT_ERROR, "malloc returned NULL");
+		isu_slot_list_destroy(list);
+		return NULL;
+	}
+	list->n = n;
+	isu_slot_list_clear(list);
+	return list;
+}
+
+void isu_slot_list_destroy(isu_slot_list_t list){
+	free(list->prev);
+	free(list->next);
+	free(list);
+}
+
+void isu_slot_list_remove(isu_slot_list_t list, int i){
+	if(list->prev[i] == NOT_LINKED){
+		return;
+	}
+	if(list->prev[i] == NIL){
+		list->head = list->next[i];
+	}else{
+		list->next[list->prev[i]] = list->next[i];
+	}
+	if(list->next[i] == NIL){
+		list->tail = list->prev[i];
+	}else{
+		list->prev[list->next[i]] = list->prev[i];
+	}
+	list->prev[i] = NOT_LINKED;
+	list->next[i] = NOT_LINKED;
+	list->count--;
+}
+
+void isu_slot_list_push_head(isu_slot_list_t list, int i){
+	if(list->head == i){
+		return;
+	}
+	isu_slot_list_remove(list, i);
+	list->prev[i] = NIL;
+	list->next[i] = list->head;
+	if(list->head == NIL){
+		list->tail = i;
+	}else{
+		list->prev[list->head] = i;
+	}
+	list->head = i;
+	list->count++;
+}
+
+void isu_slot_list_push_tail(isu_slot_list_t list, int i){
+	if(list->tail == i){
+		return;
+	}
+	isu_slot_list_remove(list, i);
+	list->next[i] = NIL;
+	list->prev[i] = list->tail;
+	if(list->tail == NIL){
+		list->head = i;
+	}else{
+		list->next[list->tail] = i;
+	}
+	list->tail = i;
+	list->count++;
+}
+
+int isu_slot_list_pop_tail(isu_slot_list_t list){
+	int i = list->tail;
+	if(i != NIL){
+		isu_slot_list_remove(list, i);
+	}
+	return i;
+}
+
+int isu_slot_list_head(isu_slot_list_t list){
+	return list->head;
+}
+
+int isu_slot_list_tail(isu_slot_list_t list){
+	return list->tail;
+}
+
+int isu_slot_list_next(isu_slot_list_t list, int i){
+	return list->next[i];
+}
+
+int isu_slot_list_prev(isu_slot_list_t list, int i){
+	return list->prev[i];
+}
+
+int isu_slot_list_contains(isu_slot_list_t list, int i){
+	return list->prev[i] != NOT_LINKED;
+}
+
+unsigned int isu_slot_list_count(isu_slot_list_t list){
+	return list->count;
+}
+
+void isu_slot_list_clear(isu_slot_list_t list){
+	unsigned int i;
+	for(i = 0; i < list->n; i++){
+		list->prev[i] = NOT_LINKED;
+		list->next[i] = NOT_LINKED;
+	}
+	list->head = NIL;
+	list->tail = NIL;
+	list->count = 0;
+}
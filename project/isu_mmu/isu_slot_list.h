@@ -0,0 +1,131 @@
+/**
+ * @file	isu_slot_list.h
+ * @brief	an intrusive doubly linked list of slot numbers
+ * @details	Links the slots 0 to n-1 of a level into a list without any
+ * 		allocation per element.  The head of the list is the most recently
+ * 		pushed slot and the tail is the oldest, so the list can be used
+ * 		both as a recency(LRU) list and as a FIFO queue.  Every operation
+ * 		takes constant time.
+ */
+
+#ifndef ISU_SLOT_LIST_H
+#define ISU_SLOT_LIST_H
+
+/**
+ * @class	isu_slot_list_t
+ * @brief	a list of slot numbers
+ */
+typedef struct ISU_SLOT_LIST_STRUCT *isu_slot_list_t;
+
+/**
+ * @brief	constructs a new empty slot list
+ * @param	n
+ * 			the number of slots that can be in the list, slots are 0 to n-1
+ * @return	the new list or NULL if a failure occurs
+ */
+isu_slot_list_t isu_slot_list_create(unsigned int n);
+
+/**
+ * @brief	destroys a slot list
+ * @param	list
+ * 			the list to destroy
+ */
+void isu_slot_list_destroy(isu_slot_list_t list);
+
+/**
+ * @brief	puts a slot at the head of the list, moving it if it is already in the list
+ * @param	list
+ * 			the list
+ * @param	i
+ * 			the slot to put at the head
+ */
+void isu_slot_list_push_head(isu_slot_list_t list, int i);
+
+/**
+ * @brief	puts a slot at the tail of the list, moving it if it is already in the list
+ * @param	list
+ * 			the list
+ * @param	i
+ * 			the slot to put at the tail
+ */
+void isu_slot_list_push_tail(isu_slot_list_t list, int i);
+
+/**
+ * @brief	takes a slot out of the list, does nothing if it is not in the list
+ * @param	list
+ * 			the list
+ * @param	i
+ * 			the slot to take out
+ */
+void isu_slot_list_remove(isu_slot_list_t list, int i);
+
+/**
+ * @brief	takes the tail slot out of the list
+ * @param	list
+ * 			the list
+ * @return	the slot that was at the tail or -1 if the list is empty
+ */
+int isu_slot_list_pop_tail(isu_slot_list_t list);
+
+/**
+ * @brief	gets the slot at the head of the list
+ * @param	list
+ * 			the list
+ * @return	the head slot or -1 if the list is empty
+ */
+int isu_slot_list_head(isu_slot_list_t list);
+
+/**
+ * @brief	gets the slot at the tail of the list
+ * @param	list
+ * 			the list
+ * @return	the tail slot or -1 if the list is empty
+ */
+int isu_slot_list_tail(isu_slot_list_t list);
+
+/**
+ * @brief	gets the slot after `i`, going from the head to the tail
+ * @param	list
+ * 			the list
+ * @param	i
+ * 			a slot in the list
+ * @return	the next slot towards the tail or -1 if `i` is the tail
+ */
+int isu_slot_list_next(isu_slot_list_t list, int i);
+
+/**
+ * @brief	gets the slot before `i`, going from the tail to the head
+ * @param	list
+ * 			the list
+ * @param	i
+ * 			a slot in the list
+ * @return	the next slot towards the head or -1 if `i` is the head
+ */
+int isu_slot_list_prev(isu_slot_list_t list, int i);
+
+/**
+ * @brief	checks if a slot is in the list
+ * @param	list
+ * 			the list
+ * @param	i
+ * 			the slot to check
+ * @return	1 if `i` is in the list, 0 otherwise
+ */
+int isu_slot_list_contains(isu_slot_list_t list, int i);
+
+/**
+ * @brief	gets the number of slots in the list
+ * @param	list
+ * 			the list
+ * @return	the number of slots in the list
+ */
+unsigned int isu_slot_list_count(isu_slot_list_t list);
+
+/**
+ * @brief	takes every slot out of the list
+ * @param	list
+ * 			the list
+ */
+void isu_slot_list_clear(isu_slot_list_t list);
+
+#endif
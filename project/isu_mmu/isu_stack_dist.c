@@ -0,0 +1,201 @@
+/**
+ * @file	isu_stack_dist.c
+ * @brief	source file of isu_stack_dist.h
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "isu_stack_dist.h"
+#include "isu_page_index.h"
+#include "common/isu_error.h"
+
+/// the number of time positions to start with
+#define START_POSITIONS 1024
+
+struct ISU_STACK_DIST_STRUCT{
+	/// Fenwick tree, 1 based, over time positions, counting the positions
+	/// that hold the last request of a page
+	unsigned int *tree;
+
+	/// the page whose last request is at each position, -1 if none
+	long long *position_page;
+
+	/// the number of time positions
+	unsigned long long n_positions;
+
+	/// the next free time position
+	unsigned long long cursor;
+
+	/// maps each page to the position of its last request
+	isu_page_index_t last;
+
+	/// the number of requests at each stack distance, index 0 holds the
+	/// first requests of pages
+	unsigned long long *hist;
+
+	/// the number of entries in `hist`
+	unsigned long long hist_size;
+
+	/// the number of requests added
+	unsigned long long count;
+};
+
+isu_stack_dist_t isu_stack_dist_create(void){
+	unsigned long long i;
+	isu_stack_dist_t sd = calloc(1, sizeof(struct ISU_STACK_DIST_STRUCT));
+	if(sd == NULL){
+		isu_print(PRINT_ERROR, "calloc returned NULL");
+		return NULL;
+	}
+	sd->n_positions = START_POSITIONS;
+	sd->tree = calloc(sd->n_positions + 1, sizeof(unsigned int));
+	sd->position_page = malloc(sd->n_positions * sizeof(long long));
+	sd->hist_size = START_POSITIONS;
+	sd->hist = calloc(sd->hist_size, sizeof(unsigned long long));
+	sd->last = isu_page_index_create(START_POSITIONS);
+	if(sd->tree == NULL || sd->position_page == NULL || sd->hist == NULL || sd->last == NULL){
+		isu_print(PRINT_ERROR, "malloc returned NULL");
+		isu_stack_dist_destroy(sd);
+		return NULL;
+	}
+	for(i = 0; i < sd->n_positions; i++){
+		sd->position_page[i] = -1;
+	}
+	return sd;
+}
+
+void isu_stack_dist_destroy(isu_stack_dist_t sd){
+	free(sd->tree);
+	free(sd->position_page);
+	free(sd->hist);
+	if(sd->last){
+		isu_page_index_destroy(sd->last);
+	}
+	free(sd);
+}
+
+/// adds `delta` at position `i`, 0 based
+static void isu_stack_dist_tree_add(isu_stack_dist_t sd, unsigned long long i, int delta){
+	for(i++; i <= sd->n_positions; i += i & (~i + 1)){
+		sd->tree[i] += delta;
+	}
+}
+
+/// counts the marked positions from 0 to `i`, 0 based
+static unsigned long long isu_stack_dist_tree_sum(isu_stack_dist_t sd, unsigned long long i){
+	unsigned long long sum = 0;
+	for(i++; i > 0; i -= i & (~i + 1)){
+		sum += sd->tree[i];
+	}
+	return sum;
+}
+
+/// packs the last requests of every page into the first positions, keeping
+/// their order, and doubles the positions if more than half are then used
+static int isu_stack_dist_compact(isu_stack_dist_t sd){
+	unsigned long long i;
+	unsigned long long j;
+	unsigned long long live = isu_page_index_count(sd->last);
+	unsigned long long n = sd->n_positions;
+	unsigned int *tree;
+	long long *position_page;
+
+	if(2 * live > n){
+		n *= 2;
+		position_page = realloc(sd->position_page, n * sizeof(long long));
+		if(position_page == NULL){
+			isu_print(PRINT_ERROR, "realloc returned NULL");
+			return -1;
+		}
+		sd->position_page = position_page;
+		tree = realloc(sd->tree, (n + 1) * sizeof(unsigned int));
+		if(tree == NULL){
+			isu_print(PRINT_ERROR, "realloc returned NULL");
+			return -1;
+		}
+		sd->tree = tree;
+		for(i = sd->n_positions; i < n; i++){
+			sd->position_page[i] = -1;
+		}
+	}
+	for(i = 0, j = 0; i < sd->n_positions; i++){
+		if(sd->position_page[i] >= 0){
+			sd->position_page[j] = sd->position_page[i];
+			isu_page_index_insert(sd->last, sd->position_page[j], j);
+			j++;
+		}
+	}
+	for(i = j; i < n; i++){
+		sd->position_page[i] = -1;
+	}
+	sd->n_positions = n;
+	sd->cursor = j;
+
+	/// build the tree in place over the first `j` positions
+	memset(sd->tree, 0, (n + 1) * sizeof(unsigned int));
+	for(i = 1; i <= n; i++){
+		sd->tree[i] += i <= j;
+		if(i + (i & (~i + 1)) <= n){
+			sd->tree[i + (i & (~i + 1))] += sd->tree[i];
+		}
+	}
+	return 0;
+}
+
+long long isu_stack_dist_access(isu_stack_dist_t sd, long long page){
+	long long prev;
+	unsigned long long dist = 0;
+	unsigned long long *hist;
+
+	if(sd->cursor == sd->n_positions && isu_stack_dist_compact(sd) < 0){
+		return -1;
+	}
+	prev = isu_page_index_find(sd->last, page);
+	if(prev >= 0){
+		/// the pages requested after `prev`, and the page itself
+		dist = isu_stack_dist_tree_sum(sd, sd->cursor - 1) - isu_stack_dist_tree_sum(sd, prev) + 1;
+		isu_stack_dist_tree_add(sd, prev, -1);
+		sd->position_page[prev] = -1;
+	}
+	if(dist >= sd->hist_size){
+		hist = realloc(sd->hist, 2 * dist * sizeof(unsigned long long));
+		if(hist == NULL){
+			isu_print(PRINT_ERROR, "realloc returned NULL");
+			return -1;
+		}
+		memset(hist + sd->hist_size, 0, (2 * dist - sd->hist_size) * sizeof(unsigned long long));
+		sd->hist = hist;
+		sd->hist_size = 2 * dist;
+	}
+	sd->hist[dist]++;
+	sd->count++;
+
+	if(isu_page_index_insert(sd->last, page, sd->cursor) < 0){
+		return -1;
+	}
+	sd->position_page[sd->cursor] = page;
+	isu_stack_dist_tree_add(sd, sd->cursor, 1);
+	sd->cursor++;
+	return (long long)dist;
+}
+
+unsigned long long isu_stack_dist_count(isu_stack_dist_t sd){
+	return sd->count;
+}
+
+unsigned long long isu_stack_dist_distinct(isu_stack_dist_t sd){
+	return isu_page_index_count(sd->last);
+}
+
+void isu_stack_dist_misses(isu_stack_dist_t sd, unsigned long long *misses, unsigned long long max_capacity){
+	unsigned long long c;
+	/// with `c` pages every request with a distance over `c` misses
+	unsigned long long over = sd->count;
+	for(c = 0; c <= max_capacity; c++){
+		if(c > 0 && c < sd->hist_size){
+			over -= sd->hist[c];
+		}
+		misses[c] = over;
+	}
+}
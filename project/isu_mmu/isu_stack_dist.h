@@ -0,0 +1,80 @@
+/**
+ * @file	isu_stack_dist.h
+ * @brief	stack distance(Mattson) analysis of a stream of page requests
+ * @details	The stack distance of a request is the number of distinct pages
+ * 		used since the last request to the same page, counting itself.  An
+ * 		LRU level of `c` pages hits exactly the requests with a distance of
+ * 		at most `c`, so one pass over a trace gives the miss ratio of LRU
+ * 		at every capacity.
+ *
+ * 		Distances are counted with a Fenwick tree over the time of the
+ * 		last request of each page.  The tree is compacted whenever it
+ * 		fills up, so its size follows the number of distinct pages and
+ * 		not the length of the trace.
+ */
+
+#ifndef ISU_STACK_DIST_H
+#define ISU_STACK_DIST_H
+
+/**
+ * @class	isu_stack_dist_t
+ * @brief	the stack distances of a stream of requests
+ */
+typedef struct ISU_STACK_DIST_STRUCT *isu_stack_dist_t;
+
+/**
+ * @brief	constructs a new stack distance analysis
+ * @return	the new analysis or NULL if a failure occurs
+ */
+isu_stack_dist_t isu_stack_dist_create(void);
+
+/**
+ * @brief	destroys a stack distance analysis
+ * @param	sd
+ * 			the analysis to destroy
+ */
+void isu_stack_dist_destroy(isu_stack_dist_t sd);
+
+/**
+ * @brief	adds a request to the analysis
+ * @param	sd
+ * 			the analysis
+ * @param	page
+ * 			the page requested, must not be negative
+ * @return	the stack distance of the request, 1 if it was the last page
+ * 		requested, 0 if the page was never requested before, or -1 if a
+ * 		failure occurs
+ */
+long long isu_stack_dist_access(isu_stack_dist_t sd, long long page);
+
+/**
+ * @brief	gets the number of requests added
+ * @param	sd
+ * 			the analysis
+ * @return	the number of requests
+ */
+unsigned long long isu_stack_dist_count(isu_stack_dist_t sd);
+
+/**
+ * @brief	gets the number of distinct pages requested
+ * @param	sd
+ * 			the analysis
+ * @return	the number of pages, also the largest possible stack distance
+ */
+unsigned long long isu_stack_dist_distinct(isu_stack_dist_t sd);
+
+/**
+ * @brief	gets the misses of an LRU level of every capacity
+ * @param	sd
+ * 			the analysis
+ * @param	misses
+ * 			set to the misses of a level of `c` pages in `misses[c]`, for
+ * 			`c` from 0 to `max_capacity`
+ * @param	max_capacity
+ * 			the largest capacity wanted
+ * @details	Every request is a miss with 0 pages, and capacities past
+ * 		isu_stack_dist_distinct() only miss the first request of each page.
+ */
+void isu_stack_dist_misses(isu_stack_dist_t sd, unsigned long long *misses, unsigned long long max_capacity);
+
+#endif
@@ -0,0 +1,164 @@
+/**
+ * @file	isu_tlb.c
+ * @brief	source file of isu_tlb.h
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "isu_tlb.h"
+#include "isu_page_index.h"
+#include "isu_slot_list.h"
+#include "common/isu_error.h"
+
+struct ISU_TLB_STRUCT{
+	/// the page translated by each entry, -1 if the entry is empty
+	long long *page;
+
+	/// the number of entries
+	unsigned int entries;
+
+	/// the number of entries in each set
+	unsigned int ways;
+
+	/// the number of sets, a power of two
+	unsigned int sets;
+
+	/// ISU_TLB_FIFO, ISU_TLB_LRU or ISU_TLB_RANDOM
+	int rep_mode;
+
+	/// the used entries of each set, numbered from 0 within the set. The
+	/// head is the most recently used entry for LRU and the most recently
+	/// filled one otherwise
+	isu_slot_list_t *order;
+
+	/// maps the pages in the TLB to their entry
+	isu_page_index_t index;
+
+	/// the state of the generator picking random victims
+	unsigned int seed;
+};
+
+isu_tlb_t isu_tlb_create(unsigned int entries, unsigned int ways, int rep_mode){
+	isu_tlb_t tlb;
+	unsigned int i;
+	if(ways == 0){
+		ways = entries;
+	}
+	if(entries == 0 || entries % ways || (entries / ways) & (entries / ways - 1)){
+		isu_print(PRINT_ERROR, "%u entries can't be split into a power of two sets of %u ways", entries, ways);
+		return NULL;
+	}
+	if(rep_mode < ISU_TLB_FIFO || rep_mode > ISU_TLB_RANDOM){
+		isu_print(PRINT_ERROR, "%d is not a TLB replacement mode", rep_mode);
+		return NULL;
+	}
+	tlb = calloc(1, sizeof(struct ISU_TLB_STRUCT));
+	if(tlb == NULL){
+		isu_print(PRINT_ERROR, "calloc returned NULL");
+		return NULL;
+	}
+	tlb->entries = entries;
+	tlb->ways = ways;
+	tlb->sets = entries / ways;
+	tlb->rep_mode = rep_mode;
+	tlb->seed = 12345;
+	tlb->page = malloc(entries * sizeof(long long));
+	tlb->order = calloc(tlb->sets, sizeof(isu_slot_list_t));
+	tlb->index = isu_page_index_create(entries);
+	if(tlb->page == NULL || tlb->order == NULL || tlb->index == NULL){
+		isu_print(PRINT_ERROR, "malloc returned NULL");
+		isu_tlb_destroy(tlb);
+		return NULL;
+	}
+	for(i = 0; i < tlb->sets; i++){
+		tlb->order[i] = isu_slot_list_create(ways);
+		if(tlb->order[i] == NULL){
+			isu_print(PRINT_ERROR, "malloc returned NULL");
+			isu_tlb_destroy(tlb);
+			return NULL;
+		}
+	}
+	for(i = 0; i < entries; i++){
+		tlb->page[i] = -1;
+	}
+	return tlb;
+}
+
+void isu_tlb_destroy(isu_tlb_t tlb){
+	unsigned int i;
+	if(tlb->order){
+		for(i = 0; i < tlb->sets; i++){
+			if(tlb->order[i]){
+				isu_slot_list_destroy(tlb->order[i]);
+			}
+		}
+		free(tlb->order);
+	}
+	if(tlb->index){
+		isu_page_index_destroy(tlb->index);
+	}
+	free(tlb->page);
+	free(tlb);
+}
+
+/// picks the entry of set `set` to fill, an empty one if there is one
+static unsigned int isu_tlb_victim(isu_tlb_t tlb, unsigned int set){
+	unsigned int i;
+	unsigned int base = set * tlb->ways;
+	if(isu_slot_list_count(tlb->order[set]) < tlb->ways){
+		for(i = base; i < base + tlb->ways; i++){
+			if(tlb->page[i] == -1){
+				return i;
+			}
+		}
+	}
+	if(tlb->rep_mode == ISU_TLB_RANDOM){
+		/// xorshift, enough to spread the victims over the set
+		tlb->seed ^= tlb->seed << 13;
+		tlb->seed ^= tlb->seed >> 17;
+		tlb->seed ^= tlb->seed << 5;
+		return base + tlb->seed % tlb->ways;
+	}
+	/// the tail is the least recently used or the first filled entry
+	return base + isu_slot_list_tail(tlb->order[set]);
+}
+
+int isu_tlb_lookup(isu_tlb_t tlb, long long page){
+	unsigned int set;
+	unsigned int i;
+	long long found = isu_page_index_find(tlb->index, page);
+	if(found >= 0){
+		if(tlb->rep_mode == ISU_TLB_LRU){
+			isu_slot_list_push_head(tlb->order[found / tlb->ways], (int)(found % tlb->ways));
+		}
+		return 1;
+	}
+	set = (unsigned int)page & (tlb->sets - 1);
+	i = isu_tlb_victim(tlb, set);
+	if(tlb->page[i] != -1){
+		isu_page_index_remove(tlb->index, tlb->page[i]);
+	}
+	tlb->page[i] = page;
+	isu_page_index_insert(tlb->index, page, i);
+	isu_slot_list_push_head(tlb->order[set], i % tlb->ways);
+	return 0;
+}
+
+void isu_tlb_invalidate(isu_tlb_t tlb, long long page){
+	long long i = isu_page_index_remove(tlb->index, page);
+	if(i >= 0){
+		tlb->page[i] = -1;
+		isu_slot_list_remove(tlb->order[i / tlb->ways], (int)(i % tlb->ways));
+	}
+}
+
+void isu_tlb_flush(isu_tlb_t tlb){
+	unsigned int i;
+	for(i = 0; i < tlb->entries; i++){
+		tlb->page[i] = -1;
+	}
+	for(i = 0; i < tlb->sets; i++){
+		isu_slot_list_clear(tlb->order[i]);
+	}
+	isu_page_index_clear(tlb->index);
+}
@@ -0,0 +1,74 @@
+/**
+ * @file	isu_tlb.h
+ * @brief	a translation lookaside buffer
+ * @details	Caches which virtual pages have a translation, in front of the
+ * 		MMU hierarchy.  The entries are split into sets the way a
+ * 		set-associative level of the MMU is, the set of a page is the
+ * 		low bits of its page number, and each set replaces its entries
+ * 		on its own.
+ */
+
+#ifndef ISU_TLB_H
+#define ISU_TLB_H
+
+/// replace the entry filled longest ago
+#define ISU_TLB_FIFO 0
+/// replace the entry used least recently
+#define ISU_TLB_LRU 1
+/// replace an entry picked at random
+#define ISU_TLB_RANDOM 2
+
+/**
+ * @class	isu_tlb_t
+ * @brief	the TLB object
+ */
+typedef struct ISU_TLB_STRUCT *isu_tlb_t;
+
+/**
+ * @brief	constructs a new empty TLB
+ * @param	entries
+ * 			the number of translations the TLB holds
+ * @param	ways
+ * 			the number of entries in each set, 0 for fully associative.
+ * 			`entries` / `ways` must be a power of two
+ * @param	rep_mode
+ * 			ISU_TLB_FIFO, ISU_TLB_LRU or ISU_TLB_RANDOM
+ * @return	the new TLB or NULL if a failure occurs
+ */
+isu_tlb_t isu_tlb_create(unsigned int entries, unsigned int ways, int rep_mode);
+
+/**
+ * @brief	destroys a TLB
+ * @param	tlb
+ * 			the TLB to destroy
+ */
+void isu_tlb_destroy(isu_tlb_t tlb);
+
+/**
+ * @brief	looks up the translation of a page
+ * @param	tlb
+ * 			the TLB
+ * @param	page
+ * 			the virtual page, not negative
+ * @return	1 if the translation was there, 0 if it was not, in which case
+ * 		it is filled, replacing an entry of the set if it is full
+ */
+int isu_tlb_lookup(isu_tlb_t tlb, long long page);
+
+/**
+ * @brief	drops the translation of a page, if the TLB has it
+ * @param	tlb
+ * 			the TLB
+ * @param	page
+ * 			the virtual page
+ */
+void isu_tlb_invalidate(isu_tlb_t tlb, long long page);
+
+/**
+ * @brief	drops every translation
+ * @param	tlb
+ * 			the TLB
+ */
+void isu_tlb_flush(isu_tlb_t tlb);
+
+#endif
@@ -0,0 +1,140 @@
+/**
+ * @file	isu_working_set.c
+ * @brief	source file of isu_working_set.h
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "isu_working_set.h"
+#include "isu_page_index.h"
+#include "common/isu_error.h"
+
+/// the number of samples to start with
+#define START_SAMPLES 256
+
+struct ISU_WORKING_SET_STRUCT{
+	/// the window in requests
+	unsigned long long tau;
+
+	/// the requests between samples
+	unsigned long long interval;
+
+	/// the page of each of the last `tau` requests, request `t` is at
+	/// `t` % `tau`
+	long long *window;
+
+	/// maps each page in the working set to the time of its last request
+	isu_page_index_t last;
+
+	/// the number of requests added
+	unsigned long long count;
+
+	/// the faults since the last sample
+	unsigned long long faults;
+
+	/// the sum of the working set size after each request
+	unsigned long long size_sum;
+
+	/// the largest working set size
+	unsigned long long peak;
+
+	/// the samples taken
+	isu_working_set_sample_t *samples;
+
+	/// the number of samples taken and the room for them
+	unsigned long long n_samples;
+	unsigned long long max_samples;
+};
+
+isu_working_set_t isu_working_set_create(unsigned long long tau, unsigned long long interval){
+	isu_working_set_t ws;
+	if(tau == 0 || interval == 0){
+		isu_print(PRINT_ERROR, "the window and the interval must not be 0");
+		return NULL;
+	}
+	ws = calloc(1, sizeof(struct ISU_WORKING_SET_STRUCT));
+	if(ws == NULL){
+		isu_print(PRINT_ERROR, "calloc returned NULL");
+		return NULL;
+	}
+	ws->tau = tau;
+	ws->interval = interval;
+	ws->window = malloc(tau * sizeof(long long));
+	ws->last = isu_page_index_create(tau < START_SAMPLES ? (unsigned int)tau : START_SAMPLES);
+	ws->max_samples = START_SAMPLES;
+	ws->samples = malloc(ws->max_samples * sizeof(isu_working_set_sample_t));
+	if(ws->window == NULL || ws->last == NULL || ws->samples == NULL){
+		isu_print(PRINT_ERROR, "malloc returned NULL");
+		isu_working_set_destroy(ws);
+		return NULL;
+	}
+	return ws;
+}
+
+void isu_working_set_destroy(isu_working_set_t ws){
+	free(ws->window);
+	free(ws->samples);
+	if(ws->last){
+		isu_page_index_destroy(ws->last);
+	}
+	free(ws);
+}
+
+long long isu_working_set_access(isu_working_set_t ws, long long page, int fault, unsigned long long time){
+	long long old;
+	unsigned long long size;
+	unsigned long long slot = ws->count % ws->tau;
+	isu_working_set_sample_t *samples;
+
+	/// the request leaving the window takes its page out of the working set,
+	/// unless the page was requested again since
+	if(ws->count >= ws->tau){
+		old = ws->window[slot];
+		if(isu_page_index_find(ws->last, old) == (long long)(ws->count - ws->tau)){
+			isu_page_index_remove(ws->last, old);
+		}
+	}
+	if(isu_page_index_insert(ws->last, page, (long long)ws->count) < 0){
+		return -1;
+	}
+	ws->window[slot] = page;
+	ws->count++;
+	ws->faults += fault != 0;
+
+	size = isu_page_index_count(ws->last);
+	ws->size_sum += size;
+	if(size > ws->peak){
+		ws->peak = size;
+	}
+	if(ws->count % ws->interval == 0){
+		if(ws->n_samples == ws->max_samples){
+			samples = realloc(ws->samples, 2 * ws->max_samples * sizeof(isu_working_set_sample_t));
+			if(samples == NULL){
+				isu_print(PRINT_ERROR, "realloc returned NULL");
+				return -1;
+			}
+			ws->samples = samples;
+			ws->max_samples *= 2;
+		}
+		ws->samples[ws->n_samples].requests = ws->count;
+		ws->samples[ws->n_samples].time = time;
+		ws->samples[ws->n_samples].size = size;
+		ws->samples[ws->n_samples].faults = ws->faults;
+		ws->n_samples++;
+		ws->faults = 0;
+	}
+	return (long long)size;
+}
+
+const isu_working_set_sample_t *isu_working_set_samples(isu_working_set_t ws, unsigned long long *n){
+	*n = ws->n_samples;
+	return ws->samples;
+}
+
+double isu_working_set_mean(isu_working_set_t ws){
+	return ws->count ? (double)ws->size_sum / (double)ws->count : 0.;
+}
+
+unsigned long long isu_working_set_peak(isu_working_set_t ws){
+	return ws->peak;
+}
@@ -0,0 +1,97 @@
+/**
+ * @file	isu_working_set.h
+ * @brief	working set(Denning) and page fault frequency of a stream of requests
+ * @details	The working set at request `t` is the set of distinct pages used
+ * 		by the last `tau` requests.  Its size is kept up to date with a
+ * 		ring of the last `tau` pages and the time of the last request of
+ * 		each page, so each request costs the same however large `tau` is.
+ *
+ * 		Every `interval` requests a sample of the working set size and
+ * 		of the faults in the interval is taken.  The samples form a time
+ * 		series of the memory a program needs and of the rate it faults
+ * 		at with the memory it was given.
+ */
+
+#ifndef ISU_WORKING_SET_H
+#define ISU_WORKING_SET_H
+
+/**
+ * @brief	one sample of the time series
+ */
+typedef struct ISU_WORKING_SET_SAMPLE{
+	/// the requests made by the end of the interval
+	unsigned long long requests;
+	/// the time the last request of the interval was handled
+	unsigned long long time;
+	/// the working set size at the end of the interval
+	unsigned long long size;
+	/// the faults in the interval
+	unsigned long long faults;
+}isu_working_set_sample_t;
+
+/**
+ * @class	isu_working_set_t
+ * @brief	the working set of a stream of requests
+ */
+typedef struct ISU_WORKING_SET_STRUCT *isu_working_set_t;
+
+/**
+ * @brief	constructs a new working set
+ * @param	tau
+ * 			the window, in requests, the working set is taken over
+ * @param	interval
+ * 			the requests between samples
+ * @return	the new working set or NULL if `tau` or `interval` is 0 or a
+ * 		failure occurs
+ */
+isu_working_set_t isu_working_set_create(unsigned long long tau, unsigned long long interval);
+
+/**
+ * @brief	destroys a working set
+ * @param	ws
+ * 			the working set to destroy
+ */
+void isu_working_set_destroy(isu_working_set_t ws);
+
+/**
+ * @brief	adds a request to the working set
+ * @param	ws
+ * 			the working set
+ * @param	page
+ * 			the page requested, must not be negative
+ * @param	fault
+ * 			1 if the request faulted, 0 if not
+ * @param	time
+ * 			the time the request was handled
+ * @return	the working set size after the request, or -1 if a failure
+ * 		occurs
+ */
+long long isu_working_set_access(isu_working_set_t ws, long long page, int fault, unsigned long long time);
+
+/**
+ * @brief	gets the samples taken so far
+ * @param	ws
+ * 			the working set
+ * @param	n
+ * 			set to the number of samples
+ * @return	the samples, oldest first, valid until the next request is added
+ */
+const isu_working_set_sample_t *isu_working_set_samples(isu_working_set_t ws, unsigned long long *n);
+
+/**
+ * @brief	gets the mean working set size over every request
+ * @param	ws
+ * 			the working set
+ * @return	the mean size, 0 if no request was added
+ */
+double isu_working_set_mean(isu_working_set_t ws);
+
+/**
+ * @brief	gets the largest working set size seen
+ * @param	ws
+ * 			the working set
+ * @return	the largest size
+ */
+unsigned long long isu_working_set_peak(isu_working_set_t ws);
+
+#endif
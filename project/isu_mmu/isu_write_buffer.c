@@ -0,0 +1,108 @@
+/**
+ * @file	isu_write_buffer.c
+ * @brief	source file of isu_write_buffer.h
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "isu_write_buffer.h"
+#include "isu_page_index.h"
+#include "common/isu_error.h"
+
+struct ISU_WRITE_BUFFER_STRUCT{
+	/// the page of each entry of the ring
+	long long *pages;
+
+	/// the time disk is done writing each entry of the ring
+	unsigned long long *done;
+
+	/// the most entries
+	unsigned int capacity;
+
+	/// the oldest entry
+	unsigned int head;
+
+	/// the number of entries
+	unsigned int count;
+
+	/// the time it takes disk to write a page
+	unsigned long long write_delay;
+
+	/// the time disk is done with every entry
+	unsigned long long disk_free;
+
+	/// maps the waiting pages to their entry
+	isu_page_index_t index;
+};
+
+isu_write_buffer_t isu_write_buffer_create(unsigned int capacity, unsigned long long write_delay){
+	isu_write_buffer_t wb;
+	if(capacity == 0){
+		isu_print(PRINT_ERROR, "a write buffer needs at least one entry");
+		return NULL;
+	}
+	wb = calloc(1, sizeof(struct ISU_WRITE_BUFFER_STRUCT));
+	if(wb == NULL){
+		isu_print(PRINT_ERROR, "calloc returned NULL");
+		return NULL;
+	}
+	wb->capacity = capacity;
+	wb->write_delay = write_delay;
+	wb->pages = malloc(capacity * sizeof(long long));
+	wb->done = malloc(capacity * sizeof(unsigned long long));
+	wb->index = isu_page_index_create(capacity);
+	if(wb->pages == NULL || wb->done == NULL || wb->index == NULL){
+		isu_print(PRINT_ERROR, "malloc returned NULL");
+		isu_write_buffer_destroy(wb);
+		return NULL;
+	}
+	return wb;
+}
+
+void isu_write_buffer_destroy(isu_write_buffer_t wb){
+	free(wb->pages);
+	free(wb->done);
+	if(wb->index){
+		isu_page_index_destroy(wb->index);
+	}
+	free(wb);
+}
+
+/// drops the entries disk has written by `now`
+static void isu_write_buffer_retire(isu_write_buffer_t wb, unsigned long long now){
+	while(wb->count && wb->done[wb->head] <= now){
+		isu_page_index_remove(wb->index, wb->pages[wb->head]);
+		wb->head = (wb->head + 1) % wb->capacity;
+		wb->count--;
+	}
+}
+
+unsigned long long isu_write_buffer_put(isu_write_buffer_t wb, long long page, unsigned long long now, int *coalesced){
+	unsigned int i;
+	isu_write_buffer_retire(wb, now);
+	if(isu_page_index_find(wb->index, page) >= 0){
+		*coalesced = 1;
+		return now;
+	}
+	*coalesced = 0;
+	if(wb->count == wb->capacity){
+		/// wait for disk to finish the oldest entry
+		now = wb->done[wb->head];
+		isu_write_buffer_retire(wb, now);
+	}
+	if(wb->disk_free < now){
+		wb->disk_free = now;
+	}
+	wb->disk_free += wb->write_delay;
+	i = (wb->head + wb->count) % wb->capacity;
+	wb->pages[i] = page;
+	wb->done[i] = wb->disk_free;
+	wb->count++;
+	isu_page_index_insert(wb->index, page, i);
+	return now;
+}
+
+int isu_write_buffer_contains(isu_write_buffer_t wb, long long page, unsigned long long now){
+	isu_write_buffer_retire(wb, now);
+	return isu_page_index_find(wb->index, page) >= 0;
+}
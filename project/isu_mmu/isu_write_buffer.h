@@ -0,0 +1,65 @@
+/**
+ * @file	isu_write_buffer.h
+ * @brief	a coalescing write buffer in front of disk
+ * @details	Dirty pages leaving the last level of the MMU are queued here
+ * 		instead of making the request wait for disk.  The disk writes the
+ * 		queued pages one after the other in the background, a page
+ * 		queued again before it is written is only written once, and the
+ * 		request only waits when the buffer is full.  The writes are
+ * 		taken to not hold up reads of disk.
+ */
+
+#ifndef ISU_WRITE_BUFFER_H
+#define ISU_WRITE_BUFFER_H
+
+/**
+ * @class	isu_write_buffer_t
+ * @brief	a FIFO of pages waiting to be written to disk
+ */
+typedef struct ISU_WRITE_BUFFER_STRUCT *isu_write_buffer_t;
+
+/**
+ * @brief	constructs a new write buffer
+ * @param	capacity
+ * 			the most pages waiting at once
+ * @param	write_delay
+ * 			the time it takes disk to write a page
+ * @return	the new write buffer or NULL if a failure occurs
+ */
+isu_write_buffer_t isu_write_buffer_create(unsigned int capacity, unsigned long long write_delay);
+
+/**
+ * @brief	destroys a write buffer
+ * @param	wb
+ * 			the write buffer to destroy
+ */
+void isu_write_buffer_destroy(isu_write_buffer_t wb);
+
+/**
+ * @brief	queues a page to be written to disk
+ * @param	wb
+ * 			the write buffer
+ * @param	page
+ * 			the page to write
+ * @param	now
+ * 			the current time
+ * @param	coalesced
+ * 			set to 1 if `page` was already waiting, 0 if not
+ * @return	the time the page was queued, later than `now` if the buffer was
+ * 		full and had to wait for disk
+ */
+unsigned long long isu_write_buffer_put(isu_write_buffer_t wb, long long page, unsigned long long now, int *coalesced);
+
+/**
+ * @brief	checks if a page is waiting to be written
+ * @param	wb
+ * 			the write buffer
+ * @param	page
+ * 			the page to look for
+ * @param	now
+ * 			the current time, pages written by then are no longer waiting
+ * @return	1 if `page` is waiting, 0 if not
+ */
+int isu_write_buffer_contains(isu_write_buffer_t wb, long long page, unsigned long long now);
+
+#endif
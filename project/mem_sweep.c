@@ -0,0 +1,974 @@
+/**
+ * @file	mem_sweep.c
+ * @brief	runs a grid of MMU configurations over the same requests in parallel
+ * @details	Every point of the grid(replacement mode x source x geometry) is
+ * 		an MMU of its own, so points are handed out to worker threads,
+ * 		one at a time, and the threads share nothing but the read-only
+ * 		requests.  The results of every point go to a single CSV or JSON
+ * 		report.
+ *
+ * 		The grid spec has one `key = values` line per dimension, values
+ * 		separated by spaces, and # starts a comment:
+ *
+ * 			mode = 0 1 2		replacement modes, 0 to 6
+ * 			pattern = 0 1 2		patterns of mem_test, 0 to 6
+ * 			trace = a.bin b.bin	binary traces, see trace_conv
+ * 			requests = 1000		requests of each pattern
+ * 			l1 = 4 8 16		pages of L1
+ * 			l2 = 8			pages of L2
+ * 			ram = 32		pages of RAM
+ * 			page = 4096		page size of every level
+ * 			ways = 0 2		ways of L1 and L2, 0 for fully associative
+ * 			wbuf = 0 16		write buffer entries, 0 for none
+ * 			tlb = 0 64		TLB entries, 0 for none
+ * 			prefetch = 0 1 2 3	prefetchers of L1, 0 for none
+ * 			procs = 0 1 2 4 8	processes taking turns, 0 for one
+ * 						address space without page tables,
+ * 						unless a trace has addresses past
+ * 						16 bits
+ * 			scope = 0 1		global or local replacement
+ * 			walk = 0 2 3 4		levels of the page tables walked on a
+ * 						TLB miss, 0 for the miss delay
+ * 			pwc = 0 16		page walk cache entries of each level
+ * 			spread = 0 9 18		bits each page number is shifted up
+ * 						by, to make the layout sparse
+ * 			huge = 0 2097152	bytes of a huge page, 0 for none
+ * 			promote = 1 256		pages of a region used before it is
+ * 						promoted to a huge page
+ * 			cores = 0 2 4		cores with a private L1 each sharing
+ * 						L2 and RAM, 0 for one hierarchy.
+ * 						The private L1s replace pages by
+ * 						the mode too, OPT can't have cores.
+ * 						The TLB, page tables and huge pages
+ * 						of cores are those of the shared
+ * 						levels, so their rates are of the
+ * 						misses of the private L1s
+ * 			mshr = 0 8		misses in flight at once, 0 for one
+ * 						request at a time, unused by cores
+ * 			sample = 0 100		1 page in each this many simulated,
+ * 						with every capacity divided by it,
+ * 						0 for every page
+ * 			threads = 64		worker threads, all cores if not given
+ *
+ * 		A sampled point scales its level counts up to estimate the
+ * 		whole source, and reports the 95% error of its hit rate and of
+ * 		the share of requests that went to disk, -1 if too few pages
+ * 		were sampled to tell.  A point that samples no pages fails.  Its times and other
+ * 		counters are those of the sampled requests alone.  OPT and
+ * 		cores are never sampled.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "isu_mmu/isu_mmu.h"
+#include "isu_mmu/isu_tlb.h"
+#include "isu_mmu/isu_mmu_prefetch.h"
+#include "isu_mmu/isu_multicore.h"
+#include "isu_mmu/isu_sampler.h"
+#include "page_req/isu_mem_trace.h"
+#include "page_req/isu_mem_pattern.h"
+
+/// the most values of one dimension of the grid
+#define MAX_VALUES 64
+/// the longest line of a grid spec
+#define LINE_LEN 1024
+/// the number of requests each worker hands to the MMU at a time
+#define CHUNK 65536
+/// the delay of the levels of the hierarchy and of disk, as in isu_mmu_create()
+#define L1_DELAY 1
+#define L2_DELAY 7
+#define RAM_DELAY 75
+#define DISK_DELAY 5000000
+/// the delay of a TLB hit, and of a TLB miss which reads the page table in RAM
+#define TLB_HIT_DELAY 0
+#define TLB_MISS_DELAY RAM_DELAY
+/// the most pages a prefetcher asks for after one request
+#define PREFETCH_DEGREE 2
+/// the requests each process makes before the next process takes its turn
+#define QUANTUM 1000
+/// the translations of huge pages the TLB holds apart from the other pages
+#define HUGE_TLB_ENTRIES 32
+
+/// the names of the replacement modes
+static const char *mode_names[] = {"fifo", "lru", "clock", "arc", "2q", "lirs", "opt"};
+/// the names of the replacement scopes
+static const char *scope_names[] = {"global", "local"};
+
+/// where the requests of a point come from
+struct SOURCE{
+	/// the name of the source in the report
+	char name[LINE_LEN];
+	/// the addresses of a pattern, NULL for a trace
+	uint16_t *addrs;
+	/// the trace, NULL for a pattern
+	isu_mem_trace_t trace;
+	/// the number of requests
+	uint64_t count;
+};
+
+/// one dimension of the grid
+struct DIMENSION{
+	/// the values
+	unsigned long long values[MAX_VALUES];
+	/// the number of entries in `values`
+	int n;
+};
+
+/// one point of the grid and its results
+struct POINT{
+	int mode;
+	int source;
+	unsigned int l1;
+	unsigned int l2;
+	unsigned int ram;
+	unsigned int page_size;
+	unsigned int ways;
+	unsigned int wbuf;
+	unsigned int tlb;
+	int prefetch;
+	unsigned int procs;
+	int scope;
+	unsigned int walk;
+	unsigned int pwc;
+	unsigned int spread;
+	unsigned int huge;
+	unsigned int promote;
+	unsigned int cores;
+	unsigned int mshr;
+	unsigned int sample;
+	/// the requests found in each level, then the ones that went to disk,
+	/// scaled up to the whole source if the point is sampled
+	unsigned long long level_hits[4];
+	/// the requests simulated, fewer than the source if it is sampled
+	unsigned long long sampled;
+	/// the 95% error of the hit rate of L1 and of the share of the
+	/// requests that went to disk, 0 if the point isn't sampled
+	double hit_err;
+	double disk_err;
+	/// the dirty pages written back to disk
+	unsigned long long writebacks;
+	/// the lookups of the TLB and the ones that found their translation
+	unsigned long long tlb_lookups;
+	unsigned long long tlb_hits;
+	/// the prefetches of the point
+	isu_mmu_prefetch_stats_t pf;
+	/// the page walks of the point
+	isu_mmu_walk_stats_t walks;
+	/// the huge pages of the point
+	isu_mmu_huge_stats_t huges;
+	/// the counters of every core added up, `time` being the time of
+	/// every core's clock
+	isu_multicore_stats_t core_stats;
+	/// the misses of the point the MSHRs held
+	isu_mmu_mshr_stats_t mshrs;
+	/// the latency half, 99% and 99.9% of the accesses took at most
+	unsigned long long p50;
+	unsigned long long p99;
+	unsigned long long p999;
+	/// the simulated time taken by the requests
+	unsigned long long sim_time;
+	/// the real time taken by the point
+	unsigned long long wall_ns;
+	/// 0 if the point ran, -1 if it failed
+	int status;
+};
+
+/// the whole sweep, shared by the workers
+struct SWEEP{
+	struct SOURCE *sources;
+	int n_sources;
+	struct POINT *points;
+	int n_points;
+	/// the next point to hand out
+	int next;
+};
+
+/// gets the current time in nanoseconds
+static unsigned long long now_ns(void){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/// sets the MMU of a point up the way the point asks for
+static int setup_mmu(isu_mmu_t mmu, const struct POINT *p, unsigned int procs){
+	isu_mmu_tlb_desc_t tlb = {p->tlb, 0, ISU_TLB_LRU, TLB_HIT_DELAY, TLB_MISS_DELAY};
+	isu_mmu_walk_desc_t walk = {p->walk, p->pwc};
+	isu_mmu_huge_desc_t huge = {p->huge, p->promote, HUGE_TLB_ENTRIES};
+	if(isu_mmu_set_write_buffer(mmu, p->wbuf) < 0 || (p->tlb && isu_mmu_set_tlb(mmu, &tlb) < 0) ||
+	   isu_mmu_set_prefetcher(mmu, p->prefetch, PREFETCH_DEGREE) < 0 ||
+	   (procs && isu_mmu_set_page_tables(mmu, p->scope) < 0) ||
+	   (p->walk && isu_mmu_set_page_walk(mmu, &walk) < 0) ||
+	   (p->huge && isu_mmu_set_huge_pages(mmu, &huge) < 0) || isu_mmu_set_mshrs(mmu, p->mshr) < 0){
+		return -1;
+	}
+	return 0;
+}
+
+/// copies the latency percentiles of `mmu` to `p`
+static void get_latency(isu_mmu_t mmu, struct POINT *p){
+	isu_mmu_stats_t stats;
+	isu_mmu_get_stats(mmu, &stats);
+	p->p50 = stats.p50;
+	p->p99 = stats.p99;
+	p->p999 = stats.p999;
+}
+
+/// runs the requests of one point on `p->cores` cores, core c replaying the
+/// source from request c * count / cores on, wrapping around, so the cores
+/// are at different phases of the same program
+static int run_cores(struct SWEEP *s, struct POINT *p){
+	unsigned int c;
+	uint64_t i;
+	uint64_t j;
+	int ret = -1;
+	unsigned long long hits[4] = {0, 0, 0, 0};
+	unsigned long long t = 0;
+	struct SOURCE *src = &s->sources[p->source];
+	size_t count = (size_t)src->count;
+	int rw = src->trace && isu_mem_trace_has_rw(src->trace);
+	uint64_t *addrs = malloc(count * sizeof(uint64_t) + 1);
+	uint8_t *writes = malloc(count + 1);
+	isu_multicore_stream_t *streams = calloc(p->cores, sizeof(isu_multicore_stream_t));
+	isu_mmu_batch_result_t *results = calloc(p->cores, sizeof(isu_mmu_batch_result_t));
+	isu_multicore_stats_t cs;
+	isu_mmu_write_stats_t ws;
+	isu_mmu_tlb_stats_t ts;
+	isu_multicore_t mc;
+	isu_mmu_level_desc_t levels[3] = {
+		{p->l1, L1_DELAY, p->page_size, p->ways},
+		{p->l2, L2_DELAY, p->page_size, p->ways},
+		{p->ram, RAM_DELAY, p->page_size, 0}
+	};
+
+	mc = isu_multicore_create(p->mode, p->cores, levels, 3, DISK_DELAY);
+	if(mc == NULL || addrs == NULL || writes == NULL || streams == NULL || results == NULL ||
+	   setup_mmu(isu_multicore_get_shared(mc), p, 0) < 0){
+		goto done;
+	}
+	/// traces keep their full addresses, each core has an address space
+	/// of its own
+	if(src->addrs){
+		for(i = 0; i < count; i++){
+			addrs[i] = src->addrs[i];
+		}
+	}else{
+		isu_mem_trace_read64(src->trace, 0, addrs, count);
+		if(rw){
+			isu_mem_trace_read_rw(src->trace, 0, writes, count);
+		}
+	}
+	for(i = 0; p->spread && i < count; i++){
+		addrs[i] = ((addrs[i] / p->page_size) << p->spread) * p->page_size + addrs[i] % p->page_size;
+	}
+	for(c = 0; c < p->cores; c++){
+		streams[c].addrs = malloc(count * sizeof(uint64_t) + 1);
+		streams[c].writes = rw ? malloc(count + 1) : NULL;
+		results[c].level = malloc(count * sizeof(int8_t) + 1);
+		streams[c].n = count;
+		streams[c].results = &results[c];
+		if(streams[c].addrs == NULL || (rw && streams[c].writes == NULL) || results[c].level == NULL){
+			goto done;
+		}
+		for(i = 0; i < count; i++){
+			j = (i + (uint64_t)c * count / p->cores) % count;
+			((uint64_t *)streams[c].addrs)[i] = addrs[j];
+			if(rw){
+				((uint8_t *)streams[c].writes)[i] = writes[j];
+			}
+		}
+	}
+	if(isu_multicore_run(mc, streams, &t) < 0){
+		goto done;
+	}
+	for(c = 0; c < p->cores; c++){
+		for(i = 0; i < count; i++){
+			hits[results[c].level[i] < 0 ? 3 : results[c].level[i]]++;
+		}
+		isu_multicore_get_stats(mc, c, &cs);
+		p->core_stats.conflicts += cs.conflicts;
+		p->core_stats.wait_time += cs.wait_time;
+		p->core_stats.evicted += cs.evicted;
+		p->core_stats.writebacks += cs.writebacks;
+		p->core_stats.shared_accesses += cs.shared_accesses;
+		p->core_stats.time += cs.time;
+	}
+	memcpy(p->level_hits, hits, sizeof(hits));
+	p->sampled = (unsigned long long)count * p->cores;
+	/// the rest of the counters are of the shared levels
+	isu_mmu_get_write_stats(isu_multicore_get_shared(mc), &ws);
+	p->writebacks = ws.writebacks;
+	isu_mmu_get_tlb_stats(isu_multicore_get_shared(mc), &ts);
+	p->tlb_lookups = ts.hits + ts.misses;
+	p->tlb_hits = ts.hits;
+	isu_mmu_get_prefetch_stats(isu_multicore_get_shared(mc), &p->pf);
+	isu_mmu_get_walk_stats(isu_multicore_get_shared(mc), &p->walks);
+	isu_mmu_get_huge_stats(isu_multicore_get_shared(mc), &p->huges);
+	get_latency(isu_multicore_get_shared(mc), p);
+	p->sim_time = t;
+	ret = 0;
+done:
+	for(c = 0; streams && c < p->cores; c++){
+		free((uint64_t *)streams[c].addrs);
+		free((uint8_t *)streams[c].writes);
+	}
+	for(c = 0; results && c < p->cores; c++){
+		free(results[c].level);
+	}
+	free(streams);
+	free(results);
+	free(addrs);
+	free(writes);
+	isu_multicore_destroy(mc);
+	return ret;
+}
+
+/// the page a sampler hashes for a request, each process's pages apart
+static uint64_t sample_key(uint64_t addr, unsigned int asid, unsigned int page_size){
+	return addr / page_size ^ (uint64_t)asid << 56;
+}
+
+/// scales the capacities of `p` down for the sampled requests
+static void sample_point(isu_sampler_t sampler, struct POINT *p){
+	p->l1 = isu_sampler_scale(sampler, p->l1, p->ways);
+	p->l2 = isu_sampler_scale(sampler, p->l2, p->ways);
+	p->ram = isu_sampler_scale(sampler, p->ram, 0);
+	p->wbuf = isu_sampler_scale(sampler, p->wbuf, 0);
+	p->tlb = isu_sampler_scale(sampler, p->tlb, 0);
+}
+
+/// scales the level counts of the sampled requests up to the whole source
+/// and puts the errors of the estimates in `p`
+static void sample_results(isu_sampler_t sampler, struct POINT *p, uint64_t count){
+	isu_sampler_estimate_t est;
+	int l;
+	for(l = 0; l < 4 && p->sampled; l++){
+		p->level_hits[l] = (unsigned long long)((double)p->level_hits[l] * (double)count / (double)p->sampled + 0.5);
+	}
+	isu_sampler_get_estimate(sampler, 0, &est);
+	p->hit_err = est.error;
+	isu_sampler_get_estimate(sampler, 2, &est);
+	p->disk_err = est.error;
+}
+
+/// runs the requests of one point through a new MMU
+static int run_point(struct SWEEP *s, struct POINT *p, uint16_t *buf, uint64_t *buf64, unsigned int *asids, uint8_t *writes,
+		     isu_mmu_batch_result_t *results){
+	uint64_t first = 0;
+	size_t i;
+	size_t n;
+	int ret;
+	const uint16_t *addrs;
+	uint16_t *future;
+	size_t kept;
+	int group;
+	unsigned long long sampled = 0;
+	isu_mmu_t mmu;
+	isu_mmu_write_stats_t ws;
+	isu_mmu_tlb_stats_t ts;
+	isu_sampler_t sampler = NULL;
+	/// the point with its capacities scaled down if it is sampled
+	struct POINT cfg = *p;
+	struct SOURCE *src = &s->sources[p->source];
+	/// walking, spreading, huge pages and addresses past 16 bits need page
+	/// tables, one process if `procs` didn't ask for more
+	int wide = src->trace && isu_mem_trace_addr_bytes(src->trace) > 2;
+	unsigned int procs = p->procs ? p->procs : p->walk || p->spread || p->huge || wide ? 1 : 0;
+	/// counted here and not in `p`, so workers don't share cache lines
+	unsigned long long hits[4] = {0, 0, 0, 0};
+	unsigned long long t = 0;
+	int rw = src->trace && isu_mem_trace_has_rw(src->trace);
+	isu_mmu_level_desc_t levels[3];
+
+	if(p->cores){
+		return run_cores(s, p);
+	}
+	if(wide && p->mode == 6){
+		printf("Error: %s has addresses wider than 16 bits, which OPT can't replay\n", src->name);
+		return -1;
+	}
+	if(p->sample){
+		sampler = isu_sampler_create(p->sample, 0);
+		if(sampler == NULL){
+			return -1;
+		}
+		sample_point(sampler, &cfg);
+	}
+	levels[0] = (isu_mmu_level_desc_t){cfg.l1, L1_DELAY, p->page_size, p->ways};
+	levels[1] = (isu_mmu_level_desc_t){cfg.l2, L2_DELAY, p->page_size, p->ways};
+	levels[2] = (isu_mmu_level_desc_t){cfg.ram, RAM_DELAY, p->page_size, 0};
+	mmu = isu_mmu_create_ex(p->mode, levels, 3, DISK_DELAY);
+	if(mmu == NULL || setup_mmu(mmu, &cfg, procs) < 0){
+		if(mmu){
+			isu_mmu_destroy(mmu);
+		}
+		isu_sampler_destroy(sampler);
+		return -1;
+	}
+	if(p->mode == 6){
+		/// OPT has to see every request up front
+		future = src->addrs;
+		if(future == NULL){
+			future = malloc((size_t)src->count * sizeof(uint16_t) + 1);
+			if(future == NULL){
+				isu_mmu_destroy(mmu);
+				isu_sampler_destroy(sampler);
+				return -1;
+			}
+			isu_mem_trace_read16(src->trace, 0, future, (size_t)src->count);
+		}
+		isu_mmu_set_future(mmu, future, (unsigned int)src->count);
+		if(future != src->addrs){
+			free(future);
+		}
+	}
+	while(first < src->count){
+		n = src->count - first < CHUNK ? (size_t)(src->count - first) : CHUNK;
+		if(src->addrs){
+			addrs = src->addrs + first;
+		}else{
+			n = isu_mem_trace_read16(src->trace, first, buf, n);
+			addrs = buf;
+			if(rw){
+				isu_mem_trace_read_rw(src->trace, first, writes, n);
+			}
+		}
+		if(procs){
+			/// the processes take turns of QUANTUM requests, each in an
+			/// address space of its own, and traces keep their full
+			/// addresses
+			for(i = 0; i < n; i++){
+				asids[i] = (unsigned int)(((first + i) / QUANTUM) % procs);
+				buf64[i] = addrs[i];
+			}
+			if(src->trace){
+				isu_mem_trace_read64(src->trace, first, buf64, n);
+			}
+			/// pages that were neighbours are `spread` bits apart
+			for(i = 0; p->spread && i < n; i++){
+				buf64[i] = ((buf64[i] / p->page_size) << p->spread) * p->page_size + buf64[i] % p->page_size;
+			}
+			first += n;
+			/// only the requests of sampled pages are kept, moved to the
+			/// front of the chunk
+			if(sampler){
+				for(i = 0, kept = 0; i < n; i++){
+					if(isu_sampler_group(sampler, sample_key(buf64[i], asids[i], p->page_size)) >= 0){
+						buf64[kept] = buf64[i];
+						asids[kept] = asids[i];
+						writes[kept++] = rw ? writes[i] : 0;
+					}
+				}
+				n = kept;
+			}
+			ret = isu_mmu_handle_batch64(mmu, asids, buf64, rw ? writes : NULL, n, results, &t);
+		}else{
+			first += n;
+			if(sampler){
+				for(i = 0, kept = 0; i < n; i++){
+					if(isu_sampler_group(sampler, sample_key(addrs[i], 0, p->page_size)) >= 0){
+						buf[kept] = addrs[i];
+						writes[kept++] = rw ? writes[i] : 0;
+					}
+				}
+				addrs = buf;
+				n = kept;
+			}
+			ret = isu_mmu_handle_batch(mmu, addrs, rw ? writes : NULL, n, results, &t);
+		}
+		if(ret < 0){
+			isu_mmu_destroy(mmu);
+			isu_sampler_destroy(sampler);
+			return -1;
+		}
+		for(i = 0; i < n; i++){
+			hits[results->level[i] < 0 ? 3 : results->level[i]]++;
+			if(sampler){
+				group = isu_sampler_group(sampler, procs ? sample_key(buf64[i], asids[i], p->page_size) :
+							  sample_key(addrs[i], 0, p->page_size));
+				isu_sampler_record(sampler, group, results->level[i]);
+			}
+		}
+		sampled += n;
+	}
+	memcpy(p->level_hits, hits, sizeof(hits));
+	p->sampled = sampled;
+	if(sampler){
+		sample_results(sampler, p, src->count);
+		isu_sampler_destroy(sampler);
+		/// nothing can be estimated from no requests
+		if(sampled == 0){
+			printf("Error: sample %u of %s caught no pages\n", p->sample, src->name);
+			isu_mmu_destroy(mmu);
+			return -1;
+		}
+	}
+	isu_mmu_get_write_stats(mmu, &ws);
+	p->writebacks = ws.writebacks;
+	isu_mmu_get_tlb_stats(mmu, &ts);
+	p->tlb_lookups = ts.hits + ts.misses;
+	p->tlb_hits = ts.hits;
+	isu_mmu_get_prefetch_stats(mmu, &p->pf);
+	isu_mmu_get_walk_stats(mmu, &p->walks);
+	isu_mmu_get_huge_stats(mmu, &p->huges);
+	isu_mmu_get_mshr_stats(mmu, &p->mshrs);
+	get_latency(mmu, p);
+	p->sim_time = t;
+	isu_mmu_destroy(mmu);
+	return 0;
+}
+
+/// takes points off the grid until there are none left
+static void *worker(void *arg){
+	int i;
+	unsigned long long start;
+	struct SWEEP *s = arg;
+	uint16_t *buf = malloc(CHUNK * sizeof(uint16_t));
+	uint64_t *buf64 = malloc(CHUNK * sizeof(uint64_t));
+	unsigned int *asids = malloc(CHUNK * sizeof(unsigned int));
+	uint8_t *writes = malloc(CHUNK);
+	isu_mmu_batch_result_t results;
+	results.level = malloc(CHUNK * sizeof(int8_t));
+	/// only the level is needed, the latencies add up to the time
+	results.latency = NULL;
+	results.page_size = NULL;
+	results.issue = NULL;
+	if(buf == NULL || buf64 == NULL || asids == NULL || writes == NULL || results.level == NULL){
+		perror("Malloc encountered an error");
+		free(buf);
+		free(buf64);
+		free(asids);
+		free(writes);
+		free(results.level);
+		return NULL;
+	}
+	while((i = __sync_fetch_and_add(&s->next, 1)) < s->n_points){
+		start = now_ns();
+		s->points[i].status = run_point(s, &s->points[i], buf, buf64, asids, writes, &results);
+		s->points[i].wall_ns = now_ns() - start;
+	}
+	free(buf);
+	free(buf64);
+	free(asids);
+	free(writes);
+	free(results.level);
+	return NULL;
+}
+
+/// parses the values of a line of the spec into `d`
+static int parse_values(char *values, struct DIMENSION *d){
+	char *tok;
+	char *end;
+	d->n = 0;
+	for(tok = strtok(values, " \t\r\n"); tok; tok = strtok(NULL, " \t\r\n")){
+		if(d->n == MAX_VALUES){
+			printf("Error: more than %d values\n", MAX_VALUES);
+			return -1;
+		}
+		d->values[d->n++] = strtoull(tok, &end, 0);
+		if(*end != '\0'){
+			printf("Error: %s is not a number\n", tok);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+/// adds a source to the sweep
+static struct SOURCE *add_source(struct SWEEP *s, const char *name){
+	struct SOURCE *src = realloc(s->sources, (s->n_sources + 1) * sizeof(struct SOURCE));
+	if(src == NULL){
+		perror("Malloc encountered an error");
+		return NULL;
+	}
+	s->sources = src;
+	src = &s->sources[s->n_sources++];
+	memset(src, 0, sizeof(struct SOURCE));
+	snprintf(src->name, sizeof(src->name), "%s", name);
+	return src;
+}
+
+/// the share of prefetches that were used
+static double accuracy(const isu_mmu_prefetch_stats_t *pf){
+	return pf->issued ? (double)pf->useful / (double)pf->issued : 0.;
+}
+
+/// the share of would be L1 misses that a prefetch saved
+static double coverage(const isu_mmu_prefetch_stats_t *pf){
+	return pf->useful + pf->misses ? (double)pf->useful / (double)(pf->useful + pf->misses) : 0.;
+}
+
+/// the share of the simulated time spent walking page tables, the walks
+/// of cores taking time on the clock of each core
+static double walk_share(const struct POINT *p){
+	unsigned long long time = p->cores ? p->core_stats.time : p->sim_time;
+	return time ? (double)p->walks.time / (double)time : 0.;
+}
+
+/// the share of the lookups of the TLB that hit
+static double tlb_hit_rate(const struct POINT *p){
+	return p->tlb_lookups ? (double)p->tlb_hits / (double)p->tlb_lookups : 0.;
+}
+
+/// the share of the accesses of the MMU that were to huge pages, the MMU
+/// of cores seeing only the accesses of the shared levels
+static double huge_share(const struct POINT *p){
+	unsigned long long accesses = p->cores ? p->core_stats.shared_accesses : p->sampled;
+	return accesses ? (double)p->huges.accesses / (double)accesses : 0.;
+}
+
+/// the share of the backing space reserved for huge pages that is unused
+static double fragmentation(const isu_mmu_huge_stats_t *h){
+	return h->reserved ? (double)(h->reserved - h->used + h->gaps) / (double)(h->reserved + h->gaps) : 0.;
+}
+
+/// the misses in flight on average
+static double mlp(const struct POINT *p){
+	return p->sim_time ? (double)p->mshrs.serial_time / (double)p->sim_time : 0.;
+}
+
+/// writes the report as CSV
+static void print_csv(FILE *file, struct SWEEP *s){
+	int i;
+	struct POINT *p;
+	uint64_t count;
+	fprintf(file, "mode,source,l1,l2,ram,page_size,ways,wbuf,tlb,prefetch,procs,scope,walk,pwc,spread,huge,promote,cores,mshr,sample,requests,sampled,l1_hits,l2_hits,"
+		"ram_hits,disk,hit_rate,hit_rate_err,disk_rate_err,tlb_hit_rate,writebacks,prefetches,pf_accuracy,pf_coverage,pt_nodes,walk_reads,walk_share,promotions,huge_share,"
+		"fragmentation,port_conflicts,port_wait_ns,cross_evictions,mshr_stalls,mlp,p50_ns,p99_ns,p999_ns,sim_time_ns,wall_ns,status\n");
+	for(i = 0; i < s->n_points; i++){
+		p = &s->points[i];
+		/// every core replays the whole source
+		count = s->sources[p->source].count * (p->cores ? p->cores : 1);
+		fprintf(file, "%s,%s,%u,%u,%u,%u,%u,%u,%u,%d,%u,%s,%u,%u,%u,%u,%u,%u,%u,%u,%llu,%llu,%llu,%llu,%llu,%llu,%f,%f,%f,%f,%llu,%llu,%f,%f,"
+			"%llu,%llu,%f,"
+			"%llu,%f,%f,%llu,%llu,%llu,%llu,%f,%llu,%llu,%llu,%llu,%llu,%s\n",
+			mode_names[p->mode], s->sources[p->source].name,
+			p->l1, p->l2, p->ram, p->page_size, p->ways, p->wbuf, p->tlb, p->prefetch, p->procs, scope_names[p->scope],
+			p->walk, p->pwc, p->spread, p->huge, p->promote, p->cores, p->mshr, p->sample, (unsigned long long)count,
+			p->sampled, p->level_hits[0], p->level_hits[1], p->level_hits[2], p->level_hits[3],
+			count ? (double)p->level_hits[0] / (double)count : 0., p->hit_err, p->disk_err,
+			tlb_hit_rate(p),
+			p->writebacks, p->pf.issued, accuracy(&p->pf), coverage(&p->pf),
+			p->walks.nodes, p->walks.reads, walk_share(p),
+			p->huges.promotions, huge_share(p), fragmentation(&p->huges),
+			p->core_stats.conflicts, p->core_stats.wait_time, p->core_stats.evicted, p->mshrs.stalls, mlp(p), p->p50, p->p99, p->p999,
+			p->sim_time, p->wall_ns, p->status ? "failed" : "ok");
+	}
+}
+
+/// writes the report as JSON
+static void print_json(FILE *file, struct SWEEP *s){
+	int i;
+	struct POINT *p;
+	uint64_t count;
+	fprintf(file, "[\n");
+	for(i = 0; i < s->n_points; i++){
+		p = &s->points[i];
+		/// every core replays the whole source
+		count = s->sources[p->source].count * (p->cores ? p->cores : 1);
+		fprintf(file, "\t{\"mode\": \"%s\", \"source\": \"%s\", \"l1\": %u, \"l2\": %u, \"ram\": %u, \"page_size\": %u, "
+			"\"ways\": %u, \"wbuf\": %u, \"tlb\": %u, \"prefetch\": %d, "
+			"\"procs\": %u, \"scope\": \"%s\", \"walk\": %u, \"pwc\": %u, \"spread\": %u, \"huge\": %u, \"promote\": %u, "
+			"\"cores\": %u, \"mshr\": %u, \"sample\": %u, "
+			"\"requests\": %llu, \"sampled\": %llu, \"l1_hits\": %llu, \"l2_hits\": %llu, \"ram_hits\": %llu, \"disk\": %llu, "
+			"\"hit_rate\": %f, \"hit_rate_err\": %f, \"disk_rate_err\": %f, \"tlb_hit_rate\": %f, \"writebacks\": %llu, "
+			"\"prefetches\": %llu, \"pf_accuracy\": %f, \"pf_coverage\": %f, "
+			"\"pt_nodes\": %llu, \"walk_reads\": %llu, \"walk_share\": %f, "
+			"\"promotions\": %llu, \"huge_share\": %f, \"fragmentation\": %f, "
+			"\"port_conflicts\": %llu, \"port_wait_ns\": %llu, \"cross_evictions\": %llu, "
+			"\"mshr_stalls\": %llu, \"mlp\": %f, \"p50_ns\": %llu, \"p99_ns\": %llu, \"p999_ns\": %llu, "
+			"\"sim_time_ns\": %llu, \"wall_ns\": %llu, \"status\": \"%s\"}%s\n",
+			mode_names[p->mode], s->sources[p->source].name,
+			p->l1, p->l2, p->ram, p->page_size, p->ways, p->wbuf, p->tlb, p->prefetch, p->procs, scope_names[p->scope],
+			p->walk, p->pwc, p->spread, p->huge, p->promote, p->cores, p->mshr, p->sample, (unsigned long long)count,
+			p->sampled, p->level_hits[0], p->level_hits[1], p->level_hits[2], p->level_hits[3],
+			count ? (double)p->level_hits[0] / (double)count : 0., p->hit_err, p->disk_err,
+			tlb_hit_rate(p),
+			p->writebacks, p->pf.issued, accuracy(&p->pf), coverage(&p->pf),
+			p->walks.nodes, p->walks.reads, walk_share(p),
+			p->huges.promotions, huge_share(p), fragmentation(&p->huges),
+			p->core_stats.conflicts, p->core_stats.wait_time, p->core_stats.evicted, p->mshrs.stalls, mlp(p), p->p50, p->p99, p->p999,
+			p->sim_time, p->wall_ns, p->status ? "failed" : "ok",
+			i + 1 < s->n_points ? "," : "");
+	}
+	fprintf(file, "]\n");
+}
+
+int main(int argc, char **argv){
+	FILE *file;
+	char line[LINE_LEN];
+	char *key;
+	char *values;
+	char *tok;
+	int i;
+	int a, b, c, d, e, f, g, h, k, m, o, q, r, u, w, x, y, z, v, l;
+	int n_threads;
+	int json;
+	unsigned long long start;
+	pthread_t *threads;
+	struct SOURCE *src;
+	struct SWEEP sweep;
+	struct DIMENSION modes = {{0, 1, 2}, 3};
+	struct DIMENSION patterns = {{0}, 0};
+	struct DIMENSION requests = {{1000}, 1};
+	struct DIMENSION l1 = {{4}, 1};
+	struct DIMENSION l2 = {{8}, 1};
+	struct DIMENSION ram = {{32}, 1};
+	struct DIMENSION page = {{4096}, 1};
+	struct DIMENSION ways = {{0}, 1};
+	struct DIMENSION wbuf = {{0}, 1};
+	struct DIMENSION tlb = {{0}, 1};
+	struct DIMENSION prefetch = {{0}, 1};
+	struct DIMENSION procs = {{0}, 1};
+	struct DIMENSION scope = {{ISU_MMU_GLOBAL}, 1};
+	struct DIMENSION walk = {{0}, 1};
+	struct DIMENSION pwc = {{0}, 1};
+	struct DIMENSION spread = {{0}, 1};
+	struct DIMENSION huge = {{0}, 1};
+	struct DIMENSION promote = {{1}, 1};
+	struct DIMENSION cores = {{0}, 1};
+	struct DIMENSION mshr = {{0}, 1};
+	struct DIMENSION sample = {{0}, 1};
+	struct DIMENSION threads_dim = {{0}, 0};
+	struct DIMENSION *dim;
+
+	if(argc < 3){
+		printf("usage: mem_sweep <grid spec> <report.csv | report.json>\n\n");
+		printf("grid spec:\tone `key = values` line for each of mode, pattern,\n");
+		printf("\t\ttrace, requests, l1, l2, ram, page, ways, wbuf, tlb, prefetch,\n");
+		printf("\t\tprocs, scope, walk, pwc, spread, huge, promote, cores, mshr,\n");
+		printf("\t\tsample and threads.\n");
+		return -1;
+	}
+	memset(&sweep, 0, sizeof(sweep));
+	file = fopen(argv[1], "r");
+	if(file == NULL){
+		perror("Could not open the grid spec");
+		return -1;
+	}
+	while(fgets(line, sizeof(line), file)){
+		if((tok = strchr(line, '#')) != NULL){
+			*tok = '\0';
+		}
+		values = strchr(line, '=');
+		if(values != NULL){
+			*values++ = '\0';
+		}
+		key = strtok(line, " \t\r\n");
+		if(key == NULL){
+			continue;
+		}
+		if(values == NULL){
+			printf("Error: `%s` in the grid spec has no values\n", key);
+			return -1;
+		}
+		if(strcmp(key, "trace") == 0){
+			for(tok = strtok(values, " \t\r\n"); tok; tok = strtok(NULL, " \t\r\n")){
+				if((src = add_source(&sweep, tok)) == NULL){
+					return -1;
+				}
+				src->trace = isu_mem_trace_open(tok);
+				if(src->trace == NULL){
+					printf("Error: %s is not a trace file\n", tok);
+					return -1;
+				}
+				src->count = isu_mem_trace_count(src->trace);
+			}
+			continue;
+		}
+		dim = strcmp(key, "mode") == 0 ? &modes :
+			strcmp(key, "pattern") == 0 ? &patterns :
+			strcmp(key, "requests") == 0 ? &requests :
+			strcmp(key, "l1") == 0 ? &l1 :
+			strcmp(key, "l2") == 0 ? &l2 :
+			strcmp(key, "ram") == 0 ? &ram :
+			strcmp(key, "page") == 0 ? &page :
+			strcmp(key, "ways") == 0 ? &ways :
+			strcmp(key, "wbuf") == 0 ? &wbuf :
+			strcmp(key, "tlb") == 0 ? &tlb :
+			strcmp(key, "prefetch") == 0 ? &prefetch :
+			strcmp(key, "procs") == 0 ? &procs :
+			strcmp(key, "scope") == 0 ? &scope :
+			strcmp(key, "walk") == 0 ? &walk :
+			strcmp(key, "pwc") == 0 ? &pwc :
+			strcmp(key, "spread") == 0 ? &spread :
+			strcmp(key, "huge") == 0 ? &huge :
+			strcmp(key, "promote") == 0 ? &promote :
+			strcmp(key, "cores") == 0 ? &cores :
+			strcmp(key, "mshr") == 0 ? &mshr :
+			strcmp(key, "sample") == 0 ? &sample :
+			strcmp(key, "threads") == 0 ? &threads_dim : NULL;
+		if(dim == NULL){
+			printf("Error: unknown key `%s` in the grid spec\n", key);
+			return -1;
+		}
+		if(parse_values(values, dim) < 0){
+			return -1;
+		}
+	}
+	fclose(file);
+
+	for(i = 0; i < modes.n; i++){
+		if(modes.values[i] > 6){
+			printf("Error: mode %llu is not a replacement mode\n", modes.values[i]);
+			return -1;
+		}
+	}
+	for(i = 0; i < prefetch.n; i++){
+		if(prefetch.values[i] != 0 && isu_mmu_prefetcher_get((int)prefetch.values[i]) == NULL){
+			printf("Error: prefetch %llu is not a prefetcher\n", prefetch.values[i]);
+			return -1;
+		}
+	}
+	for(i = 0; i < scope.n; i++){
+		if(scope.values[i] != ISU_MMU_GLOBAL && scope.values[i] != ISU_MMU_LOCAL){
+			printf("Error: scope %llu is not a replacement scope\n", scope.values[i]);
+			return -1;
+		}
+	}
+	for(i = 0; i < walk.n; i++){
+		if(walk.values[i] == 1 || walk.values[i] > 4){
+			printf("Error: walk %llu is not 0 or 2 to 4 levels\n", walk.values[i]);
+			return -1;
+		}
+	}
+	for(i = 0; i < spread.n; i++){
+		if(spread.values[i] > 48){
+			printf("Error: spread %llu is more than 48 bits\n", spread.values[i]);
+			return -1;
+		}
+	}
+	/// the patterns are generated once and shared by every worker
+	for(i = 0; i < patterns.n; i++){
+		if(isu_mem_pattern_name((int)patterns.values[i]) == NULL){
+			printf("Error: pattern %llu is not a pattern\n", patterns.values[i]);
+			return -1;
+		}
+		for(a = 0; a < requests.n; a++){
+			snprintf(line, sizeof(line), "%s-%llu", isu_mem_pattern_name((int)patterns.values[i]), requests.values[a]);
+			if((src = add_source(&sweep, line)) == NULL){
+				return -1;
+			}
+			src->count = requests.values[a];
+			src->addrs = malloc((size_t)src->count * sizeof(uint16_t) + 1);
+			if(src->addrs == NULL){
+				perror("Malloc encountered an error");
+				return -1;
+			}
+			isu_mem_pattern_fill((int)patterns.values[i], src->addrs, (size_t)src->count, 12345);
+		}
+	}
+	if(sweep.n_sources == 0){
+		printf("Error: the grid spec has no pattern or trace\n");
+		return -1;
+	}
+
+	sweep.n_points = modes.n * sweep.n_sources * l1.n * l2.n * ram.n * page.n * ways.n * wbuf.n * tlb.n * prefetch.n * procs.n * scope.n *
+		walk.n * pwc.n * spread.n * huge.n * promote.n * cores.n * mshr.n * sample.n;
+	sweep.points = calloc(sweep.n_points, sizeof(struct POINT));
+	if(sweep.points == NULL){
+		perror("Malloc encountered an error");
+		return -1;
+	}
+	i = 0;
+	for(a = 0; a < modes.n; a++)
+	for(b = 0; b < sweep.n_sources; b++)
+	for(c = 0; c < l1.n; c++)
+	for(d = 0; d < l2.n; d++)
+	for(e = 0; e < ram.n; e++)
+	for(f = 0; f < page.n; f++)
+	for(g = 0; g < ways.n; g++)
+	for(h = 0; h < wbuf.n; h++)
+	for(k = 0; k < tlb.n; k++)
+	for(m = 0; m < prefetch.n; m++)
+	for(o = 0; o < procs.n; o++)
+	for(q = 0; q < scope.n; q++)
+	for(r = 0; r < walk.n; r++)
+	for(u = 0; u < pwc.n; u++)
+	for(w = 0; w < spread.n; w++)
+	for(x = 0; x < huge.n; x++)
+	for(y = 0; y < promote.n; y++)
+	for(z = 0; z < cores.n; z++)
+	for(v = 0; v < mshr.n; v++)
+	for(l = 0; l < sample.n; l++){
+		sweep.points[i].mode = (int)modes.values[a];
+		sweep.points[i].source = b;
+		sweep.points[i].l1 = (unsigned int)l1.values[c];
+		sweep.points[i].l2 = (unsigned int)l2.values[d];
+		sweep.points[i].ram = (unsigned int)ram.values[e];
+		sweep.points[i].page_size = (unsigned int)page.values[f];
+		sweep.points[i].ways = (unsigned int)ways.values[g];
+		sweep.points[i].wbuf = (unsigned int)wbuf.values[h];
+		sweep.points[i].tlb = (unsigned int)tlb.values[k];
+		sweep.points[i].prefetch = (int)prefetch.values[m];
+		sweep.points[i].procs = (unsigned int)procs.values[o];
+		sweep.points[i].scope = (int)scope.values[q];
+		sweep.points[i].walk = (unsigned int)walk.values[r];
+		sweep.points[i].pwc = (unsigned int)pwc.values[u];
+		sweep.points[i].spread = (unsigned int)spread.values[w];
+		sweep.points[i].huge = (unsigned int)huge.values[x];
+		sweep.points[i].promote = (unsigned int)promote.values[y];
+		sweep.points[i].cores = (unsigned int)cores.values[z];
+		sweep.points[i].mshr = (unsigned int)mshr.values[v];
+		sweep.points[i].sample = (unsigned int)sample.values[l];
+		/// OPT and cores see every request
+		if(sweep.points[i].mode == 6 || sweep.points[i].cores){
+			sweep.points[i].sample = 0;
+		}
+		i++;
+	}
+
+	n_threads = threads_dim.n ? (int)threads_dim.values[0] : (int)sysconf(_SC_NPROCESSORS_ONLN);
+	if(n_threads < 1){
+		n_threads = 1;
+	}
+	if(n_threads > sweep.n_points){
+		n_threads = sweep.n_points;
+	}
+	threads = malloc(n_threads * sizeof(pthread_t));
+	if(threads == NULL){
+		perror("Malloc encountered an error");
+		return -1;
+	}
+	start = now_ns();
+	for(i = 0; i < n_threads; i++){
+		if(pthread_create(&threads[i], NULL, worker, &sweep) != 0){
+			perror("Could not start a worker");
+			n_threads = i;
+			break;
+		}
+	}
+	for(i = 0; i < n_threads; i++){
+		pthread_join(threads[i], NULL);
+	}
+	printf("ran %d points on %d threads in %.3f seconds\n", sweep.n_points, n_threads, (double)(now_ns() - start) / 1e9);
+
+	json = strlen(argv[2]) > 5 && strcmp(argv[2] + strlen(argv[2]) - 5, ".json") == 0;
+	file = fopen(argv[2], "w");
+	if(file == NULL){
+		perror("Could not open the report");
+		return -1;
+	}
+	if(json){
+		print_json(file, &sweep);
+	}else{
+		print_csv(file, &sweep);
+	}
+	fclose(file);
+
+	for(i = 0; i < sweep.n_sources; i++){
+		free(sweep.sources[i].addrs);
+		if(sweep.sources[i].trace){
+			isu_mem_trace_close(sweep.sources[i].trace);
+		}
+	}
+	free(sweep.sources);
+	free(sweep.points);
+	free(threads);
+	return 0;
+}
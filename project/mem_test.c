@@ -5,22 +5,92 @@
 #include "llist/isu_llist.h"
 #include "page_req/isu_mem_req.h"
 #include "isu_mmu/isu_mmu.h"
+#include "isu_mmu/isu_stack_dist.h"
+#include "isu_mmu/isu_working_set.h"
+#include "isu_mmu/isu_tlb.h"
+#include "isu_mmu/isu_mmu_prefetch.h"
+#include "page_req/isu_mem_trace.h"
+#include "page_req/isu_mem_pattern.h"
+#include "page_req/isu_mem_log.h"
 #include "common/isu_types.h"
 #include "common/isu_error.h"
 
+/// the number of requests of a trace handled at a time
+#define TRACE_CHUNK 65536
+/// the most pages a prefetcher asks for after one request
+#define TEST_PREFETCH_DEGREE 2
+/// the entries of the page walk cache of each level of the page table
+#define TEST_PWC_ENTRIES 4
+/// the translations of huge pages the TLB holds apart from the other pages
+#define TEST_HUGE_TLB_ENTRIES 2
+/// the most memory requests of a pattern allocated at once
+#define TEST_POOL_SLAB 4096
+/// the bytes of the name of a log, with its extension
+#define TEST_NAME_LEN 25
+
+/// the TLB in front of every MMU, its lookups are only counted and take no
+/// time, so the times in the logs are those of the hierarchy alone, along
+/// with the page walks of its misses if the page table is walked
+static const isu_mmu_tlb_desc_t test_tlb = {2, 0, ISU_TLB_LRU, 0, 0};
+
 struct TEST_FRAMEWORK{
 	/// list of memory requests
 	isu_llist_t mem_list;
+	/// the pool the memory requests of `mem_list` come from
+	isu_mem_req_pool_t pool;
 	/// the current time
 	unsigned long long current_time;
+	/// the number of memory requests
+	unsigned long long count;
 	/// the number of misses
 	int misses;
+	/// the number of misses of the optimal(OPT) replacement
+	int opt_misses;
+	/// the lookups of the TLB
+	isu_mmu_tlb_stats_t tlb;
+	/// the prefetcher of the MMU, 0 if there is none
+	int prefetcher;
+	/// the prefetches of the MMU
+	isu_mmu_prefetch_stats_t prefetch;
+	/// the working set of the requests, NULL if it isn't measured
+	isu_working_set_t ws;
+	/// the window of `ws`
+	unsigned long long tau;
+	/// the levels of the page table walked on a TLB miss, 0 if it isn't
+	unsigned int depth;
+	/// the page walks of the MMU
+	isu_mmu_walk_stats_t walk;
+	/// the size of a huge page, 0 if there are none
+	unsigned int huge;
+	/// the size of the other pages
+	unsigned int page_size;
+	/// the huge pages of the MMU
+	isu_mmu_huge_stats_t huges;
+	/// the format the requests are logged in, one of the ISU_MEM_LOG_ formats
+	int format;
 };
 
-struct TEST_FRAMEWORK *init_test_framework(int pattern);
+struct TEST_FRAMEWORK *init_test_framework(int pattern, unsigned long long count);
 void run_test_framework(struct TEST_FRAMEWORK *f, int mode, isu_mmu_t MMU);
-void print_test_framework(struct TEST_FRAMEWORK *f, char *name);
+int future_test_framework(struct TEST_FRAMEWORK *f, isu_mmu_t MMU);
+int opt_test_framework(struct TEST_FRAMEWORK *f);
+void print_test_framework(struct TEST_FRAMEWORK *f, char *name, isu_mmu_t MMU);
 void destroy_test_framework(struct TEST_FRAMEWORK *f);
+int run_trace(int mode, const char *path, char *name, unsigned int wbuf, int prefetcher, unsigned long long tau, unsigned int depth,
+	      unsigned int huge, unsigned int mshrs, int format);
+FILE *open_results(const char *name, int format);
+void close_results(FILE *results, FILE *log);
+void print_levels(FILE *file, isu_mem_log_summary_t *summary);
+void print_stats(FILE *file, isu_mmu_t MMU);
+int set_translation(isu_mmu_t MMU, unsigned int depth, unsigned int huge);
+void print_prefetch(FILE *file, int prefetcher, isu_mmu_prefetch_stats_t *stats);
+void print_walk(FILE *file, unsigned int depth, isu_mmu_walk_stats_t *stats, unsigned long long time);
+void print_huge(FILE *file, unsigned int page_size, unsigned int huge, isu_mmu_huge_stats_t *stats, unsigned long long count);
+void print_mshr(FILE *file, unsigned int mshrs, isu_mmu_mshr_stats_t *stats, unsigned long long time);
+int print_working_set(FILE *file, isu_working_set_t ws, unsigned long long tau, const char *name);
+int mrc_test_framework(struct TEST_FRAMEWORK *f, char *name);
+int mrc_trace(const char *path, char *name);
+int print_mrc(isu_stack_dist_t sd, char *name);
 
 int main(int argc, char **argv){
 	/// create frame work
@@ -38,60 +108,159 @@ int main(int argc, char **argv){
 	int i;
 	int mode;
 	int pattern;
-	char *name = calloc(25, sizeof(char));
+	int prefetcher;
+	unsigned long long tau;
+	unsigned int depth;
+	unsigned int huge;
+	unsigned int mshrs;
+	int format;
+	unsigned long long count;
+	char *end;
+	char *name = calloc(TEST_NAME_LEN, sizeof(char));
 	if(name == NULL){
 		perror("Malloc encountered an error");
 		return -1;
 	}
 	//strncpy(name, "answers/", (size_t)8);
 	if(argc < 3){
-		printf("usage: mem_test <mode> <pattern>\n\n");
+		printf("usage: mem_test <mode> <pattern | trace file> [write buffer] [prefetcher] [window] [walk] [huge] [mshr] [format] [requests]\n\n");
 		printf("mode:\t\tspecifies which page replacement algorithm to use.\n");
 		printf("\t\t0 - FIFO\n");
 		printf("\t\t1 - LRU\n");
 		printf("\t\t2 - clock\n");
+		printf("\t\t3 - ARC\n");
+		printf("\t\t4 - 2Q\n");
+		printf("\t\t5 - LIRS\n");
+		printf("\t\t6 - OPT\n");
+		printf("\t\t7 - miss ratio curve of LRU at every L1 size\n");
 		printf("pattern:\tspecifies which memory access pattern to test the\n");
 		printf("\t\talgorithm with.\n");
 		printf("\t\t0 - sequential\n");
 		printf("\t\t1 - random\n");
 		printf("\t\t2 - spatially local\n");
+		printf("\t\t3 - Zipfian hot set\n");
+		printf("\t\t4 - loop through every page\n");
+		printf("\t\t5 - Zipfian hot set changing with each phase\n");
+		printf("\t\t6 - Zipfian hot set mixed with a loop\n");
+		printf("trace file:\ta binary trace to replay, see trace_conv.\n");
+		printf("write buffer:\tpages of write buffer in front of disk for the\n");
+		printf("\t\twrites of a trace, none if not given.\n");
+		printf("prefetcher:\tthe prefetcher filling L1, none if not given.\n");
+		printf("\t\t0 - none\n");
+		printf("\t\t1 - next pages\n");
+		printf("\t\t2 - stride\n");
+		printf("\t\t3 - stream buffers\n");
+		printf("window:\t\trequests the working set is taken over, also the\n");
+		printf("\t\trequests between samples of its size and of the\n");
+		printf("\t\tfaults, which go to <log>.ws. Not measured if not given.\n");
+		printf("walk:\t\tlevels of the page table walked through the hierarchy\n");
+		printf("\t\ton a TLB miss, 2 to 4. Not walked if not given.\n");
+		printf("huge:\t\tbytes of a huge page, regions are promoted to one\n");
+		printf("\t\tonce half of their pages were used. None if not given.\n");
+		printf("mshr:\t\tmisses of a trace in flight at once, one request at a\n");
+		printf("\t\ttime if not given.\n");
+		printf("format:\t\thow each request is logged, text if not given.\n");
+		printf("\t\t0 - a line of text in the log\n");
+		printf("\t\t1 - a binary record in <log>.res\n");
+		printf("\t\t2 - a JSON object in <log>.json\n");
+		printf("\t\t3 - not at all, the log only gets the summary\n");
+		printf("requests:\tthe requests of a pattern, 1000 if not given.\n");
 		return -1;
 	}
 	
 	mode = atoi(argv[1]);
 	/// might not be true if other page replacement algorithms are implemented
-	if(mode < 0 || mode > 4){
+	if(mode < 0 || mode > 7){
 		printf("Error: the value for `mode` is not within the acceptable range\n");
 		return -1;
 	}
-	pattern = atoi(argv[2]);
-	if(pattern < 0 || pattern > 2){
+	pattern = (int)strtol(argv[2], &end, 10);
+	/// anything that isn't a number is the path of a trace
+	if(*end == '\0' && (pattern < 0 || pattern >= ISU_MEM_PATTERN_COUNT)){
 		printf("Error: the value for `pattern` is not within the acceptable range\n");
 		return -1;
 	}
+	prefetcher = argc > 4 ? atoi(argv[4]) : 0;
+	tau = argc > 5 ? strtoull(argv[5], NULL, 10) : 0;
+	depth = argc > 6 ? (unsigned int)atoi(argv[6]) : 0;
+	huge = argc > 7 ? (unsigned int)strtoul(argv[7], NULL, 10) : 0;
+	mshrs = argc > 8 ? (unsigned int)strtoul(argv[8], NULL, 10) : 0;
+	format = argc > 9 ? atoi(argv[9]) : ISU_MEM_LOG_TEXT;
+	count = argc > 10 ? strtoull(argv[10], NULL, 10) : 1000;
+	if(count == 0){
+		printf("Error: the value for `requests` is not within the acceptable range\n");
+		return -1;
+	}
+	if(format < 0 || format >= ISU_MEM_LOG_FORMATS){
+		printf("Error: the value for `format` is not within the acceptable range\n");
+		return -1;
+	}
+	if(prefetcher != 0 && (isu_mmu_prefetcher_get(prefetcher) == NULL || mode >= 6)){
+		printf("Error: the value for `prefetcher` is not within the acceptable range for the mode\n");
+		return -1;
+	}
+	if(depth != 0 && (depth < 2 || depth > 4 || mode >= 6)){
+		printf("Error: the value for `walk` is not within the acceptable range for the mode\n");
+		return -1;
+	}
+	if(huge != 0 && mode >= 6){
+		printf("Error: huge pages can't be used with the mode\n");
+		return -1;
+	}
 
 	if(mode == 0){
 		strncpy(name, "fifo-", (size_t)5);
 	}else if(mode == 1){
 		strncpy(name, "lru-", (size_t)4);
-	}else{
+	}else if(mode == 2){
 		strncpy(name, "clock-", (size_t)6);
+	}else if(mode == 3){
+		strncpy(name, "arc-", (size_t)4);
+	}else if(mode == 4){
+		strncpy(name, "2q-", (size_t)3);
+	}else if(mode == 5){
+		strncpy(name, "lirs-", (size_t)5);
+	}else if(mode == 6){
+		strncpy(name, "opt-", (size_t)4);
+	}else{
+		strncpy(name, "mrc-", (size_t)4);
 	}
 
-	if(pattern == 0){
-		strncat(name, "seqt", (size_t)4);
-	}else if(pattern == 1){
-		strncat(name, "rand", (size_t)4);
-	}else{
-		strncat(name, "spatl", (size_t)5);
+	if(*end != '\0'){
+		snprintf(name + strlen(name), TEST_NAME_LEN - strlen(name), "trace");
+		if(mode == 7){
+			return mrc_trace(argv[2], name);
+		}
+		return run_trace(mode, argv[2], name, argc > 3 ? (unsigned int)atoi(argv[3]) : 0, prefetcher, tau, depth, huge, mshrs, format);
 	}
+
+	snprintf(name + strlen(name), TEST_NAME_LEN - strlen(name), "%s", isu_mem_pattern_name(pattern));
 	
-	struct TEST_FRAMEWORK *frame = init_test_framework(pattern);
+	struct TEST_FRAMEWORK *frame = init_test_framework(pattern, count);
 
-	if(frame != NULL){
+	if(frame != NULL && mode == 7){
+		mrc_test_framework(frame, name);
+		destroy_test_framework(frame);
+	}else if(frame != NULL){
 		isu_mmu_t test_MMU = isu_mmu_create(mode);
+		isu_mmu_set_tlb(test_MMU, &test_tlb);
+		if(isu_mmu_set_prefetcher(test_MMU, prefetcher, TEST_PREFETCH_DEGREE) < 0 || set_translation(test_MMU, depth, huge) < 0){
+			return -1;
+		}
+		frame->prefetcher = prefetcher;
+		frame->tau = tau;
+		frame->depth = depth;
+		frame->huge = huge;
+		frame->format = format;
+		if(tau && (frame->ws = isu_working_set_create(tau, tau)) == NULL){
+			return -1;
+		}
+		if(mode == 6){
+			future_test_framework(frame, test_MMU);
+		}
+		opt_test_framework(frame);
 		run_test_framework(frame, mode, test_MMU);
-		print_test_framework(frame, name);
+		print_test_framework(frame, name, test_MMU);
 		destroy_test_framework(frame);
 	}else{
 		printf("There was an error creating the test framework\n");
@@ -101,53 +270,37 @@ int main(int argc, char **argv){
 	return 0;
 }
 
-struct TEST_FRAMEWORK *init_test_framework(int pattern){
-	int i;
-	int j;
-	isu_mem_req_t temp;
-	isu_llist_t past_elements;
+struct TEST_FRAMEWORK *init_test_framework(int pattern, unsigned long long count){
+	unsigned long long i;
+	uint16_t *addrs = malloc((size_t)count * sizeof(uint16_t));
 	struct TEST_FRAMEWORK *ret;
 
-	srand(12345);
+	if(addrs == NULL){
+		perror("Malloc encountered an error");
+		return NULL;
+	}
+	if(isu_mem_pattern_fill(pattern, addrs, (size_t)count, 12345) < 0){
+		free(addrs);
+		return NULL;
+	}
 
 	ret = calloc(1, sizeof(struct TEST_FRAMEWORK));
 
 	ret->mem_list = isu_llist_create();
+	ret->pool = isu_mem_req_pool_create(count < TEST_POOL_SLAB ? count : TEST_POOL_SLAB);
+	ret->count = count;
 	ret->misses = 0;
 	ret->current_time = 0;
+	if(ret->pool == NULL){
+		free(addrs);
+		destroy_test_framework(ret);
+		return NULL;
+	}
 
-	past_elements = isu_llist_create();
-
-	for(i = 0; i < 1000; i++){
-		switch(pattern){
-		case 0:	temp = isu_mem_req_create((unsigned short)((i * 4096) % 65536));
-			break;
-		case 1: temp = isu_mem_req_create((unsigned short)(rand() % 65536));
-			break;
-		case 2: if(i < 5){
-				temp = isu_mem_req_create((unsigned short)(rand() % 65536));
-				isu_llist_push(past_elements, temp, ISU_LLIST_TAIL);
-			}else{
-				temp = isu_llist_ittr_start(past_elements, ISU_LLIST_TAIL);
-				if((rand() % 100) < 80){
-					j = (rand() % 5);
-					while(j){
-						temp = isu_llist_ittr_next(past_elements);
-						j--;
-					}
-					temp = isu_mem_req_create(isu_mem_req_get_address(temp));
-					isu_llist_pop(past_elements, ISU_LLIST_HEAD);
-					isu_llist_push(past_elements, temp, ISU_LLIST_TAIL);
-				}else{
-					temp = isu_mem_req_create((unsigned short)(rand() % 65536));
-					isu_llist_pop(past_elements, ISU_LLIST_HEAD);
-					isu_llist_push(past_elements, temp, ISU_LLIST_TAIL);
-				}
-			}
-			break;
-		}
-		isu_llist_push(ret->mem_list, temp, ISU_LLIST_TAIL);
+	for(i = 0; i < count; i++){
+		isu_llist_push(ret->mem_list, isu_mem_req_pool_get(ret->pool, addrs[i]), ISU_LLIST_TAIL);
 	}
+	free(addrs);
 
 	return ret;
 }
@@ -163,11 +316,68 @@ void run_test_framework(struct TEST_FRAMEWORK *f, int mode, isu_mmu_t MMU){
 			isu_mmu_ref_clear(MMU);
 		}
 		isu_mmu_handle_req(MMU, t, &(f->current_time));
+		if(f->ws){
+			isu_working_set_access(f->ws, isu_mem_req_get_address(t) / isu_mmu_get_page_size(MMU), !isu_mem_req_get_access_hit(t),
+				isu_mem_req_get_handle_time(t));
+		}
+		t = isu_llist_ittr_next(f->mem_list);
+	}
+	isu_mmu_get_tlb_stats(MMU, &f->tlb);
+	isu_mmu_get_prefetch_stats(MMU, &f->prefetch);
+	isu_mmu_get_walk_stats(MMU, &f->walk);
+	isu_mmu_get_huge_stats(MMU, &f->huges);
+	f->page_size = isu_mmu_get_page_size(MMU);
+}
+
+int future_test_framework(struct TEST_FRAMEWORK *f, isu_mmu_t MMU){
+	/// copy the address of every request into an array for the MMU
+	int ret;
+	unsigned int n = 0;
+	unsigned short *addrs = malloc((isu_llist_count(f->mem_list) + 1) * sizeof(unsigned short));
+	if(addrs == NULL){
+		perror("Malloc encountered an error");
+		return -1;
+	}
+	isu_mem_req_t t = (isu_mem_req_t)isu_llist_ittr_start(f->mem_list, ISU_LLIST_HEAD);
+	while(t){
+		addrs[n++] = (unsigned short)isu_mem_req_get_address(t);
 		t = isu_llist_ittr_next(f->mem_list);
 	}
+	ret = isu_mmu_set_future(MMU, addrs, n);
+	free(addrs);
+	return ret;
 }
 
-void print_test_framework(struct TEST_FRAMEWORK *f, char *name){
+int opt_test_framework(struct TEST_FRAMEWORK *f){
+	/// run the same requests through an OPT MMU of its own, so the hit rate
+	/// of any mode can be compared to the best possible
+	/// each request is only needed until the next, so one slot of a pool
+	/// is used over and over
+	unsigned long long opt_time = 0;
+	isu_mem_req_t req;
+	isu_mem_req_pool_t pool = isu_mem_req_pool_create(1);
+	isu_mmu_t MMU = isu_mmu_create(6);
+	if(pool == NULL || MMU == NULL || future_test_framework(f, MMU) < 0){
+		return -1;
+	}
+	f->opt_misses = 0;
+	isu_mem_req_t t = (isu_mem_req_t)isu_llist_ittr_start(f->mem_list, ISU_LLIST_HEAD);
+	while(t){
+		isu_mem_req_pool_reset(pool);
+		req = isu_mem_req_pool_get(pool, isu_mem_req_get_address(t));
+		isu_mmu_ref_clear(MMU);
+		isu_mmu_handle_req(MMU, req, &opt_time);
+		if(!isu_mem_req_get_access_hit(req)){
+			f->opt_misses++;
+		}
+		t = isu_llist_ittr_next(f->mem_list);
+	}
+	isu_mem_req_pool_destroy(pool);
+	isu_mmu_destroy(MMU);
+	return 0;
+}
+
+void print_test_framework(struct TEST_FRAMEWORK *f, char *name, isu_mmu_t MMU){
 	/// open a file with the name `name`.log
 	/// traverse the list of mem requests
 	/// print to the opened file the line:
@@ -175,42 +385,472 @@ void print_test_framework(struct TEST_FRAMEWORK *f, char *name){
 	/// open another file with the name `name`.json
 	/// traverse the list of mem requests
 	/// print to the open json file
-	strncat(name, ".log", (size_t)4);
-	FILE *file = fopen(name, "w");
+	char ws_name[64];
+	FILE *file;
+	FILE *results;
+	isu_mem_log_t log;
+	isu_mem_log_summary_t summary;
+	snprintf(ws_name, sizeof(ws_name), "%s.ws", name);
+	results = open_results(name, f->format);
+	snprintf(name + strlen(name), TEST_NAME_LEN - strlen(name), ".log");
+	file = fopen(name, "w");
+	if(file == NULL || (results == NULL && f->format != ISU_MEM_LOG_TEXT && f->format != ISU_MEM_LOG_NONE)){
+		perror("Could not open the log");
+		return;
+	}
+	/// text goes to the log itself, ahead of the summary
+	if(f->format == ISU_MEM_LOG_TEXT){
+		results = file;
+	}
+	log = isu_mem_log_create(results, f->format);
+	if(log == NULL){
+		return;
+	}
 	isu_mem_req_t t = (isu_mem_req_t)isu_llist_ittr_start(f->mem_list, ISU_LLIST_HEAD);
 	while(t){
-		fprintf(file, "memory address: %u in page: %d requested at time: %llu handled at time: %llu and was a", isu_mem_req_get_address(t),
-															(isu_mem_req_get_address(t) / 4096),
-													   	 	isu_mem_req_get_req_time(t),
-													    		isu_mem_req_get_handle_time(t));
-		if(isu_mem_req_get_access_hit(t)){
-			fprintf(file, " hit\n");
-		}else{
-			fprintf(file, " miss\n");
-			f->misses++;
-		}
+		isu_mem_log_request(log, isu_mem_req_get_address(t), isu_mem_req_get_page_size(t), isu_mem_req_get_req_time(t),
+				    isu_mem_req_get_handle_time(t), isu_mem_req_get_level(t));
 		t = (isu_mem_req_t)isu_llist_ittr_next(f->mem_list);
 	}
-	fprintf(file, "1000 memory access requests were handled in %llu nanoseconds\n", f->current_time);
-	fprintf(file, "Of the 1000 memory access requests, %d were misses, making it a hit rate of %f\n", f->misses, 1.f - ((float)(f->misses) / 1000.f));
+	isu_mem_log_get_summary(log, &summary);
+	isu_mem_log_destroy(log);
+	close_results(results, file);
+	f->misses = (int)(summary.requests - summary.hits[0]);
+	fprintf(file, "%llu memory access requests were handled in %llu nanoseconds\n", f->count, f->current_time);
+	fprintf(file, "Of the %llu memory access requests, %d were misses, making it a hit rate of %f\n", f->count, f->misses,
+		1.f - ((float)(f->misses) / (float)f->count));
+	fprintf(file, "The optimal(OPT) replacement has %d misses, a hit rate of %f\n", f->opt_misses, 1.f - ((float)(f->opt_misses) / (float)f->count));
+	fprintf(file, "The TLB of %u entries had %llu misses, a hit rate of %f\n", test_tlb.entries, f->tlb.misses,
+		1. - ((double)f->tlb.misses / (double)(f->tlb.hits + f->tlb.misses)));
+	print_prefetch(file, f->prefetcher, &f->prefetch);
+	print_walk(file, f->depth, &f->walk, f->current_time);
+	print_huge(file, f->page_size, f->huge, &f->huges, f->count);
+	if(f->ws){
+		print_working_set(file, f->ws, f->tau, ws_name);
+	}
+	print_levels(file, &summary);
+	print_stats(file, MMU);
 	fclose(file);
 	file = 0;
 }
 
 void destroy_test_framework(struct TEST_FRAMEWORK *f){
 	/// go through the list and pop each element off the list
-	/// free the elements poped from the list
-	/// once all the elements are freed, free the list
+	/// once the list is empty, free the list
+	/// free every request at once by destroying their pool
 	/// then free the framework
 	/// set `f` to 0
-	if(isu_llist_count){
-		void *t = isu_llist_pop(f->mem_list, ISU_LLIST_HEAD);
-		while(t){
-			free(t);
-			t = isu_llist_pop(f->mem_list, ISU_LLIST_HEAD);
-		}
+	void *t = isu_llist_pop(f->mem_list, ISU_LLIST_HEAD);
+	while(t){
+		t = isu_llist_pop(f->mem_list, ISU_LLIST_HEAD);
 	}
 	isu_llist_destroy(f->mem_list);
+	if(f->pool){
+		isu_mem_req_pool_destroy(f->pool);
+	}
+	if(f->ws){
+		isu_working_set_destroy(f->ws);
+	}
 	free(f);
 	f = 0;
 }
+
+int run_trace(int mode, const char *path, char *name, unsigned int wbuf, int prefetcher, unsigned long long tau, unsigned int depth,
+	      unsigned int huge, unsigned int mshrs, int format){
+	/// replay the trace a chunk at a time, so neither the startup cost nor
+	/// the memory used grows with the length of the trace
+	size_t i;
+	size_t n;
+	int ret = -1;
+	uint64_t first = 0;
+	uint64_t count;
+	int wide;
+	unsigned long long current_time = 0;
+	unsigned long long misses;
+	uint64_t addr;
+	uint16_t *addrs = NULL;
+	uint64_t *addrs64 = NULL;
+	uint16_t *future = NULL;
+	uint8_t *writes = NULL;
+	isu_mmu_batch_result_t results = {NULL, NULL, NULL, NULL};
+	isu_mmu_write_stats_t ws;
+	isu_mmu_tlb_stats_t tlb;
+	isu_mmu_prefetch_stats_t pf;
+	isu_mmu_walk_stats_t walk;
+	isu_mmu_huge_stats_t huges;
+	isu_mmu_mshr_stats_t mshr;
+	isu_mmu_t MMU = NULL;
+	isu_working_set_t wset = NULL;
+	char ws_name[64];
+	FILE *file = NULL;
+	FILE *out = NULL;
+	isu_mem_log_t log = NULL;
+	isu_mem_log_summary_t summary;
+
+	isu_mem_trace_t trace = isu_mem_trace_open(path);
+	if(trace == NULL){
+		printf("Error: %s is not a trace file\n", path);
+		return -1;
+	}
+	count = isu_mem_trace_count(trace);
+	/// addresses past 16 bits need page tables to keep their pages apart,
+	/// which OPT doesn't have
+	wide = isu_mem_trace_addr_bytes(trace) > 2;
+	if(wide && mode == 6){
+		printf("Error: %s has addresses wider than 16 bits, which OPT can't replay\n", path);
+		goto done;
+	}
+	MMU = isu_mmu_create(mode);
+	addrs = malloc(TRACE_CHUNK * sizeof(uint16_t));
+	results.level = malloc(TRACE_CHUNK * sizeof(int8_t));
+	results.latency = malloc(TRACE_CHUNK * sizeof(unsigned long long));
+	results.page_size = malloc(TRACE_CHUNK * sizeof(unsigned int));
+	results.issue = malloc(TRACE_CHUNK * sizeof(unsigned long long));
+	if(isu_mem_trace_has_rw(trace)){
+		writes = malloc(TRACE_CHUNK);
+	}
+	/// with page tables the requests keep their full addresses
+	if(depth || huge || wide){
+		addrs64 = malloc(TRACE_CHUNK * sizeof(uint64_t));
+	}
+	if(MMU == NULL || addrs == NULL || results.level == NULL || results.latency == NULL || results.page_size == NULL ||
+	   results.issue == NULL || (writes == NULL && isu_mem_trace_has_rw(trace)) || (addrs64 == NULL && (depth || huge || wide))){
+		perror("Malloc encountered an error");
+		goto done;
+	}
+	if(isu_mmu_set_write_buffer(MMU, wbuf) < 0 || isu_mmu_set_tlb(MMU, &test_tlb) < 0 ||
+	   isu_mmu_set_prefetcher(MMU, prefetcher, TEST_PREFETCH_DEGREE) < 0 || set_translation(MMU, depth, huge) < 0 ||
+	   (wide && !depth && !huge && isu_mmu_set_page_tables(MMU, ISU_MMU_GLOBAL) < 0) || isu_mmu_set_mshrs(MMU, mshrs) < 0){
+		goto done;
+	}
+	/// OPT is the exception, it has to see the whole trace up front
+	if(mode == 6){
+		future = malloc((size_t)count * sizeof(uint16_t) + 1);
+		if(future == NULL || count > 0xFFFFFFFFULL){
+			printf("Error: the trace is too long for OPT\n");
+			free(future);
+			goto done;
+		}
+		isu_mem_trace_read16(trace, 0, future, (size_t)count);
+		isu_mmu_set_future(MMU, future, (unsigned int)count);
+		free(future);
+	}
+
+	if(tau && (wset = isu_working_set_create(tau, tau)) == NULL){
+		goto done;
+	}
+
+	snprintf(ws_name, sizeof(ws_name), "%s.ws", name);
+	out = open_results(name, format);
+	snprintf(name + strlen(name), TEST_NAME_LEN - strlen(name), ".log");
+	file = fopen(name, "w");
+	if(file == NULL || (out == NULL && format != ISU_MEM_LOG_TEXT && format != ISU_MEM_LOG_NONE)){
+		perror("Could not open the log");
+		goto done;
+	}
+	/// text goes to the log itself, ahead of the summary
+	if(format == ISU_MEM_LOG_TEXT){
+		out = file;
+	}
+	log = isu_mem_log_create(out, format);
+	if(log == NULL){
+		goto done;
+	}
+	while((n = addrs64 ? isu_mem_trace_read64(trace, first, addrs64, TRACE_CHUNK) :
+			     isu_mem_trace_read16(trace, first, addrs, TRACE_CHUNK)) > 0){
+		if(writes){
+			isu_mem_trace_read_rw(trace, first, writes, n);
+		}
+		if((addrs64 ? isu_mmu_handle_batch64(MMU, NULL, addrs64, writes, n, &results, &current_time) :
+			      isu_mmu_handle_batch(MMU, addrs, writes, n, &results, &current_time)) < 0){
+			printf("Error: request %llu of the trace could not be handled\n", (unsigned long long)first);
+			break;
+		}
+		for(i = 0; i < n; i++){
+			addr = addrs64 ? addrs64[i] : addrs[i];
+			isu_mem_log_request(log, addr, results.page_size[i], results.issue[i], results.issue[i] + results.latency[i],
+					    results.level[i]);
+			if(wset){
+				isu_working_set_access(wset, (long long)(addr / isu_mmu_get_page_size(MMU)), results.level[i] != 0,
+						       results.issue[i] + results.latency[i]);
+			}
+		}
+		first += n;
+	}
+	isu_mem_log_get_summary(log, &summary);
+	if(isu_mem_log_destroy(log) < 0){
+		printf("Error: the requests could not all be logged\n");
+	}
+	log = NULL;
+	close_results(out, file);
+	out = NULL;
+	misses = summary.requests - summary.hits[0];
+	fprintf(file, "%llu memory access requests were handled in %llu nanoseconds\n", (unsigned long long)first, current_time);
+	fprintf(file, "Of the %llu memory access requests, %llu were misses, making it a hit rate of %f\n", (unsigned long long)first, misses,
+		first ? 1. - ((double)misses / (double)first) : 0.);
+	isu_mmu_get_tlb_stats(MMU, &tlb);
+	fprintf(file, "The TLB of %u entries had %llu misses, a hit rate of %f\n", test_tlb.entries, tlb.misses,
+		tlb.hits + tlb.misses ? (double)tlb.hits / (double)(tlb.hits + tlb.misses) : 0.);
+	if(writes){
+		isu_mmu_get_write_stats(MMU, &ws);
+		fprintf(file, "%llu of the requests were writes, %llu dirty pages were written back, %llu through the write buffer "
+			"with %llu coalesced, and %llu waited %llu nanoseconds for a full write buffer\n",
+			ws.writes, ws.writebacks, ws.buffered + ws.coalesced, ws.coalesced, ws.stalls, ws.stall_time);
+	}
+	isu_mmu_get_prefetch_stats(MMU, &pf);
+	print_prefetch(file, prefetcher, &pf);
+	isu_mmu_get_walk_stats(MMU, &walk);
+	print_walk(file, depth, &walk, current_time);
+	isu_mmu_get_huge_stats(MMU, &huges);
+	print_huge(file, isu_mmu_get_page_size(MMU), huge, &huges, first);
+	isu_mmu_get_mshr_stats(MMU, &mshr);
+	print_mshr(file, mshrs, &mshr, current_time);
+	if(wset){
+		print_working_set(file, wset, tau, ws_name);
+	}
+	print_levels(file, &summary);
+	print_stats(file, MMU);
+	ret = 0;
+done:
+	if(log){
+		isu_mem_log_destroy(log);
+	}
+	close_results(out, file);
+	if(file){
+		fclose(file);
+	}
+	if(wset){
+		isu_working_set_destroy(wset);
+	}
+	free(addrs);
+	free(addrs64);
+	free(writes);
+	free(results.level);
+	free(results.latency);
+	free(results.page_size);
+	free(results.issue);
+	if(MMU){
+		isu_mmu_destroy(MMU);
+	}
+	isu_mem_trace_close(trace);
+	return ret;
+}
+
+FILE *open_results(const char *name, int format){
+	/// binary and JSON get a file of their own, text shares the log and the
+	/// summary needs none
+	char path[64];
+	if(format == ISU_MEM_LOG_TEXT || format == ISU_MEM_LOG_NONE){
+		return NULL;
+	}
+	snprintf(path, sizeof(path), "%s.%s", name, format == ISU_MEM_LOG_BINARY ? "res" : "json");
+	return fopen(path, "wb");
+}
+
+void close_results(FILE *results, FILE *log){
+	if(results && results != log){
+		fclose(results);
+	}
+}
+
+void print_levels(FILE *file, isu_mem_log_summary_t *summary){
+	/// the deepest level any request was found in ends the list
+	int i;
+	int last = 0;
+	for(i = 0; i < ISU_MEM_LOG_LEVELS; i++){
+		if(summary->hits[i]){
+			last = i;
+		}
+	}
+	fprintf(file, "Of the %llu memory access requests, %llu", summary->requests, summary->hits[0]);
+	for(i = 1; i <= last; i++){
+		fprintf(file, ", %llu", summary->hits[i]);
+	}
+	fprintf(file, " were found in each level from L1 down, %llu came from disk, and together they took %llu nanoseconds, "
+		"a miss rate of %f\n", summary->disk,
+		summary->latency, summary->requests ? 1. - ((double)summary->hits[0] / (double)summary->requests) : 0.);
+}
+
+void print_stats(FILE *file, isu_mmu_t MMU){
+	/// a line for each level of the hierarchy, then the latencies of the
+	/// accesses, which the capacity of the levels is judged by
+	int i;
+	isu_mmu_level_stats_t level;
+	isu_mmu_stats_t stats;
+	for(i = 0; isu_mmu_get_level_stats(MMU, i, &level) == 0; i++){
+		fprintf(file, "Level %d had %llu hits and %llu misses, gave up %llu pages(%llu dirty), swapped %llu with L1 and "
+			"took in %llu from below\n", i + 1, level.hits, level.misses, level.evictions, level.writebacks, level.swaps,
+			level.promotions);
+	}
+	isu_mmu_get_stats(MMU, &stats);
+	fprintf(file, "The %llu accesses took %f nanoseconds on average and at most %llu, half took at most %llu, 99%% at most %llu "
+		"and 99.9%% at most %llu\n", stats.accesses,
+		stats.accesses ? (double)stats.total_latency / (double)stats.accesses : 0., stats.max_latency, stats.p50, stats.p99,
+		stats.p999);
+}
+
+int mrc_test_framework(struct TEST_FRAMEWORK *f, char *name){
+	/// one pass over the requests gives the misses of LRU at every size
+	int ret;
+	isu_stack_dist_t sd = isu_stack_dist_create();
+	if(sd == NULL){
+		return -1;
+	}
+	isu_mem_req_t t = (isu_mem_req_t)isu_llist_ittr_start(f->mem_list, ISU_LLIST_HEAD);
+	while(t){
+		isu_stack_dist_access(sd, isu_mem_req_get_address(t) / 4096);
+		t = isu_llist_ittr_next(f->mem_list);
+	}
+	ret = print_mrc(sd, name);
+	isu_stack_dist_destroy(sd);
+	return ret;
+}
+
+int mrc_trace(const char *path, char *name){
+	/// the analysis isn't limited to the MMU, so it uses the full addresses
+	uint64_t i;
+	uint64_t count;
+	int ret;
+	isu_stack_dist_t sd;
+	isu_mem_trace_t trace = isu_mem_trace_open(path);
+	if(trace == NULL){
+		printf("Error: %s is not a trace file\n", path);
+		return -1;
+	}
+	sd = isu_stack_dist_create();
+	if(sd == NULL){
+		isu_mem_trace_close(trace);
+		return -1;
+	}
+	count = isu_mem_trace_count(trace);
+	for(i = 0; i < count; i++){
+		if(isu_stack_dist_access(sd, (long long)(isu_mem_trace_addr(trace, i) / 4096)) < 0){
+			printf("Error: request %llu of the trace could not be analysed\n", (unsigned long long)i);
+			break;
+		}
+	}
+	ret = print_mrc(sd, name);
+	isu_stack_dist_destroy(sd);
+	isu_mem_trace_close(trace);
+	return ret;
+}
+
+int print_mrc(isu_stack_dist_t sd, char *name){
+	/// print the misses at every size up to the number of distinct pages,
+	/// past that only the first request of each page misses
+	unsigned long long c;
+	unsigned long long count = isu_stack_dist_count(sd);
+	unsigned long long distinct = isu_stack_dist_distinct(sd);
+	unsigned long long *misses = malloc((distinct + 1) * sizeof(unsigned long long));
+	FILE *file;
+	if(misses == NULL){
+		perror("Malloc encountered an error");
+		return -1;
+	}
+	isu_stack_dist_misses(sd, misses, distinct);
+	snprintf(name + strlen(name), TEST_NAME_LEN - strlen(name), ".log");
+	file = fopen(name, "w");
+	if(file == NULL){
+		perror("Could not open the log");
+		free(misses);
+		return -1;
+	}
+	for(c = 1; c <= distinct; c++){
+		fprintf(file, "with %llu pages, %llu of the %llu memory access requests were misses, making it a miss ratio of %f\n",
+			c, misses[c], count, count ? (double)misses[c] / (double)count : 0.);
+	}
+	fprintf(file, "%llu distinct pages were requested\n", distinct);
+	fclose(file);
+	free(misses);
+	return 0;
+}
+
+void print_prefetch(FILE *file, int prefetcher, isu_mmu_prefetch_stats_t *stats){
+	/// accuracy is the share of prefetches that were used, coverage the
+	/// share of would be misses that a prefetch saved
+	if(prefetcher == 0){
+		return;
+	}
+	fprintf(file, "The %s prefetcher issued %llu prefetches, %llu were used(%llu late), an accuracy of %f and a coverage of %f\n",
+		isu_mmu_prefetcher_get(prefetcher)->name, stats->issued, stats->useful, stats->late,
+		stats->issued ? (double)stats->useful / (double)stats->issued : 0.,
+		stats->useful + stats->misses ? (double)stats->useful / (double)(stats->useful + stats->misses) : 0.);
+}
+
+int set_translation(isu_mmu_t MMU, unsigned int depth, unsigned int huge){
+	/// the requests are one process, the walk and huge pages need it to
+	/// have a page table
+	isu_mmu_walk_desc_t walk = {depth, TEST_PWC_ENTRIES};
+	isu_mmu_huge_desc_t huges = {huge, huge / isu_mmu_get_page_size(MMU) / 2, TEST_HUGE_TLB_ENTRIES};
+	if(depth == 0 && huge == 0){
+		return 0;
+	}
+	if(isu_mmu_set_page_tables(MMU, ISU_MMU_GLOBAL) < 0 ||
+	   (depth && isu_mmu_set_page_walk(MMU, &walk) < 0) ||
+	   (huge && isu_mmu_set_huge_pages(MMU, &huges) < 0)){
+		return -1;
+	}
+	return 0;
+}
+
+void print_walk(FILE *file, unsigned int depth, isu_mmu_walk_stats_t *stats, unsigned long long time){
+	/// the time of the walks is part of the time of the requests, so its
+	/// share is the overhead of translation
+	if(depth == 0){
+		return;
+	}
+	fprintf(file, "The %u level page table of %llu nodes was walked %llu times, reading %llu entries(%llu outside of L1), "
+		"the page walk caches saved %llu reads, and walking took %llu nanoseconds, %f of the time\n",
+		depth, stats->nodes, stats->walks, stats->reads, stats->read_misses, stats->skipped, stats->time,
+		time ? (double)stats->time / (double)time : 0.);
+}
+
+void print_huge(FILE *file, unsigned int page_size, unsigned int huge, isu_mmu_huge_stats_t *stats, unsigned long long count){
+	/// the unused pages of the reserved huge frames, and the ones skipped
+	/// to align them, are the fragmentation huge pages cost
+	if(huge == 0){
+		return;
+	}
+	fprintf(file, "%llu regions were promoted to huge pages of %u bytes, which translated %f of the requests, and the TLB of "
+		"%u huge pages had %llu misses, reaching %llu bytes. %llu of the %llu pages reserved for huge pages are unused "
+		"and %llu more were skipped to align them\n",
+		stats->promotions, huge, count ? (double)stats->accesses / (double)count : 0., TEST_HUGE_TLB_ENTRIES,
+		stats->tlb_misses, (unsigned long long)test_tlb.entries * page_size +
+		(unsigned long long)TEST_HUGE_TLB_ENTRIES * huge, stats->reserved - stats->used, stats->reserved, stats->gaps);
+}
+
+void print_mshr(FILE *file, unsigned int mshrs, isu_mmu_mshr_stats_t *stats, unsigned long long time){
+	/// the misses would have taken `serial_time` one after the other, what
+	/// they took instead gives the misses in flight on average
+	if(mshrs == 0){
+		return;
+	}
+	fprintf(file, "%llu misses took one of %u MSHRs, %llu waited for a page already on its way and %llu waited %llu nanoseconds "
+		"for a free MSHR. The misses would have taken %llu nanoseconds one after the other, %f were in flight on average "
+		"and at most %llu\n",
+		stats->misses, mshrs, stats->merged, stats->stalls, stats->stall_time, stats->serial_time,
+		time ? (double)stats->serial_time / (double)time : 0., stats->peak);
+}
+
+int print_working_set(FILE *file, isu_working_set_t ws, unsigned long long tau, const char *name){
+	/// the log gets the summary, the time series goes to a file of its own
+	/// with one line for each interval of `tau` requests
+	unsigned long long i;
+	unsigned long long n;
+	const isu_working_set_sample_t *samples = isu_working_set_samples(ws, &n);
+	FILE *series;
+	fprintf(file, "The working set over windows of %llu requests had a mean size of %f pages and a peak of %llu pages\n",
+		tau, isu_working_set_mean(ws), isu_working_set_peak(ws));
+	series = fopen(name, "w");
+	if(series == NULL){
+		perror("Could not open the working set series");
+		return -1;
+	}
+	fprintf(series, "requests,time_ns,working_set,faults,fault_frequency\n");
+	for(i = 0; i < n; i++){
+		fprintf(series, "%llu,%llu,%llu,%llu,%f\n", samples[i].requests, samples[i].time, samples[i].size,
+			samples[i].faults, (double)samples[i].faults / (double)tau);
+	}
+	fclose(series);
+	return 0;
+}
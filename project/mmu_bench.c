@@ -0,0 +1,228 @@
+/**
+ * @file	mmu_bench.c
+ * @brief	benchmarks the MMU
+ * @details	Compares the recency list used by the MMU against the scan of
+ * 		access times it replaced.  Both are driven by the same stream of
+ * 		hits and evictions over levels of 64, 1K and 64K frames.
+ *
+ * 		Then replays a trace through isu_mmu_handle_req(), one request
+ * 		object at a time, and through isu_mmu_handle_batch().
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "isu_mmu/isu_slot_list.h"
+#include "isu_mmu/isu_mmu.h"
+#include "page_req/isu_mem_req.h"
+
+/// the number of operations to run for each size
+#define OPS 2000000
+/// one in this many operations is an eviction, the rest are hits
+#define EVICT_EVERY 4
+/// the delay of going to disk in the replayed hierarchy
+#define DISK_LATENCY 5000000
+
+/// the number of requests in the replayed trace
+#define TRACE_LEN 1000000
+/// the requests of each slab of the pool the request objects come from
+#define BENCH_POOL_SLAB 4096
+
+/// the sizes of the levels to benchmark
+static const unsigned int sizes[] = {64, 1024, 65536};
+
+/// the hierarchy the trace is replayed through
+static const isu_mmu_level_desc_t trace_levels[] = {
+	{64, 1, 256, 0},
+	{256, 7, 256, 0},
+	{1024, 75, 256, 0}
+};
+
+/// gets the current time in nanoseconds
+static unsigned long long now_ns(void){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/// finds the slot with the earliest access time, the way the MMU used to
+static unsigned int scan_lru(const unsigned long long *access_time, unsigned int n){
+	unsigned int i;
+	unsigned int min_index = 0;
+	unsigned long long min_time = access_time[0];
+	for(i = 1; i < n; i++){
+		if(access_time[i] < min_time){
+			min_time = access_time[i];
+			min_index = i;
+		}
+	}
+	return min_index;
+}
+
+/// runs the operations with a scan of access times, returns nanoseconds taken
+static unsigned long long bench_scan(unsigned int n, const unsigned int *ops, unsigned long long *victims){
+	unsigned int i;
+	unsigned int slot;
+	unsigned long long start;
+	unsigned long long *access_time = malloc(n * sizeof(unsigned long long));
+	for(i = 0; i < n; i++){
+		access_time[i] = i;
+	}
+	*victims = 0;
+	start = now_ns();
+	for(i = 0; i < OPS; i++){
+		if(ops[i] == n){
+			slot = scan_lru(access_time, n);
+			*victims += slot;
+		}else{
+			slot = ops[i];
+		}
+		access_time[slot] = n + i;
+	}
+	start = now_ns() - start;
+	free(access_time);
+	return start;
+}
+
+/// runs the operations with a recency list, returns nanoseconds taken
+static unsigned long long bench_list(unsigned int n, const unsigned int *ops, unsigned long long *victims){
+	unsigned int i;
+	int slot;
+	unsigned long long start;
+	isu_slot_list_t recency = isu_slot_list_create(n);
+	for(i = 0; i < n; i++){
+		isu_slot_list_push_head(recency, i);
+	}
+	*victims = 0;
+	start = now_ns();
+	for(i = 0; i < OPS; i++){
+		if(ops[i] == n){
+			slot = isu_slot_list_tail(recency);
+			*victims += slot;
+		}else{
+			slot = ops[i];
+		}
+		isu_slot_list_push_head(recency, slot);
+	}
+	start = now_ns() - start;
+	isu_slot_list_destroy(recency);
+	return start;
+}
+
+/// replays `addrs` one request object at a time, returns nanoseconds taken
+static unsigned long long bench_req(const uint16_t *addrs, unsigned int n, unsigned int *hits, unsigned long long *t){
+	unsigned int i;
+	unsigned long long start;
+	isu_mem_req_t req;
+	isu_mem_req_pool_t pool = isu_mem_req_pool_create(BENCH_POOL_SLAB);
+	isu_mmu_t mmu = isu_mmu_create_ex(1, trace_levels, 3, DISK_LATENCY);
+	*hits = 0;
+	*t = 0;
+	start = now_ns();
+	for(i = 0; i < n; i++){
+		/// the requests are given back a slab at a time
+		if(i % BENCH_POOL_SLAB == 0){
+			isu_mem_req_pool_reset(pool);
+		}
+		req = isu_mem_req_pool_get(pool, addrs[i]);
+		isu_mmu_ref_clear(mmu);
+		isu_mmu_handle_req(mmu, req, t);
+		*hits += isu_mem_req_get_access_hit(req);
+	}
+	start = now_ns() - start;
+	isu_mem_req_pool_destroy(pool);
+	isu_mmu_destroy(mmu);
+	return start;
+}
+
+/// replays `addrs` as a single batch, returns nanoseconds taken
+static unsigned long long bench_batch(const uint16_t *addrs, unsigned int n, unsigned int *hits, unsigned long long *t){
+	unsigned int i;
+	unsigned long long start;
+	isu_mmu_batch_result_t results;
+	isu_mmu_t mmu = isu_mmu_create_ex(1, trace_levels, 3, DISK_LATENCY);
+	results.level = malloc(n * sizeof(int8_t));
+	results.latency = malloc(n * sizeof(unsigned long long));
+	results.page_size = NULL;
+	results.issue = NULL;
+	*t = 0;
+	start = now_ns();
+	isu_mmu_handle_batch(mmu, addrs, NULL, n, &results, t);
+	start = now_ns() - start;
+	*hits = 0;
+	for(i = 0; i < n; i++){
+		*hits += results.level[i] == 0;
+	}
+	free(results.level);
+	free(results.latency);
+	isu_mmu_destroy(mmu);
+	return start;
+}
+
+int main(int argc, char **argv){
+	unsigned int i;
+	unsigned int s;
+	unsigned int n;
+	unsigned int *ops;
+	unsigned long long scan_ns;
+	unsigned long long list_ns;
+	unsigned long long scan_victims;
+	unsigned long long list_victims;
+	uint16_t *addrs;
+	unsigned int req_hits;
+	unsigned int batch_hits;
+	unsigned long long req_t;
+	unsigned long long req_ns;
+	unsigned long long batch_ns;
+	unsigned long long batch_t;
+
+	ops = malloc(OPS * sizeof(unsigned int));
+	if(ops == NULL){
+		perror("Malloc encountered an error");
+		return -1;
+	}
+	srand(12345);
+
+	printf("%8s %14s %14s %10s\n", "frames", "scan ns/op", "list ns/op", "speedup");
+	for(s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++){
+		n = sizes[s];
+		/// an operation of `n` is an eviction, anything else is a hit on that slot
+		for(i = 0; i < OPS; i++){
+			ops[i] = (rand() % EVICT_EVERY) ? (unsigned int)(rand() % n) : n;
+		}
+		scan_ns = bench_scan(n, ops, &scan_victims);
+		list_ns = bench_list(n, ops, &list_victims);
+		if(scan_victims != list_victims){
+			printf("error: the scan and the list picked different victims for %u frames\n", n);
+			return -1;
+		}
+		printf("%8u %14.1f %14.1f %9.1fx\n", n,
+			(double)scan_ns / OPS,
+			(double)list_ns / OPS,
+			(double)scan_ns / (double)list_ns);
+	}
+	free(ops);
+
+	addrs = malloc(TRACE_LEN * sizeof(uint16_t));
+	if(addrs == NULL){
+		perror("Malloc encountered an error");
+		return -1;
+	}
+	/// mostly hits in a small region, with some random addresses
+	for(i = 0; i < TRACE_LEN; i++){
+		addrs[i] = (rand() % 8) ? (uint16_t)(rand() % 16384) : (uint16_t)(rand() % 65536);
+	}
+	req_ns = bench_req(addrs, TRACE_LEN, &req_hits, &req_t);
+	batch_ns = bench_batch(addrs, TRACE_LEN, &batch_hits, &batch_t);
+	if(req_hits != batch_hits || req_t != batch_t){
+		printf("error: the batch and single requests gave different results\n");
+		return -1;
+	}
+	printf("\n%8s %14s %14s %10s\n", "requests", "req ns/op", "batch ns/op", "speedup");
+	printf("%8u %14.1f %14.1f %9.1fx\n", TRACE_LEN,
+		(double)req_ns / TRACE_LEN,
+		(double)batch_ns / TRACE_LEN,
+		(double)req_ns / (double)batch_ns);
+	free(addrs);
+	return 0;
+}
@@ -0,0 +1,229 @@
+/**
+ * @file	isu_mem_gen.c
+ * @brief	source file of isu_mem_gen.h
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "isu_mem_gen.h"
+#include "common/isu_error.h"
+
+/// the terms of the zeta sum added one by one, the rest is integrated
+#define ZETA_TERMS 1024
+
+struct ISU_MEM_GEN_STRUCT{
+	/// the workload
+	isu_mem_gen_desc_t desc;
+
+	/// the constants of the Zipfian distribution over desc.pages, from
+	/// Gray et al., "Quickly generating billion-record synthetic databases"
+	double alpha;
+	double zetan;
+	double eta;
+	double half;
+
+	/// the step between the pages of consecutive ranks, so the hot pages
+	/// are spread over the footprint rather than side by side
+	uint64_t stride;
+};
+
+static uint64_t rotl(uint64_t x, int k){
+	return (x << k) | (x >> (64 - k));
+}
+
+static uint64_t splitmix64(uint64_t *x){
+	uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+void isu_mem_rng_seed(isu_mem_rng_t *rng, uint64_t seed, uint64_t stream){
+	/// the stream is mixed in on its own first so neighbouring streams
+	/// start far apart
+	uint64_t x = stream;
+	int i;
+	x = seed ^ splitmix64(&x);
+	for(i = 0; i < 4; i++){
+		rng->s[i] = splitmix64(&x);
+	}
+}
+
+uint64_t isu_mem_rng_next(isu_mem_rng_t *rng){
+	uint64_t *s = rng->s;
+	uint64_t result = rotl(s[1] * 5, 7) * 9;
+	uint64_t t = s[1] << 17;
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = rotl(s[3], 45);
+	return result;
+}
+
+uint64_t isu_mem_rng_below(isu_mem_rng_t *rng, uint64_t n){
+	/// the high half of the product, which is close enough to uniform for
+	/// any bound a workload uses
+	return (uint64_t)(((unsigned __int128)isu_mem_rng_next(rng) * n) >> 64);
+}
+
+/// draws a number in [0, 1)
+static double rng_unit(isu_mem_rng_t *rng){
+	return (double)(isu_mem_rng_next(rng) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+void isu_mem_gen_desc_init(isu_mem_gen_desc_t *desc, int kind, uint64_t pages, unsigned int page_size, uint64_t seed){
+	desc->kind = kind;
+	desc->pages = pages;
+	desc->page_size = page_size;
+	desc->skew = 0.99;
+	desc->phase = 64 * pages;
+	desc->scan = 0.2;
+	desc->seed = seed;
+}
+
+uint64_t isu_mem_gen_footprint(const isu_mem_gen_desc_t *desc){
+	switch(desc->kind){
+	case ISU_MEM_GEN_PHASE: return ISU_MEM_GEN_REGIONS * desc->pages;
+	case ISU_MEM_GEN_MIX: return 2 * desc->pages;
+	default: return desc->pages;
+	}
+}
+
+static uint64_t gcd(uint64_t a, uint64_t b){
+	while(b){
+		uint64_t t = a % b;
+		a = b;
+		b = t;
+	}
+	return a;
+}
+
+/// the sum of 1 / i^theta for i from 1 to n
+static double zeta(uint64_t n, double theta){
+	double sum = 0;
+	uint64_t i;
+	for(i = 1; i <= n && i <= ZETA_TERMS; i++){
+		sum += pow((double)i, -theta);
+	}
+	if(n > ZETA_TERMS){
+		sum += (pow(n + 0.5, 1 - theta) - pow(ZETA_TERMS + 0.5, 1 - theta)) / (1 - theta);
+	}
+	return sum;
+}
+
+isu_mem_gen_t isu_mem_gen_create(const isu_mem_gen_desc_t *desc){
+	isu_mem_gen_t gen;
+	uint64_t n = desc->pages;
+	if(desc->kind < 0 || desc->kind >= ISU_MEM_GEN_COUNT || n == 0 || desc->page_size == 0){
+		isu_print(PRINT_ERROR, "generator %d needs pages", desc->kind);
+		return NULL;
+	}
+	if(!(desc->skew >= 0 && desc->skew < 1) || !(desc->scan >= 0 && desc->scan <= 1) ||
+			(desc->kind == ISU_MEM_GEN_PHASE && desc->phase == 0)){
+		isu_print(PRINT_ERROR, "the skew must be in [0, 1), the scan in [0, 1] and a phase at least 1 request");
+		return NULL;
+	}
+	gen = calloc(1, sizeof(struct ISU_MEM_GEN_STRUCT));
+	if(gen == NULL){
+		isu_print(PRINT_ERROR, "calloc returned NULL");
+		return NULL;
+	}
+	gen->desc = *desc;
+	gen->alpha = 1 / (1 - desc->skew);
+	gen->zetan = zeta(n, desc->skew);
+	gen->half = 1 + pow(0.5, desc->skew);
+	/// with 2 pages or fewer every rank is picked before eta is used
+	if(n > 2){
+		gen->eta = (1 - pow(2.0 / n, 1 - desc->skew)) / (1 - gen->half / gen->zetan);
+	}
+	gen->stride = (uint64_t)(n * 0.6180339887) | 1;
+	while(gcd(gen->stride, n) != 1){
+		gen->stride += 2;
+	}
+	return gen;
+}
+
+void isu_mem_gen_destroy(isu_mem_gen_t gen){
+	free(gen);
+}
+
+/// draws a page of the hot set, the hottest being page 0
+static uint64_t gen_zipf(isu_mem_gen_t gen, isu_mem_rng_t *rng){
+	uint64_t n = gen->desc.pages;
+	double u = rng_unit(rng);
+	double uz = u * gen->zetan;
+	uint64_t rank;
+	if(uz < 1){
+		return 0;
+	}
+	if(uz < gen->half || n <= 2){
+		rank = 1;
+	}else{
+		rank = (uint64_t)(n * pow(gen->eta * u - gen->eta + 1, gen->alpha));
+		if(rank >= n){
+			rank = n - 1;
+		}
+	}
+	return (uint64_t)(((unsigned __int128)rank * gen->stride) % n);
+}
+
+/// generates request `i` from the stream of its block
+static uint64_t gen_one(isu_mem_gen_t gen, isu_mem_rng_t *rng, uint64_t i){
+	const isu_mem_gen_desc_t *d = &gen->desc;
+	uint64_t page;
+	switch(d->kind){
+	case ISU_MEM_GEN_ZIPF:
+		page = gen_zipf(gen, rng);
+		break;
+	case ISU_MEM_GEN_LOOP:
+		page = i % d->pages;
+		break;
+	case ISU_MEM_GEN_PHASE:
+		page = (i / d->phase) % ISU_MEM_GEN_REGIONS * d->pages + gen_zipf(gen, rng);
+		break;
+	default:
+		/// the loop lives in the pages after the hot set and moves on with
+		/// every request, picked or not, so it doesn't depend on the draws
+		/// before it
+		if(rng_unit(rng) < d->scan){
+			page = d->pages + i % d->pages;
+		}else{
+			page = gen_zipf(gen, rng);
+		}
+		break;
+	}
+	return page * d->page_size + isu_mem_rng_below(rng, d->page_size);
+}
+
+void isu_mem_gen_fill(isu_mem_gen_t gen, uint64_t *addrs, uint64_t first, size_t n){
+	isu_mem_rng_t rng;
+	uint64_t i = first;
+	uint64_t end = first + n;
+	uint64_t j;
+	uint64_t block_end;
+	while(i < end){
+		/// a run starting inside a block replays the block up to it
+		j = i - i % ISU_MEM_GEN_BLOCK;
+		block_end = j + ISU_MEM_GEN_BLOCK;
+		isu_mem_rng_seed(&rng, gen->desc.seed, j / ISU_MEM_GEN_BLOCK);
+		for(; j < i; j++){
+			gen_one(gen, &rng, j);
+		}
+		for(; i < end && i < block_end; i++){
+			*addrs++ = gen_one(gen, &rng, i);
+		}
+	}
+}
+
+const char *isu_mem_gen_name(int kind){
+	switch(kind){
+	case ISU_MEM_GEN_ZIPF: return "zipf";
+	case ISU_MEM_GEN_LOOP: return "loop";
+	case ISU_MEM_GEN_PHASE: return "phase";
+	case ISU_MEM_GEN_MIX: return "mix";
+	default: return NULL;
+	}
+}
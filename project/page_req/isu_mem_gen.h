@@ -0,0 +1,164 @@
+/**
+ * @file	isu_mem_gen.h
+ * @brief	generators of large synthetic workloads
+ * @details	Each generator picks pages out of a footprint of its own and
+ * 		places every address at a random offset in its page.  The
+ * 		requests are cut into blocks of ISU_MEM_GEN_BLOCK and every block
+ * 		draws from a stream of random numbers of its own, seeded from the
+ * 		seed of the workload and the number of the block.  Request i is
+ * 		therefore the same however the requests are split up, so any
+ * 		number of threads can each fill a part of one workload and get
+ * 		the addresses a single thread would have.
+ */
+
+#ifndef ISU_MEM_GEN_H
+#define ISU_MEM_GEN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/// a Zipfian hot set, a few pages take most of the requests
+#define ISU_MEM_GEN_ZIPF 0
+/// a scan of every page in turn, over and over
+#define ISU_MEM_GEN_LOOP 1
+/// a Zipfian hot set that moves to another region every phase
+#define ISU_MEM_GEN_PHASE 2
+/// a Zipfian hot set with a loop through other pages mixed in
+#define ISU_MEM_GEN_MIX 3
+/// the number of generators
+#define ISU_MEM_GEN_COUNT 4
+
+/// the requests drawn from one stream of random numbers
+#define ISU_MEM_GEN_BLOCK 4096
+/// the regions the hot set of ISU_MEM_GEN_PHASE moves between
+#define ISU_MEM_GEN_REGIONS 4
+
+/**
+ * @brief	the state of a xoshiro256** generator of random numbers
+ */
+typedef struct ISU_MEM_RNG{
+	uint64_t s[4];
+}isu_mem_rng_t;
+
+/**
+ * @brief	what a workload looks like
+ */
+typedef struct ISU_MEM_GEN_DESC{
+	/// one of the ISU_MEM_GEN_ values
+	int kind;
+	/// the pages of the hot set or of the loop
+	uint64_t pages;
+	/// the bytes of a page
+	unsigned int page_size;
+	/// the exponent of the Zipfian distribution, 0 is uniform, must be
+	/// below 1
+	double skew;
+	/// the requests of each phase of ISU_MEM_GEN_PHASE
+	uint64_t phase;
+	/// the share of the requests of ISU_MEM_GEN_MIX that are in the loop
+	double scan;
+	/// the seed every stream is derived from
+	uint64_t seed;
+}isu_mem_gen_desc_t;
+
+/**
+ * @class	isu_mem_gen_t
+ * @brief	a generator of one workload
+ */
+typedef struct ISU_MEM_GEN_STRUCT *isu_mem_gen_t;
+
+/**
+ * @brief	seeds a generator of random numbers
+ * @param	rng
+ * 			the generator
+ * @param	seed
+ * 			the seed shared by every stream
+ * @param	stream
+ * 			the stream, different streams of one seed don't overlap in
+ * 			practice
+ */
+void isu_mem_rng_seed(isu_mem_rng_t *rng, uint64_t seed, uint64_t stream);
+
+/**
+ * @brief	draws the next random number
+ * @param	rng
+ * 			the generator
+ * @return	64 random bits
+ */
+uint64_t isu_mem_rng_next(isu_mem_rng_t *rng);
+
+/**
+ * @brief	draws a random number below `n`
+ * @param	rng
+ * 			the generator
+ * @param	n
+ * 			the bound, at least 1
+ * @return	a number from 0 to `n` - 1
+ */
+uint64_t isu_mem_rng_below(isu_mem_rng_t *rng, uint64_t n);
+
+/**
+ * @brief	fills in the defaults of a workload
+ * @param	desc
+ * 			the workload
+ * @param	kind
+ * 			one of the ISU_MEM_GEN_ values
+ * @param	pages
+ * 			the pages of the hot set or of the loop
+ * @param	page_size
+ * 			the bytes of a page
+ * @param	seed
+ * 			the seed of the workload
+ * @details	The skew is 0.99, a phase is 64 requests per page and a mix is
+ * 		a fifth loop.
+ */
+void isu_mem_gen_desc_init(isu_mem_gen_desc_t *desc, int kind, uint64_t pages, unsigned int page_size, uint64_t seed);
+
+/**
+ * @brief	gets the pages a workload touches
+ * @param	desc
+ * 			the workload
+ * @return	the pages, addresses are below this times the page size
+ */
+uint64_t isu_mem_gen_footprint(const isu_mem_gen_desc_t *desc);
+
+/**
+ * @brief	constructs a generator
+ * @param	desc
+ * 			the workload, copied
+ * @return	the generator or NULL if a failure occurs
+ */
+isu_mem_gen_t isu_mem_gen_create(const isu_mem_gen_desc_t *desc);
+
+/**
+ * @brief	destroys a generator
+ * @param	gen
+ * 			the generator to destroy
+ */
+void isu_mem_gen_destroy(isu_mem_gen_t gen);
+
+/**
+ * @brief	generates a run of the requests of a workload
+ * @param	gen
+ * 			the generator
+ * @param	addrs
+ * 			where to put the addresses
+ * @param	first
+ * 			the number of the first request to generate
+ * @param	n
+ * 			the number of requests to generate
+ * @details	Doesn't change the generator, so it may be called from many
+ * 		threads at once.  Runs that start inside a block redraw the
+ * 		start of the block, so runs of whole blocks are the fastest.
+ */
+void isu_mem_gen_fill(isu_mem_gen_t gen, uint64_t *addrs, uint64_t first, size_t n);
+
+/**
+ * @brief	gets the name of a generator
+ * @param	kind
+ * 			one of the ISU_MEM_GEN_ values
+ * @return	the short name used in file names, or NULL if `kind` is unknown
+ */
+const char *isu_mem_gen_name(int kind);
+
+#endif
@@ -0,0 +1,179 @@
+/**
+ * @file	isu_mem_log.c
+ * @brief	source file of isu_mem_log.h
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "isu_mem_log.h"
+#include "common/isu_error.h"
+
+/// the most bytes one request takes in any format, the buffer is written
+/// out once less than this is left
+#define ISU_MEM_LOG_LINE 256
+
+struct ISU_MEM_LOG_STRUCT{
+	/// the file the buffer is written to
+	FILE *file;
+
+	/// the format of the requests
+	int format;
+
+	/// the bytes not yet written and the number of them
+	char *buffer;
+	size_t used;
+
+	/// set once a write to the file fails
+	int failed;
+
+	/// the counters of the requests written
+	isu_mem_log_summary_t summary;
+};
+
+/// appends the literal string `s` to the buffer
+#define ISU_MEM_LOG_PUT(log, s) isu_mem_log_put(log, s, sizeof(s) - 1)
+
+static void isu_mem_log_put(isu_mem_log_t log, const char *s, size_t n){
+	memcpy(log->buffer + log->used, s, n);
+	log->used += n;
+}
+
+/// appends `v` in decimal, without going through printf
+static void isu_mem_log_put_u64(isu_mem_log_t log, unsigned long long v){
+	char digits[20];
+	int n = 0;
+	do{
+		digits[n++] = (char)('0' + v % 10);
+		v /= 10;
+	}while(v);
+	while(n){
+		log->buffer[log->used++] = digits[--n];
+	}
+}
+
+/// appends `v` as a little endian value of `n` bytes
+static void isu_mem_log_put_le(isu_mem_log_t log, uint64_t v, int n){
+	int i;
+	for(i = 0; i < n; i++){
+		log->buffer[log->used++] = (char)(v >> (8 * i));
+	}
+}
+
+isu_mem_log_t isu_mem_log_create(FILE *file, int format){
+	isu_mem_log_t log;
+	if(format < 0 || format >= ISU_MEM_LOG_FORMATS || (file == NULL && format != ISU_MEM_LOG_NONE)){
+		isu_print(PRINT_ERROR, "a log of format %d needs a file", format);
+		return NULL;
+	}
+	log = calloc(1, sizeof(struct ISU_MEM_LOG_STRUCT));
+	if(log == NULL){
+		isu_print(PRINT_ERROR, "calloc returned NULL");
+		return NULL;
+	}
+	log->file = file;
+	log->format = format;
+	if(format == ISU_MEM_LOG_NONE){
+		return log;
+	}
+	log->buffer = malloc(ISU_MEM_LOG_BUFFER);
+	if(log->buffer == NULL){
+		isu_print(PRINT_ERROR, "malloc returned NULL");
+		free(log);
+		return NULL;
+	}
+	if(format == ISU_MEM_LOG_BINARY){
+		isu_mem_log_put(log, ISU_MEM_LOG_MAGIC, 8);
+		isu_mem_log_put_le(log, ISU_MEM_LOG_VERSION, 2);
+		isu_mem_log_put_le(log, ISU_MEM_LOG_RECORD_SIZE, 2);
+		isu_mem_log_put_le(log, 0, 4);
+	}
+	return log;
+}
+
+int isu_mem_log_destroy(isu_mem_log_t log){
+	int ret = isu_mem_log_flush(log);
+	free(log->buffer);
+	free(log);
+	return ret;
+}
+
+int isu_mem_log_flush(isu_mem_log_t log){
+	if(log->used){
+		if(fwrite(log->buffer, 1, log->used, log->file) != log->used){
+			isu_print(PRINT_ERROR, "could not write the log");
+			log->failed = 1;
+		}
+		log->used = 0;
+	}
+	return log->failed ? -1 : 0;
+}
+
+int isu_mem_log_request(isu_mem_log_t log, uint64_t addr, unsigned int page_size, unsigned long long req_time,
+			unsigned long long handle_time, int level){
+	isu_mem_log_summary_t *s = &log->summary;
+	uint64_t page = page_size ? addr / page_size : 0;
+
+	s->requests++;
+	if(level < 0){
+		s->disk++;
+	}else{
+		s->hits[level < ISU_MEM_LOG_LEVELS ? level : ISU_MEM_LOG_LEVELS - 1]++;
+	}
+	s->latency += handle_time - req_time;
+	if(s->last < handle_time){
+		s->last = handle_time;
+	}
+
+	switch(log->format){
+	case ISU_MEM_LOG_TEXT:
+		ISU_MEM_LOG_PUT(log, "memory address: ");
+		isu_mem_log_put_u64(log, addr);
+		ISU_MEM_LOG_PUT(log, " in page: ");
+		isu_mem_log_put_u64(log, page);
+		ISU_MEM_LOG_PUT(log, " requested at time: ");
+		isu_mem_log_put_u64(log, req_time);
+		ISU_MEM_LOG_PUT(log, " handled at time: ");
+		isu_mem_log_put_u64(log, handle_time);
+		if(level == 0){
+			ISU_MEM_LOG_PUT(log, " and was a hit\n");
+		}else{
+			ISU_MEM_LOG_PUT(log, " and was a miss\n");
+		}
+		break;
+	case ISU_MEM_LOG_BINARY:
+		isu_mem_log_put_le(log, addr, 8);
+		isu_mem_log_put_le(log, req_time, 8);
+		isu_mem_log_put_le(log, handle_time, 8);
+		isu_mem_log_put_le(log, page_size, 4);
+		isu_mem_log_put_le(log, (uint64_t)(int64_t)level, 1);
+		break;
+	case ISU_MEM_LOG_JSON:
+		ISU_MEM_LOG_PUT(log, "{\"address\":");
+		isu_mem_log_put_u64(log, addr);
+		ISU_MEM_LOG_PUT(log, ",\"page\":");
+		isu_mem_log_put_u64(log, page);
+		ISU_MEM_LOG_PUT(log, ",\"req_time\":");
+		isu_mem_log_put_u64(log, req_time);
+		ISU_MEM_LOG_PUT(log, ",\"handle_time\":");
+		isu_mem_log_put_u64(log, handle_time);
+		ISU_MEM_LOG_PUT(log, ",\"level\":");
+		if(level < 0){
+			ISU_MEM_LOG_PUT(log, "-1}\n");
+		}else{
+			isu_mem_log_put_u64(log, (unsigned long long)level);
+			ISU_MEM_LOG_PUT(log, "}\n");
+		}
+		break;
+	default:
+		return 0;
+	}
+	if(ISU_MEM_LOG_BUFFER - log->used < ISU_MEM_LOG_LINE){
+		return isu_mem_log_flush(log);
+	}
+	return 0;
+}
+
+void isu_mem_log_get_summary(isu_mem_log_t log, isu_mem_log_summary_t *summary){
+	*summary = log->summary;
+}
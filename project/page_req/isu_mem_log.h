@@ -0,0 +1,131 @@
+/**
+ * @file	isu_mem_log.h
+ * @brief	buffered writer of the outcome of every request
+ * @details	Requests are written to a buffer of the writer's own and the
+ * 		buffer goes to the file once it fills, so a log costs one write
+ * 		per ISU_MEM_LOG_BUFFER bytes rather than one per request.  The
+ * 		writer also keeps the counters of the summary, so a run doesn't
+ * 		need to hold on to its requests to report them.
+ *
+ * 		A binary log is a header followed by one record per request.
+ * 		The header is ISU_MEM_LOG_MAGIC, the version and the size of a
+ * 		record as 2 bytes each, then 4 bytes of 0.  A record is the
+ * 		address, the time it was requested and the time it was handled
+ * 		as 8 bytes each, the page size as 4 bytes and the level as 1
+ * 		signed byte.  All values are little endian.
+ */
+
+#ifndef ISU_MEM_LOG_H
+#define ISU_MEM_LOG_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+/// one line of text per request, the lines mem_test has always written
+#define ISU_MEM_LOG_TEXT 0
+/// one binary record per request
+#define ISU_MEM_LOG_BINARY 1
+/// one JSON object per line per request
+#define ISU_MEM_LOG_JSON 2
+/// nothing per request, only the summary is kept
+#define ISU_MEM_LOG_NONE 3
+/// the number of formats
+#define ISU_MEM_LOG_FORMATS 4
+
+/// the first bytes of a binary log
+#define ISU_MEM_LOG_MAGIC "ISURESLT"
+/// the size of the header of a binary log
+#define ISU_MEM_LOG_HEADER_SIZE 16
+/// the size of each record of a binary log
+#define ISU_MEM_LOG_RECORD_SIZE 29
+/// the version of the binary format
+#define ISU_MEM_LOG_VERSION 1
+/// the bytes held before they are written to the file
+#define ISU_MEM_LOG_BUFFER (1 << 20)
+/// the levels the summary counts the hits of
+#define ISU_MEM_LOG_LEVELS 8
+
+/**
+ * @class	isu_mem_log_t
+ * @brief	a writer of requests and the counters of what it wrote
+ */
+typedef struct ISU_MEM_LOG_STRUCT *isu_mem_log_t;
+
+/**
+ * @brief	what the requests written so far add up to
+ */
+typedef struct ISU_MEM_LOG_SUMMARY{
+	/// the requests written
+	unsigned long long requests;
+	/// the requests found in each level, 0 being L1, the last entry also
+	/// counts any deeper level
+	unsigned long long hits[ISU_MEM_LOG_LEVELS];
+	/// the requests that came from disk
+	unsigned long long disk;
+	/// the time taken by all the requests, in nanoseconds
+	unsigned long long latency;
+	/// the time the last request was handled
+	unsigned long long last;
+}isu_mem_log_summary_t;
+
+/**
+ * @brief	constructs a writer
+ * @param	file
+ * 			the file to write to, which stays open once the writer is
+ * 			destroyed.  May be NULL for ISU_MEM_LOG_NONE
+ * @param	format
+ * 			one of the ISU_MEM_LOG_ formats
+ * @return	the writer or NULL if a failure occurs
+ * @details	A binary log gets its header right away.
+ */
+isu_mem_log_t isu_mem_log_create(FILE *file, int format);
+
+/**
+ * @brief	writes what is left in the buffer and destroys the writer
+ * @param	log
+ * 			the writer to destroy
+ * @return	0 if every request made it to the file, -1 if not
+ */
+int isu_mem_log_destroy(isu_mem_log_t log);
+
+/**
+ * @brief	writes one request
+ * @param	log
+ * 			the writer
+ * @param	addr
+ * 			the address of the request
+ * @param	page_size
+ * 			the size of the page that translated the address
+ * @param	req_time
+ * 			the time the request was issued
+ * @param	handle_time
+ * 			the time the request was handled
+ * @param	level
+ * 			the level the request was found in, 0 being L1, -1 for disk
+ * @return	0:
+ * 			the request was written
+ * @return	-1:
+ * 			the buffer couldn't be written to the file
+ */
+int isu_mem_log_request(isu_mem_log_t log, uint64_t addr, unsigned int page_size, unsigned long long req_time,
+			unsigned long long handle_time, int level);
+
+/**
+ * @brief	writes the buffer to the file
+ * @param	log
+ * 			the writer
+ * @return	0 on success, -1 if the file couldn't be written
+ * @details	Must be called before anything else writes to the file.
+ */
+int isu_mem_log_flush(isu_mem_log_t log);
+
+/**
+ * @brief	gets the summary of the requests written so far
+ * @param	log
+ * 			the writer
+ * @param	summary
+ * 			where to put the summary
+ */
+void isu_mem_log_get_summary(isu_mem_log_t log, isu_mem_log_summary_t *summary);
+
+#endif
@@ -0,0 +1,101 @@
+/**
+ * @file	isu_mem_pattern.c
+ * @brief	source file of isu_mem_pattern.h
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "isu_mem_pattern.h"
+#include "isu_mem_gen.h"
+
+/// the number of past addresses the spatial pattern picks from
+#define SPATIAL_WINDOW 5
+/// the pages of a 16-bit address
+#define PATTERN_PAGES 16
+/// the addresses a generator makes at a time, a whole block so no run
+/// replays the start of one
+#define PATTERN_CHUNK ISU_MEM_GEN_BLOCK
+
+/**
+ * @brief	generates the addresses of a pattern of isu_mem_gen.h
+ * @return	0 on success, -1 if the generator couldn't be made
+ */
+static int pattern_gen(int pattern, uint16_t *addrs, size_t n, unsigned int seed){
+	isu_mem_gen_desc_t desc;
+	isu_mem_gen_t gen;
+	uint64_t chunk[PATTERN_CHUNK];
+	size_t i;
+	size_t j;
+	size_t k;
+	isu_mem_gen_desc_init(&desc, pattern - ISU_MEM_PATTERN_ZIPF, PATTERN_PAGES, 4096, seed);
+	desc.pages = PATTERN_PAGES * desc.pages / isu_mem_gen_footprint(&desc);
+	desc.phase = 64 * desc.pages;
+	gen = isu_mem_gen_create(&desc);
+	if(gen == NULL){
+		return -1;
+	}
+	for(i = 0; i < n; i += j){
+		j = n - i < PATTERN_CHUNK ? n - i : PATTERN_CHUNK;
+		isu_mem_gen_fill(gen, chunk, i, j);
+		for(k = 0; k < j; k++){
+			addrs[i + k] = (uint16_t)chunk[k];
+		}
+	}
+	isu_mem_gen_destroy(gen);
+	return 0;
+}
+
+int isu_mem_pattern_fill(int pattern, uint16_t *addrs, size_t n, unsigned int seed){
+	size_t i;
+	int j;
+	/// the last addresses of the spatial pattern, the newest last
+	uint16_t past[SPATIAL_WINDOW];
+
+	if(pattern >= ISU_MEM_PATTERN_ZIPF && pattern < ISU_MEM_PATTERN_COUNT){
+		return pattern_gen(pattern, addrs, n, seed);
+	}
+	srand(seed);
+	for(i = 0; i < n; i++){
+		switch(pattern){
+		case ISU_MEM_PATTERN_SEQUENTIAL:
+			addrs[i] = (uint16_t)((i * 4096) % 65536);
+			break;
+		case ISU_MEM_PATTERN_RANDOM:
+			addrs[i] = (uint16_t)(rand() % 65536);
+			break;
+		case ISU_MEM_PATTERN_SPATIAL:
+			if(i < SPATIAL_WINDOW){
+				addrs[i] = (uint16_t)(rand() % 65536);
+				past[i] = addrs[i];
+				break;
+			}
+			/// 80% of the time reuse one of the last addresses
+			if((rand() % 100) < 80){
+				j = rand() % SPATIAL_WINDOW;
+				addrs[i] = past[SPATIAL_WINDOW - 1 - j];
+			}else{
+				addrs[i] = (uint16_t)(rand() % 65536);
+			}
+			memmove(past, past + 1, (SPATIAL_WINDOW - 1) * sizeof(uint16_t));
+			past[SPATIAL_WINDOW - 1] = addrs[i];
+			break;
+		default:
+			return -1;
+		}
+	}
+	return 0;
+}
+
+const char *isu_mem_pattern_name(int pattern){
+	switch(pattern){
+	case ISU_MEM_PATTERN_SEQUENTIAL: return "seqt";
+	case ISU_MEM_PATTERN_RANDOM: return "rand";
+	case ISU_MEM_PATTERN_SPATIAL: return "spatl";
+	case ISU_MEM_PATTERN_ZIPF:
+	case ISU_MEM_PATTERN_LOOP:
+	case ISU_MEM_PATTERN_PHASE:
+	case ISU_MEM_PATTERN_MIX: return isu_mem_gen_name(pattern - ISU_MEM_PATTERN_ZIPF);
+	default: return NULL;
+	}
+}
@@ -0,0 +1,58 @@
+/**
+ * @file	isu_mem_pattern.h
+ * @brief	synthetic memory access patterns
+ * @details	The patterns mem_test has always used, generated into a plain
+ * 		array of addresses so they can be shared by many MMUs at once.
+ * 		The generators of isu_mem_gen.h are offered too, sized to the 16
+ * 		pages of 4KB of a 16-bit address.
+ */
+
+#ifndef ISU_MEM_PATTERN_H
+#define ISU_MEM_PATTERN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/// every 4KB page in turn, over and over
+#define ISU_MEM_PATTERN_SEQUENTIAL 0
+/// uniformly random addresses
+#define ISU_MEM_PATTERN_RANDOM 1
+/// mostly repeats of one of the last 5 addresses
+#define ISU_MEM_PATTERN_SPATIAL 2
+/// a Zipfian hot set of every page
+#define ISU_MEM_PATTERN_ZIPF 3
+/// a loop through every page
+#define ISU_MEM_PATTERN_LOOP 4
+/// a Zipfian hot set of 4 pages that moves every 256 requests
+#define ISU_MEM_PATTERN_PHASE 5
+/// a Zipfian hot set of 8 pages mixed with a loop through the other 8
+#define ISU_MEM_PATTERN_MIX 6
+/// the number of patterns
+#define ISU_MEM_PATTERN_COUNT 7
+
+/**
+ * @brief	generates the addresses of a pattern
+ * @param	pattern
+ * 			one of the ISU_MEM_PATTERN_ values
+ * @param	addrs
+ * 			where to put the addresses
+ * @param	n
+ * 			the number of addresses to generate
+ * @param	seed
+ * 			the seed of the random numbers, mem_test uses 12345
+ * @return	0 on success, -1 if `pattern` is unknown
+ * @details	The first 3 patterns use srand() and rand(), so they must not be
+ * 		generated from more than one thread at a time.  The others draw
+ * 		from streams of their own.
+ */
+int isu_mem_pattern_fill(int pattern, uint16_t *addrs, size_t n, unsigned int seed);
+
+/**
+ * @brief	gets the name of a pattern
+ * @param	pattern
+ * 			one of the ISU_MEM_PATTERN_ values
+ * @return	the short name used in file names, or NULL if `pattern` is unknown
+ */
+const char *isu_mem_pattern_name(int pattern);
+
+#endif
@@ -7,46 +7,90 @@
 
 #include <stdio.h>
 #include <stdlib.h>
-#include "llist/isu_llist.h"
+#include <string.h>
 #include "isu_mem_req.h"
+#include "common/isu_error.h"
 
 /**
  * The main page request object type
  */
 struct ISU_MEM_REQ_STRUCT{
 	//the virtual address that is requested
-	unsigned short mem_address;
+	uint64_t mem_address;
+	//the address space(process) the address belongs to
+	unsigned int asid;
+	//the size of the page the address was translated by
+	unsigned int page_size;
 	//whether or not the address requested is within the current set of pages
 	char access_hit;
-	//list of the current set of pages for data logging
-	isu_llist_t pages;
+	//the level the page was found in, 0 being L1, -1 for disk
+	int level;
+	//whether the request writes to the address rather than reads it
+	char write;
+	//copy of the current set of pages for data logging, the first
+	//ISU_MEM_REQ_PAGES of them
+	int pages[ISU_MEM_REQ_PAGES];
+	//the number of pages added, which can be more than are kept
+	unsigned int n_pages;
+	//whether the request belongs to a pool rather than being on its own
+	char pooled;
 	//request time
 	unsigned long long req_time;
 	//handled time
 	unsigned long long handle_time;
 };
 
+/**
+ * A run of requests allocated at once
+ */
+struct ISU_MEM_REQ_SLAB{
+	//the next slab of the pool, NULL for the last
+	struct ISU_MEM_REQ_SLAB *next;
+	//the requests of the slab
+	struct ISU_MEM_REQ_STRUCT reqs[];
+};
+
+/**
+ * Requests handed out from slabs and all given back at once
+ */
+struct ISU_MEM_REQ_POOL_STRUCT{
+	//the first slab, the others follow it
+	struct ISU_MEM_REQ_SLAB *first;
+	//the slab requests are being handed out from
+	struct ISU_MEM_REQ_SLAB *current;
+	//the requests handed out from `current`
+	size_t used;
+	//the requests of each slab
+	size_t slab;
+};
+
 /**
  * @brief	create a new memory request
  * @param	addr
  * 			the address that is to be requested
  * @return	the memory request or NULL if something horrible happens
  */
-isu_mem_req_t isu_mem_req_create(unsigned short addr){
+isu_mem_req_t isu_mem_req_create(uint64_t addr){
 	isu_mem_req_t ret;
 	ret = calloc(1, sizeof(struct ISU_MEM_REQ_STRUCT));
+	if(ret == NULL){
+		isu_print(PRINT_ERROR, "calloc returned NULL");
+		return NULL;
+	}
 	ret->mem_address = addr;
-	ret->pages = isu_llist_create();
 	return ret;
 }
 
 /**
  * @brief	destroy a memory request object
  * @param	req
- * 			the memory request to destroy
+ * 			the memory request to destroy, a request of a pool is left
+ * 			for isu_mem_req_pool_reset()
  */
 void isu_mem_req_destroy(isu_mem_req_t req){
-	isu_llist_destroy(req->pages);
+	if(req->pooled){
+		return;
+	}
 	free(req);
 }
 /**
@@ -55,9 +99,48 @@ void isu_mem_req_destroy(isu_mem_req_t req){
  * 			the memory request to get the address from
  * @return	the value of `mem_address` stored in the variable req
  */
-unsigned short isu_mem_req_get_address(isu_mem_req_t req){
+uint64_t isu_mem_req_get_address(isu_mem_req_t req){
 	return req->mem_address;
 }
+/**
+ * @brief	gets the value of the variable `asid`
+ * @param	req
+ * 			the memory request to get the address space from
+ * @return	the address space of the request, 0 unless it was set
+ */
+unsigned int isu_mem_req_get_asid(isu_mem_req_t req){
+	return req->asid;
+}
+/**
+ * @brief	sets the value of the variable `asid`
+ * @param	req
+ * 			the memory request to set the address space of
+ * @param	asid
+ * 			the address space(process) the address of the request is in
+ */
+void isu_mem_req_set_asid(isu_mem_req_t req, unsigned int asid){
+	req->asid = asid;
+}
+/**
+ * @brief	gets the value of the variable `page_size`
+ * @param	req
+ * 			the memory request to get the page size from
+ * @return	the size of the page that translated the address, 0 if the
+ * 		request wasn't handled yet
+ */
+unsigned int isu_mem_req_get_page_size(isu_mem_req_t req){
+	return req->page_size;
+}
+/**
+ * @brief	sets the value of the variable `page_size`
+ * @param	req
+ * 			the memory request to set the page size of
+ * @param	page_size
+ * 			the size of the page that translated the address
+ */
+void isu_mem_req_set_page_size(isu_mem_req_t req, unsigned int page_size){
+	req->page_size = page_size;
+}
 /**
  * @brief	gets the value of the variable `access_hit`
  * @param	req
@@ -76,6 +159,44 @@ char isu_mem_req_get_access_hit(isu_mem_req_t req){
 void isu_mem_req_set_access_hit(isu_mem_req_t req, char hit){
 	req->access_hit = hit;
 }
+/**
+ * @brief	gets the value of the variable `level`
+ * @param	req
+ * 			the memory request to get the level from
+ * @return	the level the page was found in, 0 being L1 and -1 being disk
+ */
+int isu_mem_req_get_level(isu_mem_req_t req){
+	return req->level;
+}
+/**
+ * @brief	sets the value of the variable `level`
+ * @param	req
+ * 			the memory request to set the level of
+ * @param	level
+ * 			the level the page was found in, 0 being L1 and -1 being disk
+ */
+void isu_mem_req_set_level(isu_mem_req_t req, int level){
+	req->level = level;
+}
+/**
+ * @brief	gets the value of the variable `write`
+ * @param	req
+ * 			the memory request to get the value of `write` from
+ * @return	1 if the request is a write, 0 if it is a read
+ */
+char isu_mem_req_get_write(isu_mem_req_t req){
+	return req->write;
+}
+/**
+ * @brief	sets the value of the variable `write`
+ * @param	req
+ * 			the memory request to set the value of `write`
+ * @param	write
+ * 			1 if the request writes to its address, 0 if it reads it
+ */
+void isu_mem_req_set_write(isu_mem_req_t req, char write){
+	req->write = write;
+}
 
 /**
  * @brief	adds a page from the list of current pages to the data logging list of an isu_mem_req_t
@@ -85,9 +206,35 @@ void isu_mem_req_set_access_hit(isu_mem_req_t req, char hit){
  * 			the page number to be added to the list
  */
 void isu_mem_req_add_page(isu_mem_req_t req, int page_num){
-	int *temp = calloc(1, sizeof(int));
-	*temp = page_num;
-	isu_llist_push(req->pages, (void *)temp, ISU_LLIST_TAIL);
+	if(req->n_pages < ISU_MEM_REQ_PAGES){
+		req->pages[req->n_pages] = page_num;
+	}
+	req->n_pages++;
+}
+
+/**
+ * @brief	gets the number of pages added to the data logging list
+ * @param	req
+ * 			the memory request object to get the count from
+ * @return	the pages added, of which only the first ISU_MEM_REQ_PAGES are kept
+ */
+unsigned int isu_mem_req_get_page_count(isu_mem_req_t req){
+	return req->n_pages;
+}
+
+/**
+ * @brief	gets a page of the data logging list
+ * @param	req
+ * 			the memory request object to get the page from
+ * @param	i
+ * 			the position of the page in the list
+ * @return	the page number, or -1 if `i` is not one of the pages kept
+ */
+int isu_mem_req_get_page(isu_mem_req_t req, unsigned int i){
+	if(i >= req->n_pages || i >= ISU_MEM_REQ_PAGES){
+		return -1;
+	}
+	return req->pages[i];
 }
 
 /**
@@ -131,8 +278,92 @@ unsigned long long isu_mem_req_get_handle_time(isu_mem_req_t req){
 void isu_mem_req_set_handle_time(isu_mem_req_t req, unsigned long long t){
 	req->handle_time = t;
 }
+
 /**
- * @brief	a
- * @param	req
- * 			the memory request object to grab page data from
+ * @brief	create a pool of memory requests
+ * @param	slab
+ * 			the number of requests allocated at a time
+ * @return	the pool or NULL if something horrible happens
+ * @details	Requests of a pool are handed out by isu_mem_req_pool_get() and
+ * 		all given back at once by isu_mem_req_pool_reset(), so a long
+ * 		run of requests costs one allocation per slab rather than one
+ * 		per request.
  */
+isu_mem_req_pool_t isu_mem_req_pool_create(size_t slab){
+	isu_mem_req_pool_t pool;
+	if(slab == 0){
+		isu_print(PRINT_ERROR, "a slab needs at least one request");
+		return NULL;
+	}
+	pool = calloc(1, sizeof(struct ISU_MEM_REQ_POOL_STRUCT));
+	if(pool == NULL){
+		isu_print(PRINT_ERROR, "calloc returned NULL");
+		return NULL;
+	}
+	pool->slab = slab;
+	return pool;
+}
+
+/**
+ * @brief	destroy a pool and every request handed out from it
+ * @param	pool
+ * 			the pool to destroy
+ */
+void isu_mem_req_pool_destroy(isu_mem_req_pool_t pool){
+	struct ISU_MEM_REQ_SLAB *s;
+	while(pool->first){
+		s = pool->first;
+		pool->first = s->next;
+		free(s);
+	}
+	free(pool);
+}
+
+/**
+ * @brief	get a new memory request from a pool
+ * @param	pool
+ * 			the pool to take the request from
+ * @param	addr
+ * 			the address that is to be requested
+ * @return	the memory request or NULL if a new slab can't be allocated
+ * @details	The request lives until the pool is reset or destroyed.
+ */
+isu_mem_req_t isu_mem_req_pool_get(isu_mem_req_pool_t pool, uint64_t addr){
+	isu_mem_req_t ret;
+	struct ISU_MEM_REQ_SLAB *s;
+	if(pool->current == NULL || pool->used == pool->slab){
+		/// slabs kept by a reset are used again before new ones are made
+		s = pool->current ? pool->current->next : pool->first;
+		if(s == NULL){
+			s = malloc(sizeof(struct ISU_MEM_REQ_SLAB) + pool->slab * sizeof(struct ISU_MEM_REQ_STRUCT));
+			if(s == NULL){
+				isu_print(PRINT_ERROR, "malloc returned NULL");
+				return NULL;
+			}
+			s->next = NULL;
+			if(pool->current){
+				pool->current->next = s;
+			}else{
+				pool->first = s;
+			}
+		}
+		pool->current = s;
+		pool->used = 0;
+	}
+	ret = &pool->current->reqs[pool->used++];
+	memset(ret, 0, sizeof(struct ISU_MEM_REQ_STRUCT));
+	ret->mem_address = addr;
+	ret->pooled = 1;
+	return ret;
+}
+
+/**
+ * @brief	give back every request of a pool at once
+ * @param	pool
+ * 			the pool to reset
+ * @details	The slabs are kept for the requests that follow.
+ */
+void isu_mem_req_pool_reset(isu_mem_req_pool_t pool){
+	pool->current = NULL;
+	pool->used = 0;
+}
@@ -10,18 +10,39 @@
 #ifndef ISU_MEM_REQ_H
 #define ISU_MEM_REQ_H
 
+#include <stddef.h>
+#include <stdint.h>
+
+/// the most L1 pages a request keeps a copy of, the rest are only counted
+#define ISU_MEM_REQ_PAGES 16
+
 typedef struct ISU_MEM_REQ_STRUCT *isu_mem_req_t;
+typedef struct ISU_MEM_REQ_POOL_STRUCT *isu_mem_req_pool_t;
 
-isu_mem_req_t isu_mem_req_create(unsigned short addr);
+isu_mem_req_t isu_mem_req_create(uint64_t addr);
 void isu_mem_req_destroy(isu_mem_req_t req);
-unsigned short isu_mem_req_get_address(isu_mem_req_t req);
+uint64_t isu_mem_req_get_address(isu_mem_req_t req);
+unsigned int isu_mem_req_get_asid(isu_mem_req_t req);
+void isu_mem_req_set_asid(isu_mem_req_t req, unsigned int asid);
+unsigned int isu_mem_req_get_page_size(isu_mem_req_t req);
+void isu_mem_req_set_page_size(isu_mem_req_t req, unsigned int page_size);
 char isu_mem_req_get_access_hit(isu_mem_req_t req);
 void isu_mem_req_set_access_hit(isu_mem_req_t req, char hit);
+int isu_mem_req_get_level(isu_mem_req_t req);
+void isu_mem_req_set_level(isu_mem_req_t req, int level);
+char isu_mem_req_get_write(isu_mem_req_t req);
+void isu_mem_req_set_write(isu_mem_req_t req, char write);
 void isu_mem_req_add_page(isu_mem_req_t req, int page_num);
+unsigned int isu_mem_req_get_page_count(isu_mem_req_t req);
+int isu_mem_req_get_page(isu_mem_req_t req, unsigned int i);
 unsigned long long isu_mem_req_get_req_time(isu_mem_req_t req);
 void isu_mem_req_set_req_time(isu_mem_req_t req, unsigned long long t);
 unsigned long long isu_mem_req_get_handle_time(isu_mem_req_t req);
 void isu_mem_req_set_handle_time(isu_mem_req_t req, unsigned long long t);
-char *isu_mem_req_to_json(isu_mem_req_t req);
+
+isu_mem_req_pool_t isu_mem_req_pool_create(size_t slab);
+void isu_mem_req_pool_destroy(isu_mem_req_pool_t pool);
+isu_mem_req_t isu_mem_req_pool_get(isu_mem_req_pool_t pool, uint64_t addr);
+void isu_mem_req_pool_reset(isu_mem_req_pool_t pool);
 
 #endif
@@ -0,0 +1,220 @@
+/**
+ * @file	isu_mem_trace.c
+ * @brief	source file of isu_mem_trace.h
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "isu_mem_trace.h"
+#include "common/isu_error.h"
+
+struct ISU_MEM_TRACE_STRUCT{
+	/// the whole mapped file
+	unsigned char *map;
+	/// the size of the mapped file
+	size_t size;
+	/// the header at the start of `map`
+	isu_mem_trace_header_t header;
+	/// the first address
+	const unsigned char *addrs;
+	/// the read/write bitmap, NULL if the trace has none
+	const unsigned char *rw;
+};
+
+/// reads a little endian value of `n` bytes
+static uint64_t isu_mem_trace_load(const unsigned char *p, int n){
+	uint64_t v = 0;
+	while(n--){
+		v = (v << 8) | p[n];
+	}
+	return v;
+}
+
+isu_mem_trace_t isu_mem_trace_open(const char *path){
+	int fd;
+	struct stat st;
+	uint64_t need;
+	isu_mem_trace_t trace;
+	const unsigned char *p;
+
+	fd = open(path, O_RDONLY);
+	if(fd < 0){
+		isu_print(PRINT_ERROR, "could not open %s", path);
+		return NULL;
+	}
+	if(fstat(fd, &st) < 0 || (size_t)st.st_size < ISU_MEM_TRACE_HEADER_SIZE){
+		isu_print(PRINT_ERROR, "%s is too short to be a trace", path);
+		close(fd);
+		return NULL;
+	}
+	trace = calloc(1, sizeof(struct ISU_MEM_TRACE_STRUCT));
+	if(trace == NULL){
+		isu_print(PRINT_ERROR, "calloc returned NULL");
+		close(fd);
+		return NULL;
+	}
+	trace->size = (size_t)st.st_size;
+	trace->map = mmap(NULL, trace->size, PROT_READ, MAP_PRIVATE, fd, 0);
+	/// the mapping stays valid once the file is closed
+	close(fd);
+	if(trace->map == MAP_FAILED){
+		isu_print(PRINT_ERROR, "could not map %s", path);
+		free(trace);
+		return NULL;
+	}
+	/// the file is read from front to back
+	madvise(trace->map, trace->size, MADV_SEQUENTIAL);
+
+	p = trace->map;
+	memcpy(trace->header.magic, p, 8);
+	trace->header.version = (uint16_t)isu_mem_trace_load(p + 8, 2);
+	trace->header.addr_bytes = p[10];
+	trace->header.flags = p[11];
+	trace->header.reserved = (uint32_t)isu_mem_trace_load(p + 12, 4);
+	trace->header.count = isu_mem_trace_load(p + 16, 8);
+	if(memcmp(trace->header.magic, ISU_MEM_TRACE_MAGIC, 8) != 0 ||
+	   trace->header.version != ISU_MEM_TRACE_VERSION ||
+	   (trace->header.addr_bytes != 2 && trace->header.addr_bytes != 4 && trace->header.addr_bytes != 8)){
+		isu_print(PRINT_ERROR, "%s is not a version %d trace", path, ISU_MEM_TRACE_VERSION);
+		isu_mem_trace_close(trace);
+		return NULL;
+	}
+	need = trace->size + 1;
+	if(trace->header.count <= trace->size / trace->header.addr_bytes){
+		need = ISU_MEM_TRACE_HEADER_SIZE + trace->header.count * trace->header.addr_bytes;
+	}
+	if(trace->header.flags & ISU_MEM_TRACE_RW){
+		need += (trace->header.count + 7) / 8;
+	}
+	if(need > trace->size){
+		isu_print(PRINT_ERROR, "%s is cut short, %llu of %llu bytes", path,
+			(unsigned long long)trace->size, (unsigned long long)need);
+		isu_mem_trace_close(trace);
+		return NULL;
+	}
+	trace->addrs = trace->map + ISU_MEM_TRACE_HEADER_SIZE;
+	if(trace->header.flags & ISU_MEM_TRACE_RW){
+		trace->rw = trace->addrs + trace->header.count * trace->header.addr_bytes;
+	}
+	return trace;
+}
+
+void isu_mem_trace_close(isu_mem_trace_t trace){
+	munmap(trace->map, trace->size);
+	free(trace);
+}
+
+uint64_t isu_mem_trace_count(isu_mem_trace_t trace){
+	return trace->header.count;
+}
+
+int isu_mem_trace_addr_bytes(isu_mem_trace_t trace){
+	return trace->header.addr_bytes;
+}
+
+int isu_mem_trace_has_rw(isu_mem_trace_t trace){
+	return trace->rw != NULL;
+}
+
+uint64_t isu_mem_trace_addr(isu_mem_trace_t trace, uint64_t i){
+	return isu_mem_trace_load(trace->addrs + i * trace->header.addr_bytes, trace->header.addr_bytes);
+}
+
+int isu_mem_trace_is_write(isu_mem_trace_t trace, uint64_t i){
+	if(trace->rw == NULL){
+		return 0;
+	}
+	return (trace->rw[i / 8] >> (i % 8)) & 1;
+}
+
+size_t isu_mem_trace_read16(isu_mem_trace_t trace, uint64_t first, uint16_t *addrs, size_t n){
+	size_t i;
+	int stride = trace->header.addr_bytes;
+	const unsigned char *p;
+	if(first >= trace->header.count){
+		return 0;
+	}
+	if(n > trace->header.count - first){
+		n = (size_t)(trace->header.count - first);
+	}
+	/// only the low two bytes of each address are needed
+	p = trace->addrs + first * stride;
+	for(i = 0; i < n; i++){
+		addrs[i] = (uint16_t)(p[0] | (p[1] << 8));
+		p += stride;
+	}
+	return n;
+}
+
+size_t isu_mem_trace_read64(isu_mem_trace_t trace, uint64_t first, uint64_t *addrs, size_t n){
+	size_t i;
+	int stride = trace->header.addr_bytes;
+	const unsigned char *p;
+	if(first >= trace->header.count){
+		return 0;
+	}
+	if(n > trace->header.count - first){
+		n = (size_t)(trace->header.count - first);
+	}
+	p = trace->addrs + first * stride;
+	for(i = 0; i < n; i++){
+		addrs[i] = isu_mem_trace_load(p, stride);
+		p += stride;
+	}
+	return n;
+}
+
+size_t isu_mem_trace_read_rw(isu_mem_trace_t trace, uint64_t first, uint8_t *writes, size_t n){
+	size_t i;
+	uint64_t bit;
+	if(first >= trace->header.count){
+		return 0;
+	}
+	if(n > trace->header.count - first){
+		n = (size_t)(trace->header.count - first);
+	}
+	if(trace->rw == NULL){
+		memset(writes, 0, n);
+		return n;
+	}
+	for(i = 0; i < n; i++){
+		bit = first + i;
+		writes[i] = (trace->rw[bit / 8] >> (bit % 8)) & 1;
+	}
+	return n;
+}
+
+/// writes `v` as a little endian value of `n` bytes
+static int isu_mem_trace_store(FILE *file, uint64_t v, int n){
+	unsigned char b[8];
+	int i;
+	for(i = 0; i < n; i++){
+		b[i] = (unsigned char)(v >> (8 * i));
+	}
+	return fwrite(b, 1, n, file) == (size_t)n ? 0 : -1;
+}
+
+int isu_mem_trace_write_header(FILE *file, int addr_bytes, int flags, uint64_t count){
+	if(addr_bytes != 2 && addr_bytes != 4 && addr_bytes != 8){
+		isu_print(PRINT_ERROR, "addresses can't be %d bytes", addr_bytes);
+		return -1;
+	}
+	if(fwrite(ISU_MEM_TRACE_MAGIC, 1, 8, file) != 8 ||
+	   isu_mem_trace_store(file, ISU_MEM_TRACE_VERSION, 2) < 0 ||
+	   isu_mem_trace_store(file, addr_bytes, 1) < 0 ||
+	   isu_mem_trace_store(file, flags, 1) < 0 ||
+	   isu_mem_trace_store(file, 0, 4) < 0 ||
+	   isu_mem_trace_store(file, count, 8) < 0){
+		return -1;
+	}
+	return 0;
+}
+
+int isu_mem_trace_write_addr(FILE *file, int addr_bytes, uint64_t addr){
+	return isu_mem_trace_store(file, addr, addr_bytes);
+}
@@ -0,0 +1,183 @@
+/**
+ * @file	isu_mem_trace.h
+ * @brief	binary memory address traces
+ * @details	A trace file is a header followed by the address of every
+ * 		request, packed in 2, 4 or 8 bytes each.  If the trace has
+ * 		read/write flags they follow the addresses as a bitmap, one bit
+ * 		per request, set for a write.  All values are little endian.
+ *
+ * 		Traces are opened with mmap, so opening one costs the same no
+ * 		matter how many requests it holds, and only the pages of the file
+ * 		being read need to be in memory.
+ */
+
+#ifndef ISU_MEM_TRACE_H
+#define ISU_MEM_TRACE_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+/// the first bytes of every trace file
+#define ISU_MEM_TRACE_MAGIC "ISUTRACE"
+/// the size of the header in the file
+#define ISU_MEM_TRACE_HEADER_SIZE 24
+/// the version of the trace format
+#define ISU_MEM_TRACE_VERSION 1
+/// header flag, the trace has a read/write bitmap
+#define ISU_MEM_TRACE_RW 0x1
+
+/**
+ * the header at the start of every trace file
+ */
+typedef struct ISU_MEM_TRACE_HEADER{
+	/// ISU_MEM_TRACE_MAGIC, without the terminating NUL
+	char magic[8];
+	/// ISU_MEM_TRACE_VERSION
+	uint16_t version;
+	/// the size of each address, 2, 4 or 8
+	uint8_t addr_bytes;
+	/// ISU_MEM_TRACE_RW or 0
+	uint8_t flags;
+	/// must be 0
+	uint32_t reserved;
+	/// the number of requests in the trace
+	uint64_t count;
+}isu_mem_trace_header_t;
+
+/**
+ * @class	isu_mem_trace_t
+ * @brief	an open trace file
+ */
+typedef struct ISU_MEM_TRACE_STRUCT *isu_mem_trace_t;
+
+/**
+ * @brief	opens a trace file
+ * @param	path
+ * 			the path of the trace file
+ * @return	the trace or NULL if it can't be opened or isn't a valid trace
+ */
+isu_mem_trace_t isu_mem_trace_open(const char *path);
+
+/**
+ * @brief	closes a trace file
+ * @param	trace
+ * 			the trace to close
+ */
+void isu_mem_trace_close(isu_mem_trace_t trace);
+
+/**
+ * @brief	gets the number of requests in a trace
+ * @param	trace
+ * 			the trace
+ * @return	the number of requests
+ */
+uint64_t isu_mem_trace_count(isu_mem_trace_t trace);
+
+/**
+ * @brief	gets the size of the addresses of a trace
+ * @param	trace
+ * 			the trace
+ * @return	2, 4 or 8 bytes
+ */
+int isu_mem_trace_addr_bytes(isu_mem_trace_t trace);
+
+/**
+ * @brief	checks if a trace has read/write flags
+ * @param	trace
+ * 			the trace
+ * @return	1 if it does, 0 if every request is a read
+ */
+int isu_mem_trace_has_rw(isu_mem_trace_t trace);
+
+/**
+ * @brief	gets the address of a request
+ * @param	trace
+ * 			the trace
+ * @param	i
+ * 			the position of the request, less than isu_mem_trace_count()
+ * @return	the address of request `i`
+ */
+uint64_t isu_mem_trace_addr(isu_mem_trace_t trace, uint64_t i);
+
+/**
+ * @brief	checks if a request is a write
+ * @param	trace
+ * 			the trace
+ * @param	i
+ * 			the position of the request, less than isu_mem_trace_count()
+ * @return	1 if request `i` is a write, 0 if it is a read
+ */
+int isu_mem_trace_is_write(isu_mem_trace_t trace, uint64_t i);
+
+/**
+ * @brief	reads a run of requests as 16-bit addresses
+ * @param	trace
+ * 			the trace
+ * @param	first
+ * 			the position of the first request to read
+ * @param	addrs
+ * 			where to put the addresses
+ * @param	n
+ * 			the most requests to read
+ * @return	the number of requests read, 0 at the end of the trace
+ * @details	Wider addresses keep only their low 16 bits, the address space
+ * 		of the MMU.
+ */
+size_t isu_mem_trace_read16(isu_mem_trace_t trace, uint64_t first, uint16_t *addrs, size_t n);
+
+/**
+ * @brief	reads a run of requests with their full addresses
+ * @param	trace
+ * 			the trace
+ * @param	first
+ * 			the position of the first request to read
+ * @param	addrs
+ * 			where to put the addresses
+ * @param	n
+ * 			the most requests to read
+ * @return	the number of requests read, 0 at the end of the trace
+ */
+size_t isu_mem_trace_read64(isu_mem_trace_t trace, uint64_t first, uint64_t *addrs, size_t n);
+
+/**
+ * @brief	reads the read/write flags of a run of requests
+ * @param	trace
+ * 			the trace
+ * @param	first
+ * 			the position of the first request to read
+ * @param	writes
+ * 			where to put the flags, 1 for a write and 0 for a read
+ * @param	n
+ * 			the most requests to read
+ * @return	the number of requests read, 0 at the end of the trace
+ * @details	A trace without ISU_MEM_TRACE_RW reads as all reads.
+ */
+size_t isu_mem_trace_read_rw(isu_mem_trace_t trace, uint64_t first, uint8_t *writes, size_t n);
+
+/**
+ * @brief	writes a trace header
+ * @param	file
+ * 			the file to write to, at the position of the header
+ * @param	addr_bytes
+ * 			the size of each address, 2, 4 or 8
+ * @param	flags
+ * 			ISU_MEM_TRACE_RW or 0
+ * @param	count
+ * 			the number of requests that will follow
+ * @return	0 on success, -1 on failure
+ */
+int isu_mem_trace_write_header(FILE *file, int addr_bytes, int flags, uint64_t count);
+
+/**
+ * @brief	writes the address of one request
+ * @param	file
+ * 			the file to write to
+ * @param	addr_bytes
+ * 			the size of the address, as given to isu_mem_trace_write_header()
+ * @param	addr
+ * 			the address
+ * @return	0 on success, -1 on failure
+ */
+int isu_mem_trace_write_addr(FILE *file, int addr_bytes, uint64_t addr);
+
+#endif
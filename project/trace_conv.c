@@ -0,0 +1,156 @@
+/**
+ * @file	trace_conv.c
+ * @brief	converts a text trace of memory addresses to a binary trace
+ * @details	The text trace has one request per line, an address in decimal
+ * 		or 0x hex, optionally led by R or W for a read or a write.  Blank
+ * 		lines and lines starting with # are skipped.  The binary trace is
+ * 		the format of page_req/isu_mem_trace.h, which mem_test replays.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdint.h>
+#include "page_req/isu_mem_trace.h"
+
+/// the longest line of a text trace
+#define LINE_LEN 256
+
+/**
+ * @brief	parses a line of a text trace
+ * @param	line
+ * 			the line
+ * @param	addr
+ * 			set to the address of the request
+ * @param	rw
+ * 			set to 'R' or 'W' if the line has a flag, 0 if not
+ * @return	1 if the line is a request, 0 if it is to be skipped, -1 if it
+ * 		can't be parsed
+ */
+static int parse_line(const char *line, uint64_t *addr, int *rw){
+	char *end;
+	while(isspace((unsigned char)*line)){
+		line++;
+	}
+	if(*line == '\0' || *line == '#'){
+		return 0;
+	}
+	*rw = 0;
+	if(toupper((unsigned char)*line) == 'R' || toupper((unsigned char)*line) == 'W'){
+		*rw = toupper((unsigned char)*line);
+		line++;
+	}
+	*addr = strtoull(line, &end, 0);
+	if(end == line){
+		return -1;
+	}
+	while(isspace((unsigned char)*end)){
+		end++;
+	}
+	return *end == '\0' ? 1 : -1;
+}
+
+int main(int argc, char **argv){
+	FILE *in;
+	FILE *out;
+	char line[LINE_LEN];
+	uint64_t addr;
+	uint64_t max_addr = 0;
+	uint64_t count = 0;
+	uint64_t i = 0;
+	unsigned long line_no = 0;
+	int rw;
+	int has_rw = 0;
+	int addr_bytes = 0;
+	int ret;
+	unsigned char *bitmap = NULL;
+
+	if(argc < 3){
+		printf("usage: trace_conv <text trace> <binary trace> [bits]\n\n");
+		printf("bits:\t\tthe size of each address, 16, 32 or 64.  Picks the\n");
+		printf("\t\tsmallest that fits every address if not given.\n");
+		return -1;
+	}
+	if(argc > 3){
+		addr_bytes = atoi(argv[3]) / 8;
+		if(addr_bytes != 2 && addr_bytes != 4 && addr_bytes != 8){
+			printf("Error: addresses must be 16, 32 or 64 bits\n");
+			return -1;
+		}
+	}
+	in = fopen(argv[1], "r");
+	if(in == NULL){
+		perror("Could not open the text trace");
+		return -1;
+	}
+
+	/// first pass, count the requests and find the widest address
+	while(fgets(line, sizeof(line), in)){
+		line_no++;
+		ret = parse_line(line, &addr, &rw);
+		if(ret < 0){
+			printf("Error: line %lu of %s is not a request\n", line_no, argv[1]);
+			fclose(in);
+			return -1;
+		}
+		if(ret == 0){
+			continue;
+		}
+		count++;
+		has_rw |= rw != 0;
+		if(addr > max_addr){
+			max_addr = addr;
+		}
+	}
+	if(addr_bytes == 0){
+		addr_bytes = max_addr <= 0xFFFF ? 2 : max_addr <= 0xFFFFFFFFULL ? 4 : 8;
+	}else if(addr_bytes < 8 && max_addr >> (8 * addr_bytes)){
+		printf("Error: address %llu does not fit in %d bits\n", (unsigned long long)max_addr, 8 * addr_bytes);
+		fclose(in);
+		return -1;
+	}
+	if(has_rw){
+		bitmap = calloc((size_t)((count + 7) / 8) + 1, 1);
+		if(bitmap == NULL){
+			perror("Malloc encountered an error");
+			fclose(in);
+			return -1;
+		}
+	}
+
+	out = fopen(argv[2], "wb");
+	if(out == NULL){
+		perror("Could not open the binary trace");
+		fclose(in);
+		free(bitmap);
+		return -1;
+	}
+	ret = isu_mem_trace_write_header(out, addr_bytes, has_rw ? ISU_MEM_TRACE_RW : 0, count);
+
+	/// second pass, write the addresses and collect the write flags
+	rewind(in);
+	while(ret == 0 && fgets(line, sizeof(line), in)){
+		if(parse_line(line, &addr, &rw) != 1){
+			continue;
+		}
+		ret = isu_mem_trace_write_addr(out, addr_bytes, addr);
+		if(rw == 'W'){
+			bitmap[i / 8] |= (unsigned char)(1 << (i % 8));
+		}
+		i++;
+	}
+	if(ret == 0 && has_rw && fwrite(bitmap, 1, (size_t)((count + 7) / 8), out) != (size_t)((count + 7) / 8)){
+		ret = -1;
+	}
+	fclose(in);
+	if(fclose(out) != 0 || ret < 0){
+		perror("Could not write the binary trace");
+		free(bitmap);
+		return -1;
+	}
+	free(bitmap);
+	printf("wrote %llu requests of %d bits%s to %s\n", (unsigned long long)count, 8 * addr_bytes,
+		has_rw ? " with read/write flags" : "", argv[2]);
+	return 0;
+}
@@ -0,0 +1,154 @@
+/**
+ * @file	trace_gen.c
+ * @brief	writes a synthetic workload to a binary trace
+ * @details	The workload is one of the generators of page_req/isu_mem_gen.h,
+ * 		generated a chunk at a time with the chunk split between
+ * 		threads.  Every request comes from the stream of its block, so
+ * 		the trace is the same whatever the number of threads.  The
+ * 		trace is the format of page_req/isu_mem_trace.h, which mem_test
+ * 		and mem_sweep replay.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "page_req/isu_mem_gen.h"
+#include "page_req/isu_mem_trace.h"
+
+/// the requests generated between writes, a whole number of blocks
+#define CHUNK (256 * ISU_MEM_GEN_BLOCK)
+/// the most threads generating a chunk
+#define MAX_THREADS 64
+
+/// the part of a chunk one thread generates
+struct SLICE{
+	isu_mem_gen_t gen;
+	uint64_t *addrs;
+	uint64_t first;
+	size_t n;
+};
+
+static void *gen_slice(void *arg){
+	struct SLICE *s = arg;
+	isu_mem_gen_fill(s->gen, s->addrs, s->first, s->n);
+	return NULL;
+}
+
+int main(int argc, char **argv){
+	isu_mem_gen_desc_t desc;
+	isu_mem_gen_t gen;
+	FILE *out;
+	uint64_t *addrs;
+	uint64_t count;
+	uint64_t max_addr;
+	uint64_t i;
+	size_t n;
+	size_t j;
+	size_t per;
+	int kind;
+	int threads;
+	int t;
+	int addr_bytes;
+	int ret;
+	pthread_t tids[MAX_THREADS];
+	struct SLICE slices[MAX_THREADS];
+
+	if(argc < 4){
+		printf("usage: trace_gen <generator> <requests> <binary trace> [pages] [skew] [phase] [scan] [seed] [threads]\n\n");
+		printf("generator:\tthe workload to write.\n");
+		printf("\t\t0 - Zipfian hot set\n");
+		printf("\t\t1 - loop through every page\n");
+		printf("\t\t2 - Zipfian hot set moving between %d regions each phase\n", ISU_MEM_GEN_REGIONS);
+		printf("\t\t3 - Zipfian hot set mixed with a loop through as many\n");
+		printf("\t\t    other pages\n");
+		printf("pages:\t\tpages of 4KB of the hot set or of the loop, 65536 if\n");
+		printf("\t\tnot given.\n");
+		printf("skew:\t\tthe exponent of the Zipfian distribution from 0 up to\n");
+		printf("\t\tbut not including 1, 0.99 if not given.\n");
+		printf("phase:\t\trequests of each phase, 64 per page if not given.\n");
+		printf("scan:\t\tthe share of a mix that is in the loop, 0.2 if not\n");
+		printf("\t\tgiven.\n");
+		printf("seed:\t\tthe seed of the workload, 12345 if not given.\n");
+		printf("threads:\tthreads generating the requests, 1 if not given.\n");
+		return -1;
+	}
+	kind = atoi(argv[1]);
+	count = strtoull(argv[2], NULL, 10);
+	if(isu_mem_gen_name(kind) == NULL){
+		printf("Error: the value for `generator` is not within the acceptable range\n");
+		return -1;
+	}
+	isu_mem_gen_desc_init(&desc, kind, argc > 4 ? strtoull(argv[4], NULL, 10) : 65536, 4096,
+			      argc > 8 ? strtoull(argv[8], NULL, 10) : 12345);
+	if(argc > 5){
+		desc.skew = atof(argv[5]);
+	}
+	if(argc > 6){
+		desc.phase = strtoull(argv[6], NULL, 10);
+	}
+	if(argc > 7){
+		desc.scan = atof(argv[7]);
+	}
+	threads = argc > 9 ? atoi(argv[9]) : 1;
+	if(threads < 1 || threads > MAX_THREADS){
+		printf("Error: `threads` must be from 1 to %d\n", MAX_THREADS);
+		return -1;
+	}
+	gen = isu_mem_gen_create(&desc);
+	if(gen == NULL){
+		return -1;
+	}
+	addrs = malloc(CHUNK * sizeof(uint64_t));
+	if(addrs == NULL){
+		perror("Malloc encountered an error");
+		isu_mem_gen_destroy(gen);
+		return -1;
+	}
+	out = fopen(argv[3], "wb");
+	if(out == NULL){
+		perror("Could not open the binary trace");
+		isu_mem_gen_destroy(gen);
+		free(addrs);
+		return -1;
+	}
+
+	max_addr = isu_mem_gen_footprint(&desc) * desc.page_size - 1;
+	addr_bytes = max_addr <= 0xFFFF ? 2 : max_addr <= 0xFFFFFFFFULL ? 4 : 8;
+	ret = isu_mem_trace_write_header(out, addr_bytes, 0, count);
+
+	for(i = 0; ret == 0 && i < count; i += n){
+		n = count - i < CHUNK ? (size_t)(count - i) : CHUNK;
+		/// whole blocks to each thread, so none replays part of a block
+		per = (n / threads + ISU_MEM_GEN_BLOCK - 1) / ISU_MEM_GEN_BLOCK * ISU_MEM_GEN_BLOCK;
+		for(t = 0; t < threads; t++){
+			slices[t].gen = gen;
+			slices[t].first = i + (uint64_t)t * per;
+			slices[t].addrs = addrs + (size_t)t * per;
+			slices[t].n = (size_t)t * per >= n ? 0 : n - (size_t)t * per < per ? n - (size_t)t * per : per;
+			if(t > 0 && pthread_create(&tids[t], NULL, gen_slice, &slices[t]) != 0){
+				/// generated here instead
+				gen_slice(&slices[t]);
+				slices[t].gen = NULL;
+			}
+		}
+		gen_slice(&slices[0]);
+		for(t = 1; t < threads; t++){
+			if(slices[t].gen != NULL){
+				pthread_join(tids[t], NULL);
+			}
+		}
+		for(j = 0; ret == 0 && j < n; j++){
+			ret = isu_mem_trace_write_addr(out, addr_bytes, addrs[j]);
+		}
+	}
+	isu_mem_gen_destroy(gen);
+	free(addrs);
+	if(fclose(out) != 0 || ret < 0){
+		perror("Could not write the binary trace");
+		return -1;
+	}
+	printf("wrote %llu %s requests of %d bits over %llu pages to %s\n", (unsigned long long)count, isu_mem_gen_name(kind),
+		8 * addr_bytes, (unsigned long long)isu_mem_gen_footprint(&desc), argv[3]);
+	return 0;
+}